@@ -2,14 +2,18 @@
 
 layout (location = 0) in vec3 position;
 
-#define MAX_N_INSTANCES 10
+// per-instance data in shader storage buffers (unlike uniform arrays, size not fixed in shader)
+layout (std430, binding = 0) readonly buffer Models {
+  mat4 models[]; // object coord -> world coord
+};
+
+layout (std430, binding = 2) readonly buffer Colors {
+  vec3 colors[];
+};
 
 // opengl tranformation matrices
-uniform mat4 models[MAX_N_INSTANCES]; // object coord -> world coord
 uniform mat4 view; // world coord  -> camera coord
 uniform mat4 projection; // camera coord -> ndc coord
-                         //
-uniform vec3 colors[MAX_N_INSTANCES];
 
 out vec3 color_vert;
 
@@ -1,7 +1,5 @@
 #version 460 core
 
-#define MAX_N_INSTANCES 10
-
 // different colors for each material & light components
 struct Material {
   vec3 ambiant;
@@ -3,7 +3,8 @@
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec3 normal;
 
-#define MAX_N_INSTANCES 10
+// lights stay a uniform array (one light per pillar)
+#define MAX_N_LIGHTS 10
 
 struct Light {
   vec3 position;
@@ -12,15 +13,20 @@ struct Light {
   vec3 specular;
 };
 
+// per-instance data in shader storage buffers (uniform arrays cannot have a dynamic size in glsl)
+layout (std430, binding = 0) readonly buffer Models {
+  mat4 models[]; // object coord -> world coord
+};
+
+layout (std430, binding = 1) readonly buffer NormalsMats {
+  mat4 normals_mats[];
+};
+
 // opengl tranformation matrices
-// array cannot have a dyamic size in glsl
-// works if a smaller-sized array (size < max) is passed from the cpu host
-uniform mat4 models[MAX_N_INSTANCES]; // object coord -> world coord
 uniform mat4 view; // world coord  -> camera coord
 uniform mat4 projection; // camera coord -> ndc coord
 
-uniform Light lights[MAX_N_INSTANCES];
-uniform mat4 normals_mats[MAX_N_INSTANCES];
+uniform Light lights[MAX_N_LIGHTS];
 
 out vec3 position_vert;
 out vec3 normal_vert;
@@ -4,11 +4,12 @@ layout (location = 0) in vec3 position;
 layout (location = 1) in vec3 normal;
 layout (location = 2) in vec2 texture_coord;
 
-// number of walls determined on runtime
-#define MAX_N_INSTANCES 256
+// number of walls determined on runtime (models in shader storage buffer)
+layout (std430, binding = 0) readonly buffer Models {
+  mat4 models[]; // object coord -> world coord
+};
 
 // opengl tranformation matrices
-uniform mat4 models[MAX_N_INSTANCES];      // object coord -> world coord
 uniform mat4 view;       // world coord  -> camera coord
 uniform mat4 projection; // camera coord -> ndc coord
 
@@ -18,5 +19,7 @@ void main() {
   mat4 model = models[gl_InstanceID];
   gl_Position = projection * view * model * vec4(position, 1.0);
 
-  texture_coord_vert = texture_coord;
+  // walls merged into runs are stretched along x-axis => texture repeated once per tile (except on faces at both ends)
+  float length_run = length(model[0].xyz);
+  texture_coord_vert = (abs(normal.x) < 0.5) ? vec2(texture_coord.x * length_run, texture_coord.y) : texture_coord;
 }
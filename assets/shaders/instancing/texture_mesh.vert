@@ -1,17 +1,28 @@
 #version 460 core
 
-layout (location = 0) in vec3 position;
-layout (location = 1) in vec3 normal;
+// quantized meshes: position normalized in mesh's bbox, octahedral normal & tangent in xy (see `VertexQuantized`)
+layout (location = 0) in vec3 position_in;
+layout (location = 1) in vec3 normal_in;
 layout (location = 2) in vec2 texture_coord;
-layout (location = 3) in vec3 tangent;
+layout (location = 3) in vec3 tangent_in;
 
-#define MAX_N_INSTANCES 10
+// per-instance data in shader storage buffers (unlike uniform arrays, size not fixed in shader)
+layout (std430, binding = 0) readonly buffer Models {
+  mat4 models[]; // object coord -> world coord
+};
+
+layout (std430, binding = 1) readonly buffer NormalsMats {
+  mat4 normals_mats[];
+};
 
 // opengl tranformation matrices
-uniform mat4 models[MAX_N_INSTANCES];      // object coord -> world coord
 uniform mat4 view;       // world coord  -> camera coord
 uniform mat4 projection; // camera coord -> ndc coord
-uniform mat4 normals_mats[MAX_N_INSTANCES];
+
+// mesh's bbox to decode quantized positions
+uniform bool is_quantized;
+uniform vec3 position_min;
+uniform vec3 position_extent;
 
 // interface block (name matches in frag shader)
 out VS_OUT {
@@ -21,7 +32,22 @@ out VS_OUT {
   mat3 tbn_mat;
 } vs_out;
 
+// inverse of `VertexQuantized::encode_octahedral()`
+vec3 decode_octahedral(vec2 encoded) {
+  vec3 direction = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+  if (direction.z < 0.0) {
+    vec2 sign_not_zero = vec2(direction.x >= 0.0 ? 1.0 : -1.0, direction.y >= 0.0 ? 1.0 : -1.0);
+    direction.xy = (1.0 - abs(direction.yx)) * sign_not_zero;
+  }
+
+  return normalize(direction);
+}
+
 void main() {
+  vec3 position = is_quantized ? position_min + position_in * position_extent : position_in;
+  vec3 normal = is_quantized ? decode_octahedral(normal_in.xy) : normal_in;
+  vec3 tangent = is_quantized ? decode_octahedral(tangent_in.xy) : tangent_in;
+
   mat4 model = models[gl_InstanceID];
   mat4 normal_mat = normals_mats[gl_InstanceID];
   gl_Position = projection * view * model * vec4(position, 1.0);
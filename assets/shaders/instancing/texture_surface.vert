@@ -4,10 +4,12 @@ layout (location = 0) in vec2 position;
 layout (location = 1) in vec3 normal;
 layout (location = 2) in vec2 texture_coord;
 
-#define MAX_N_INSTANCES 10
+// per-instance data in shader storage buffer (unlike uniform arrays, size not fixed in shader)
+layout (std430, binding = 0) readonly buffer Models {
+  mat4 models[]; // object coord -> world coord
+};
 
 // opengl tranformation matrices
-uniform mat4 models[MAX_N_INSTANCES];      // object coord -> world coord
 uniform mat4 view;       // world coord  -> camera coord
 uniform mat4 projection; // camera coord -> ndc coord
 
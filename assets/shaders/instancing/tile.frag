@@ -1,7 +1,8 @@
 // indexing sampler array using non-const expression only supported in GLSL460+
 #version 460 core
 
-#define MAX_N_INSTANCES 10
+// distinct textures shared by all instances (indexed by instance's `i_texture`)
+#define MAX_N_TEXTURES 4
 #define N_LIGHTS 3
 
 // interface block (name matches in vertex shader)
@@ -12,9 +13,9 @@ in VS_OUT {
   mat4 normal_mat_vert;
 } fs_in;
 
-flat in int i_instance; // flat to disable interpolation for ints
-uniform sampler2D textures_diffuse[MAX_N_INSTANCES];
-uniform sampler2D textures_normal[MAX_N_INSTANCES];
+flat in uint i_texture; // flat to disable interpolation for ints
+uniform sampler2D textures_diffuse[MAX_N_TEXTURES];
+uniform sampler2D textures_normal[MAX_N_TEXTURES];
 
 uniform vec3 positions_lights[N_LIGHTS];
 uniform vec3 position_camera;
@@ -26,11 +27,11 @@ vec3 calculateLightContribution(vec4 color, vec3 position_light, vec3 normal);
 
 /* modified from `assets/texture_surface.frag` */
 void main() {
-  vec4 color = texture(textures_diffuse[i_instance], fs_in.texture_coord_vert);
+  vec4 color = texture(textures_diffuse[i_texture], fs_in.texture_coord_vert);
 
   // normal-mapping based shading: convert image from [0, 1] to [-1, 1]
   // normal vector from texture image: https://learnopengl.com/Advanced-Lighting/Normal-Mapping
-  vec3 normal_vec = texture(textures_normal[i_instance], fs_in.texture_coord_vert).rgb;
+  vec3 normal_vec = texture(textures_normal[i_texture], fs_in.texture_coord_vert).rgb;
   normal_vec = normalize(normal_vec * 2.0 - 1.0);
 
   // special case of simple surface (with known transf. mat): TBN matrix = normal_mat = model
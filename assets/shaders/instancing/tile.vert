@@ -4,15 +4,24 @@ layout (location = 0) in vec2 position;
 layout (location = 1) in vec3 normal;
 layout (location = 2) in vec2 texture_coord;
 
-#define MAX_N_INSTANCES 10
+// per-instance data in shader storage buffers (unlike uniform arrays, size not fixed in shader)
+layout (std430, binding = 0) readonly buffer Models {
+  mat4 models[]; // object coord -> world coord
+};
+
+layout (std430, binding = 1) readonly buffer NormalsMats {
+  mat4 normals_mats[];
+};
+
+// index of instance's textures in samplers arrays (e.g. floor or ceiling)
+layout (std430, binding = 3) readonly buffer TexturesIndices {
+  uint textures_indices[];
+};
 
 // opengl tranformation matrices
-uniform mat4 models[MAX_N_INSTANCES];      // object coord -> world coord
 uniform mat4 view;       // world coord  -> camera coord
 uniform mat4 projection; // camera coord -> ndc coord
 
-uniform mat4 normals_mats[MAX_N_INSTANCES];
-
 // interface block (name matches in frag shader)
 out VS_OUT {
   vec2 texture_coord_vert;
@@ -23,7 +32,7 @@ out VS_OUT {
 
 // needed for indexing Sampler2D textures array for floor/ceiling
 // cannot pass Sampler2D to fragment shader (via out/in)
-out int i_instance;
+flat out uint i_texture;
 
 /* modified from `assets/texture_surface.vert` */
 void main() {
@@ -35,5 +44,5 @@ void main() {
   vs_out.normal_vert = normal;
   vs_out.normal_mat_vert = normals_mats[gl_InstanceID];
 
-  i_instance = gl_InstanceID;
+  i_texture = textures_indices[gl_InstanceID];
 }
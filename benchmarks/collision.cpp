@@ -0,0 +1,87 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "math/spatial_grid.hpp"
+
+using namespace std::chrono;
+
+/**
+ * Compare brute-force camera-vs-walls proximity (distance to every wall center)
+ * with spatial grid queries on square levels made of 1k, 10k & 100k wall tiles
+ */
+namespace {
+  /* Walls centers (same elevation as in LevelRenderer) along parallel corridors 4 tiles wide */
+  std::vector<glm::vec3> generate_walls(unsigned int n_tiles, float& size) {
+    std::vector<glm::vec3> positions(n_tiles);
+    unsigned int n_cols = std::ceil(2 * std::sqrt(n_tiles));
+
+    for (size_t i_tile = 0; i_tile < n_tiles; ++i_tile)
+      positions[i_tile] = glm::vec3(i_tile % n_cols + 0.5f, 1.75f, 4 * (i_tile / n_cols));
+
+    size = n_cols;
+    return positions;
+  }
+
+  /* Same as previous implementation of `CameraFPS::is_close_to_boundaries()` */
+  bool is_close_brute_force(const std::vector<glm::vec3>& positions, const glm::vec3& position, float distance) {
+    std::vector<float> distances;
+    for (const glm::vec3& position_wall : positions)
+      distances.push_back(glm::length(position - position_wall));
+
+    float min_distance = *std::min_element(distances.begin(), distances.end());
+    return min_distance < distance;
+  }
+
+  /* Average duration of given query function over all agents in microseconds */
+  template <typename Function>
+  double time_queries(Function is_close, const std::vector<glm::vec3>& agents, unsigned int n_iterations, size_t& n_close) {
+    steady_clock::time_point time_start = steady_clock::now();
+    for (size_t i_iteration = 0; i_iteration < n_iterations; ++i_iteration) {
+      n_close = 0;
+      for (const glm::vec3& agent : agents)
+        n_close += is_close(agent);
+    }
+    duration<double, std::micro> interval = steady_clock::now() - time_start;
+
+    return interval.count() / n_iterations;
+  }
+}
+
+int main() {
+  const float distance = 1.2f;
+  const unsigned int n_agents = 500;
+  std::mt19937 generator(0);
+
+  std::cout << "n_tiles | close agents | brute force (us) | grid (us) | speedup" << '\n';
+
+  for (unsigned int n_tiles : { 1000, 10000, 100000 }) {
+    float size;
+    std::vector<glm::vec3> positions = generate_walls(n_tiles, size);
+    math::SpatialGrid grid(positions, distance);
+
+    // agents at camera's elevation spread randomly over level
+    std::uniform_real_distribution<float> distribution(0.0f, size);
+    std::vector<glm::vec3> agents(n_agents);
+    for (glm::vec3& agent : agents)
+      agent = glm::vec3(distribution(generator), 2.0f, distribution(generator));
+
+    unsigned int n_iterations = std::max(1u, 1000000 / n_tiles);
+    size_t n_close_brute_force, n_close_grid;
+    double duration_brute_force = time_queries([&](const glm::vec3& agent) { return is_close_brute_force(positions, agent, distance); }, agents, n_iterations, n_close_brute_force);
+    double duration_grid = time_queries([&](const glm::vec3& agent) { return grid.is_close_to(agent, distance); }, agents, n_iterations * 100, n_close_grid);
+
+    std::cout << n_tiles << " | " << n_close_grid << " | " << duration_brute_force << " | "
+              << duration_grid << " | " << duration_brute_force / duration_grid << "x" << '\n';
+
+    if (n_close_brute_force != n_close_grid) {
+      std::cout << "Mismatch between brute force & grid close agents: " << n_close_brute_force << '\n';
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,77 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "math/bounding_box.hpp"
+#include "math/bvh.hpp"
+#include "navigation/camera.hpp"
+#include "navigation/frustum.hpp"
+
+using namespace std::chrono;
+
+/**
+ * Compare flat frustum culling (test every bbox) with BVH-based culling
+ * on square levels made of 1k, 10k & 100k wall tiles
+ */
+namespace {
+  /* Wall tiles of same size as in WallsRenderer, laid out on a grid with alternating orientations */
+  std::vector<BoundingBox> generate_walls(unsigned int n_tiles) {
+    std::vector<BoundingBox> bboxes(n_tiles);
+    unsigned int n_cols = std::ceil(std::sqrt(n_tiles));
+    glm::vec3 half_diagonal_h(0.5f, 1.75f, 0.1f);
+    glm::vec3 half_diagonal_v(0.1f, 1.75f, 0.5f);
+
+    for (size_t i_tile = 0; i_tile < n_tiles; ++i_tile) {
+      glm::vec3 center(i_tile % n_cols + 0.5f, 1.75f, i_tile / n_cols + 0.5f);
+      bboxes[i_tile] = BoundingBox(center, (i_tile % 2 == 0) ? half_diagonal_h : half_diagonal_v);
+    }
+
+    return bboxes;
+  }
+
+  /* Average duration of given culling function in microseconds */
+  template <typename Function>
+  double time_culling(Function cull, unsigned int n_iterations, size_t& n_visible) {
+    steady_clock::time_point time_start = steady_clock::now();
+    for (size_t i_iteration = 0; i_iteration < n_iterations; ++i_iteration)
+      n_visible = cull().size();
+    duration<double, std::micro> interval = steady_clock::now() - time_start;
+
+    return interval.count() / n_iterations;
+  }
+}
+
+int main() {
+  // same frustum as in main (camera at level's corner looking at its diagonal)
+  const float near = 0.001, far = 50.0, aspect_ratio = 16.0f / 9.0f;
+  Frustum frustum(near, far, aspect_ratio);
+  Camera camera(glm::vec3(2.0f, 2.0f, 2.0f), glm::normalize(glm::vec3(1.0f, 0.0f, 1.0f)), glm::vec3(0.0f, 1.0f, 0.0f));
+  frustum.calculate_planes(camera);
+
+  std::cout << "n_tiles | visible | flat (us) | bvh (us) | speedup" << '\n';
+
+  for (unsigned int n_tiles : { 1000, 10000, 100000 }) {
+    std::vector<BoundingBox> bboxes = generate_walls(n_tiles);
+    std::vector<glm::mat4> models(n_tiles, glm::mat4(1.0f));
+    math::BVH bvh(bboxes);
+
+    // enough iterations to run each path for ~10^7 tiles
+    unsigned int n_iterations = std::max(10u, 10000000 / n_tiles);
+    size_t n_visible_flat, n_visible_bvh;
+    double duration_flat = time_culling([&]() { return frustum.cull(models, bboxes); }, n_iterations, n_visible_flat);
+    double duration_bvh = time_culling([&]() { return frustum.cull(models, bvh); }, n_iterations, n_visible_bvh);
+
+    std::cout << n_tiles << " | " << n_visible_flat << " | " << duration_flat << " | "
+              << duration_bvh << " | " << duration_flat / duration_bvh << "x" << '\n';
+
+    if (n_visible_flat != n_visible_bvh) {
+      std::cout << "Mismatch between flat & bvh visible tiles: " << n_visible_bvh << '\n';
+      return 1;
+    }
+  }
+
+  return 0;
+}
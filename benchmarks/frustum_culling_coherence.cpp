@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "math/bounding_box.hpp"
+#include "math/bvh.hpp"
+#include "navigation/camera.hpp"
+#include "navigation/frustum.hpp"
+#include "navigation/frustum_cache.hpp"
+
+using namespace std::chrono;
+
+/**
+ * BVH frustum culling from scratch vs. with visibility kept between frames (see `FrustumCache`)
+ * on a level of 100k wall tiles, for an idle camera, a slow & a fast turn, & a camera walking forward
+ * Cached culls keep a few more tiles (within margin around frustum) & must include all tiles visible from scratch
+ */
+namespace {
+  const unsigned int N_TILES = 100000, N_FRAMES = 500;
+
+  /* Same wall tiles as in frustum_culling benchmark */
+  std::vector<BoundingBox> generate_walls(unsigned int n_tiles) {
+    std::vector<BoundingBox> bboxes(n_tiles);
+    unsigned int n_cols = std::ceil(std::sqrt(n_tiles));
+    glm::vec3 half_diagonal_h(0.5f, 1.75f, 0.1f);
+    glm::vec3 half_diagonal_v(0.1f, 1.75f, 0.5f);
+
+    for (size_t i_tile = 0; i_tile < n_tiles; ++i_tile) {
+      glm::vec3 center(i_tile % n_cols + 0.5f, 1.75f, i_tile / n_cols + 0.5f);
+      bboxes[i_tile] = BoundingBox(center, (i_tile % 2 == 0) ? half_diagonal_h : half_diagonal_v);
+    }
+
+    return bboxes;
+  }
+
+  /* Camera pose on given frame: turning around y-axis by `speed_turn` deg & moving forward by `speed_walk` per frame */
+  Camera get_camera(unsigned int i_frame, float speed_turn, float speed_walk) {
+    float angle = glm::radians(45.0f + speed_turn * i_frame);
+    glm::vec3 direction(std::cos(angle), 0.0f, std::sin(angle));
+    glm::vec3 position = glm::vec3(20.0f, 2.0f, 20.0f) + speed_walk * i_frame * glm::normalize(glm::vec3(1.0f, 0.0f, 1.0f));
+
+    return Camera(position, direction, glm::vec3(0.0f, 1.0f, 0.0f));
+  }
+}
+
+int main() {
+  const float near = 0.001, far = 50.0, aspect_ratio = 16.0f / 9.0f;
+  Frustum frustum(near, far, aspect_ratio);
+  std::vector<BoundingBox> bboxes = generate_walls(N_TILES);
+  math::BVH bvh(bboxes);
+
+  struct Motion {
+    const char* name;
+    float speed_turn;
+    float speed_walk;
+  };
+
+  std::cout << "motion | visible (scratch) | visible (cached) | scratch (us) | cached (us) | speedup | skipped | plane tests (scratch) | plane tests (cached) | early-outs" << '\n';
+
+  for (const Motion& motion : { Motion{ "idle", 0.0f, 0.0f }, Motion{ "slow turn", 0.1f, 0.0f }, Motion{ "fast turn", 5.0f, 0.0f }, Motion{ "walk", 0.0f, 0.05f } }) {
+    // frustum planes calculated beforehand, so only culling is timed
+    std::vector<Frustum> frustums(N_FRAMES, frustum);
+    for (size_t i_frame = 0; i_frame < N_FRAMES; ++i_frame)
+      frustums[i_frame].calculate_planes(get_camera(i_frame, motion.speed_turn, motion.speed_walk));
+
+    size_t n_visible = 0, n_visible_cached = 0;
+    steady_clock::time_point time_start = steady_clock::now();
+    for (const Frustum& frustum_frame : frustums)
+      n_visible += frustum_frame.cull(bvh).size();
+    duration<double, std::micro> duration_scratch = steady_clock::now() - time_start;
+
+    FrustumCache cache;
+    FrustumCache::Stats stats;
+    time_start = steady_clock::now();
+    for (const Frustum& frustum_frame : frustums) {
+      n_visible_cached += frustum_frame.cull(bvh, cache).size();
+      stats.n_skipped += cache.stats.n_skipped;
+      stats.n_tests += cache.stats.n_tests;
+      stats.n_early_outs += cache.stats.n_early_outs;
+    }
+    duration<double, std::micro> duration_cached = steady_clock::now() - time_start;
+
+    // plane tests from scratch (without last rejecting planes)
+    FrustumCache cache_scratch;
+    unsigned int n_tests_scratch = 0;
+    for (const Frustum& frustum_frame : frustums) {
+      cache_scratch.invalidate();
+      frustum_frame.cull(bvh, cache_scratch);
+      n_tests_scratch += cache_scratch.stats.n_tests;
+    }
+
+    std::cout << motion.name << " | " << n_visible / N_FRAMES << " | " << n_visible_cached / N_FRAMES << " | " << duration_scratch.count() / N_FRAMES << " | "
+              << duration_cached.count() / N_FRAMES << " | " << duration_scratch.count() / duration_cached.count() << "x | "
+              << stats.n_skipped << " | " << n_tests_scratch / N_FRAMES << " | " << stats.n_tests / N_FRAMES << " | "
+              << stats.n_early_outs / N_FRAMES << '\n';
+
+    // cached culling of last frame keeps all items visible from scratch
+    std::vector<unsigned int> indices_scratch = frustums.back().cull(bvh);
+    std::vector<unsigned int> indices_cached = cache.indices;
+    std::sort(indices_scratch.begin(), indices_scratch.end());
+    std::sort(indices_cached.begin(), indices_cached.end());
+    if (!std::includes(indices_cached.begin(), indices_cached.end(), indices_scratch.begin(), indices_scratch.end())) {
+      std::cout << "Visible tiles from scratch missing from cached ones" << '\n';
+      return 1;
+    }
+  }
+
+  return 0;
+}
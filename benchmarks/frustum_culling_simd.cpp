@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "math/bounding_box.hpp"
+#include "math/bounding_boxes_soa.hpp"
+#include "math/bvh.hpp"
+#include "navigation/camera.hpp"
+#include "navigation/frustum.hpp"
+
+using namespace std::chrono;
+
+/**
+ * Throughput (in ms per million bboxes) of scalar frustum culling on AoS bboxes
+ * vs. SSE2 & AVX2 kernels on SoA bboxes, and check that they give the same visible set
+ * BVH culling (used by level renderers, without reuse between frames here) given as reference for static bboxes
+ */
+namespace {
+  /* Bboxes of random sizes scattered around camera (fixed seed for reproducibility) */
+  std::vector<BoundingBox> generate_bboxes(unsigned int n_bboxes) {
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> distribution_position(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> distribution_size(0.1f, 2.0f);
+    std::vector<BoundingBox> bboxes(n_bboxes);
+
+    for (BoundingBox& bbox : bboxes) {
+      glm::vec3 center(distribution_position(generator), distribution_position(generator) / 10.0f, distribution_position(generator));
+      glm::vec3 half_diagonal(distribution_size(generator), distribution_size(generator), distribution_size(generator));
+      bbox = BoundingBox(center, half_diagonal);
+    }
+
+    return bboxes;
+  }
+
+  /* Average duration of given culling function in ms per million bboxes */
+  template <typename Function>
+  double time_culling(Function cull, unsigned int n_bboxes, unsigned int n_iterations) {
+    steady_clock::time_point time_start = steady_clock::now();
+    for (size_t i_iteration = 0; i_iteration < n_iterations; ++i_iteration)
+      cull();
+    duration<double, std::milli> interval = steady_clock::now() - time_start;
+
+    return interval.count() / n_iterations * (1e6 / n_bboxes);
+  }
+}
+
+int main() {
+  const unsigned int N_BBOXES = 1000000, N_ITERATIONS = 50;
+  const float near = 0.001, far = 50.0, aspect_ratio = 16.0f / 9.0f;
+  Frustum frustum(near, far, aspect_ratio);
+  Camera camera(glm::vec3(0.0f, 2.0f, 0.0f), glm::normalize(glm::vec3(1.0f, 0.0f, 1.0f)), glm::vec3(0.0f, 1.0f, 0.0f));
+  frustum.calculate_planes(camera);
+
+  std::vector<BoundingBox> bboxes = generate_bboxes(N_BBOXES);
+  BoundingBoxesSoA bboxes_soa(bboxes);
+  std::vector<unsigned int> indices_scalar, indices_sse2, indices_avx2;
+  indices_scalar.reserve(N_BBOXES);
+
+  // scalar reference: `Frustum::is_inside()` on each AoS bbox
+  auto cull_scalar = [&]() {
+    indices_scalar.clear();
+    for (size_t i_bbox = 0; i_bbox < bboxes.size(); ++i_bbox) {
+      if (frustum.is_inside(bboxes[i_bbox]))
+        indices_scalar.push_back(i_bbox);
+    }
+  };
+  auto cull_sse2 = [&]() { frustum.cull_sse2(bboxes_soa, indices_sse2); };
+  auto cull_avx2 = [&]() { frustum.cull_avx2(bboxes_soa, indices_avx2); };
+
+  math::BVH bvh(bboxes);
+  std::vector<unsigned int> indices_bvh;
+  auto cull_bvh = [&]() { indices_bvh = frustum.cull(bvh); };
+
+  std::cout << "path | ms per 1M bboxes | visible" << '\n';
+  std::cout << "scalar (AoS) | " << time_culling(cull_scalar, N_BBOXES, N_ITERATIONS) << " | " << indices_scalar.size() << '\n';
+  std::cout << "sse2 (SoA) | " << time_culling(cull_sse2, N_BBOXES, N_ITERATIONS) << " | " << indices_sse2.size() << '\n';
+
+  if (Frustum::has_avx2())
+    std::cout << "avx2 (SoA) | " << time_culling(cull_avx2, N_BBOXES, N_ITERATIONS) << " | " << indices_avx2.size() << '\n';
+  else
+    std::cout << "avx2 not supported by cpu" << '\n';
+
+  std::cout << "bvh (AoS) | " << time_culling(cull_bvh, N_BBOXES, N_ITERATIONS) << " | " << indices_bvh.size() << '\n';
+
+  // all paths output indices in increasing order, except BVH (tree order)
+  std::sort(indices_bvh.begin(), indices_bvh.end());
+  if (indices_sse2 != indices_scalar || (Frustum::has_avx2() && indices_avx2 != indices_scalar) || indices_bvh != indices_scalar) {
+    std::cout << "Mismatch between scalar & SIMD visible sets" << '\n';
+    return 1;
+  }
+
+  return 0;
+}
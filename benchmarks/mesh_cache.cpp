@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include "models/mesh.hpp"
+#include "models/mesh_cache.hpp"
+
+using namespace std::chrono;
+namespace fs = std::filesystem;
+
+/**
+ * Compare parsing of 3d models with Assimp (same flags as `Model`) with loading their meshes from cache
+ * Textures excluded (loaded in both cases, and need an OpenGL context)
+ * Models copied to a temporary directory, so the caches used by the game aren't overwritten
+ */
+namespace {
+  /* Same meshes extraction as `Model::parse_scene()` */
+  std::vector<assimp_utils::Mesh> parse(const std::string& path) {
+    Assimp::Importer importer;
+    const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_CalcTangentSpace);
+    std::vector<assimp_utils::Mesh> meshes;
+    if (scene == NULL)
+      return meshes;
+
+    for (size_t i_mesh = 0; i_mesh < scene->mNumMeshes; ++i_mesh)
+      meshes.push_back(assimp_utils::Mesh(scene->mMeshes[i_mesh]));
+
+    return meshes;
+  }
+
+  /* Average duration of given loading function in milliseconds */
+  template <typename Function>
+  double time_loading(Function load, unsigned int n_iterations) {
+    steady_clock::time_point time_start = steady_clock::now();
+    for (size_t i_iteration = 0; i_iteration < n_iterations; ++i_iteration)
+      load();
+    duration<double, std::milli> interval = steady_clock::now() - time_start;
+
+    return interval.count() / n_iterations;
+  }
+}
+
+int main() {
+  const unsigned int n_iterations = 20;
+  fs::path directory = fs::temp_directory_path() / "benchmark_mesh_cache";
+  fs::create_directories(directory);
+
+  std::cout << "model | vertexes | assimp (ms) | cache (ms) | speedup" << '\n';
+
+  for (const std::string name : { "samurai", "sniper", "suzanne", "tree" }) {
+    // copy model with its material library next to it
+    for (const std::string extension : { ".obj", ".mtl" }) {
+      fs::path path_source = "assets/models/" + name + "/" + name + extension;
+      if (fs::exists(path_source))
+        fs::copy_file(path_source, directory / (name + extension), fs::copy_options::overwrite_existing);
+    }
+
+    std::string path = (directory / (name + ".obj")).string();
+    std::vector<assimp_utils::Mesh> meshes_assimp = parse(path);
+    if (meshes_assimp.empty() || !assimp_utils::MeshCache::save(path, meshes_assimp)) {
+      std::cout << "Failed to parse or cache " << path << '\n';
+      return 1;
+    }
+
+    std::vector<assimp_utils::Mesh> meshes_cache;
+    double duration_assimp = time_loading([&]() { meshes_assimp = parse(path); }, n_iterations);
+    double duration_cache = time_loading([&]() { assimp_utils::MeshCache::load(path, meshes_cache, false); }, n_iterations);
+
+    // stride of vertexes depends on attributes present & quantization, but all are used by triangles since `optimize()`
+    size_t n_vertexes = 0;
+    for (const assimp_utils::Mesh& mesh : meshes_cache)
+      if (!mesh.indices.empty())
+        n_vertexes += *std::max_element(mesh.indices.begin(), mesh.indices.end()) + 1;
+
+    std::cout << name << " | " << n_vertexes << " | " << duration_assimp << " | "
+              << duration_cache << " | " << duration_assimp / duration_cache << "x" << '\n';
+
+    if (meshes_cache.size() != meshes_assimp.size() || meshes_cache[0].vertexes != meshes_assimp[0].vertexes) {
+      std::cout << "Mismatch between meshes parsed by assimp & loaded from cache" << '\n';
+      return 1;
+    }
+  }
+
+  fs::remove_all(directory);
+
+  return 0;
+}
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include "models/mesh_optimizer.hpp"
+
+using namespace std::chrono;
+using namespace assimp_utils;
+
+/**
+ * ACMR & # of vertexes of spheres imported like Assimp does for .obj files
+ * (one vertex per face corner & triangles in arbitrary order) before & after optimization
+ */
+namespace {
+  /* Sphere's triangles shuffled with 11 floats per corner (position, normal, uv, tangent) */
+  void generate_sphere(unsigned int n_segments, std::vector<float>& vertexes, std::vector<unsigned int>& indices, std::vector<glm::vec3>& positions) {
+    const float pi = glm::pi<float>();
+    auto get_position = [&](unsigned int i_ring, unsigned int i_segment) {
+      float theta = pi * i_ring / n_segments, phi = 2.0f * pi * (i_segment % n_segments) / n_segments;
+      return glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+    };
+
+    std::vector<std::array<glm::uvec2, 3>> triangles;
+    for (unsigned int i_ring = 0; i_ring < n_segments; ++i_ring) {
+      for (unsigned int i_segment = 0; i_segment < n_segments; ++i_segment) {
+        triangles.push_back({ glm::uvec2(i_ring, i_segment), glm::uvec2(i_ring + 1, i_segment), glm::uvec2(i_ring + 1, i_segment + 1) });
+        triangles.push_back({ glm::uvec2(i_ring, i_segment), glm::uvec2(i_ring + 1, i_segment + 1), glm::uvec2(i_ring, i_segment + 1) });
+      }
+    }
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937(0));
+
+    for (const auto& triangle : triangles) {
+      for (const glm::uvec2& corner : triangle) {
+        glm::vec3 position = get_position(corner.x, corner.y);
+        glm::vec2 uv((float) (corner.y % n_segments) / n_segments, (float) corner.x / n_segments);
+        glm::vec3 tangent(-std::sin(2.0f * pi * uv.x), 0.0f, std::cos(2.0f * pi * uv.x));
+
+        indices.push_back(positions.size());
+        positions.push_back(position);
+        vertexes.insert(vertexes.end(), { position.x, position.y, position.z, position.x, position.y, position.z,
+                                          uv.x, uv.y, tangent.x, tangent.y, tangent.z });
+      }
+    }
+  }
+
+  /* Triangles positions sorted (to check optimization keeps same triangles) */
+  std::vector<float> get_triangles(const std::vector<unsigned int>& indices, const std::vector<glm::vec3>& positions) {
+    std::vector<std::array<float, 9>> triangles(indices.size() / 3);
+    for (size_t i_triangle = 0; i_triangle < triangles.size(); ++i_triangle) {
+      for (size_t i_corner = 0; i_corner < 3; ++i_corner) {
+        glm::vec3 position = positions[indices[3*i_triangle + i_corner]];
+        triangles[i_triangle][3*i_corner] = position.x;
+        triangles[i_triangle][3*i_corner + 1] = position.y;
+        triangles[i_triangle][3*i_corner + 2] = position.z;
+      }
+    }
+    std::sort(triangles.begin(), triangles.end());
+
+    std::vector<float> coords;
+    for (const auto& triangle : triangles)
+      coords.insert(coords.end(), triangle.begin(), triangle.end());
+
+    return coords;
+  }
+}
+
+int main() {
+  std::cout << "n_triangles | vertexes before | vertexes after | ACMR before | ACMR after | duration (ms)" << '\n';
+
+  for (unsigned int n_segments : { 16, 64, 256 }) {
+    std::vector<float> vertexes;
+    std::vector<unsigned int> indices;
+    std::vector<glm::vec3> positions;
+    generate_sphere(n_segments, vertexes, indices, positions);
+    std::vector<float> triangles_before = get_triangles(indices, positions);
+
+    steady_clock::time_point time_start = steady_clock::now();
+    MeshOptimizer::Stats stats = MeshOptimizer::optimize(vertexes, indices, positions);
+    duration<double, std::milli> interval = steady_clock::now() - time_start;
+
+    std::cout << indices.size() / 3 << " | " << stats.n_vertexes_before << " | " << stats.n_vertexes_after << " | "
+              << stats.acmr_before << " | " << stats.acmr_after << " | " << interval.count() << '\n';
+
+    if (get_triangles(indices, positions) != triangles_before || vertexes.size() != 11 * positions.size()) {
+      std::cout << "Mismatch between triangles before & after optimization" << '\n';
+      return 1;
+    }
+  }
+
+  return 0;
+}
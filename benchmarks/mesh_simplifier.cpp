@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include "models/mesh_simplifier.hpp"
+
+using namespace std::chrono;
+using namespace assimp_utils;
+
+/**
+ * Triangles kept & geometric error of unit spheres simplified to the ratios of `LodRenderer`'s LODs
+ * Spheres have a uv seam (duplicated column of vertexes) like textured models, which simplification must preserve
+ */
+namespace {
+  /* Indexed sphere (vertexes shared between triangles), last column of vertexes duplicates the first one */
+  void generate_sphere(unsigned int n_segments, std::vector<unsigned int>& indices, std::vector<glm::vec3>& positions) {
+    const float pi = glm::pi<float>();
+    for (unsigned int i_ring = 0; i_ring <= n_segments; ++i_ring) {
+      for (unsigned int i_segment = 0; i_segment <= n_segments; ++i_segment) {
+        float theta = pi * i_ring / n_segments, phi = 2.0f * pi * (i_segment % n_segments) / n_segments;
+        positions.push_back(glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+      }
+    }
+
+    for (unsigned int i_ring = 0; i_ring < n_segments; ++i_ring) {
+      for (unsigned int i_segment = 0; i_segment < n_segments; ++i_segment) {
+        unsigned int i0 = i_ring * (n_segments + 1) + i_segment, i1 = i0 + n_segments + 1;
+        if (i_ring > 0)
+          indices.insert(indices.end(), { i0, i1, i1 + 1 });
+        if (i_ring + 1 < n_segments)
+          indices.insert(indices.end(), { i0, i1 + 1, i0 + 1 });
+      }
+    }
+  }
+
+  /* Max. distance from unit sphere of simplified triangles' centroids (approximates geometric error) */
+  float get_error(const std::vector<unsigned int>& indices, const std::vector<glm::vec3>& positions) {
+    float error = 0.0f;
+    for (size_t i_index = 0; i_index < indices.size(); i_index += 3) {
+      glm::vec3 centroid = (positions[indices[i_index]] + positions[indices[i_index + 1]] + positions[indices[i_index + 2]]) / 3.0f;
+      error = std::max(error, 1.0f - glm::length(centroid));
+    }
+
+    return error;
+  }
+}
+
+int main() {
+  std::cout << "n_triangles | ratio | triangles kept | max error | duration (ms)" << '\n';
+
+  for (unsigned int n_segments : { 32, 128, 256 }) {
+    std::vector<unsigned int> indices;
+    std::vector<glm::vec3> positions;
+    generate_sphere(n_segments, indices, positions);
+
+    for (float ratio : { 0.5f, 0.25f, 0.1f }) {
+      unsigned int n_indices_target = 3 * static_cast<unsigned int>(ratio * indices.size() / 3);
+
+      steady_clock::time_point time_start = steady_clock::now();
+      std::vector<unsigned int> indices_lod = MeshSimplifier::simplify(indices, positions, n_indices_target);
+      duration<double, std::milli> interval = steady_clock::now() - time_start;
+
+      std::cout << indices.size() / 3 << " | " << ratio << " | " << indices_lod.size() / 3 << " | "
+                << get_error(indices_lod, positions) << " | " << interval.count() << '\n';
+
+      if (indices_lod.empty() || indices_lod.size() > indices.size()) {
+        std::cout << "Simplification removed all triangles or added some" << '\n';
+        return 1;
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,166 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "levels/level_generator.hpp"
+#include "levels/tilemap.hpp"
+#include "levels/walls_merger.hpp"
+#include "navigation/camera.hpp"
+#include "navigation/frustum.hpp"
+#include "navigation/occlusion_buffer.hpp"
+
+using namespace std::chrono;
+
+/**
+ * Instances inside frustum vs. not hidden by occlusion buffer (rasterized from merged walls inside frustum),
+ * seen from random free tiles on game's level & on generated levels
+ * Depth buffer of last view on game's level saved to `occlusion.pgm`
+ */
+namespace {
+  const float NEAR = 0.001f, FAR = 50.0f, ASPECT_RATIO = 16.0f / 9.0f;
+  const float LENGTH = 1.0f, HEIGHT = 3.5f, DEPTH = 0.2f;
+  const unsigned int N_VIEWS = 200;
+
+  /* Unit wall box at given center rotated by `angle` in deg (same as `WallsRenderer::calculate_uniforms_full()`) */
+  glm::mat4 get_model(const glm::vec3& center, float angle) {
+    return glm::rotate(glm::translate(glm::mat4(1.0f), center), glm::radians(angle), glm::vec3(0.0f, 1.0f, 0.0f));
+  }
+
+  /* Bboxes of merged walls runs (occluders) */
+  std::vector<BoundingBox> get_bboxes_walls(const Tilemap& tilemap) {
+    std::vector<glm::mat4> models;
+    glm::vec3 offset_h(LENGTH / 2, HEIGHT / 2, DEPTH / 2);
+    glm::vec3 offset_v(DEPTH / 2, HEIGHT / 2, -LENGTH / 2);
+    glm::vec3 offset_v_gamma(DEPTH / 2, HEIGHT / 2, LENGTH / 2);
+
+    for (size_t i_row = 0; i_row < tilemap.n_rows; ++i_row) {
+      std::string_view row = tilemap.get_row(i_row);
+      for (size_t i_col = 0; i_col < row.size(); ++i_col) {
+        glm::vec3 position(i_col, 0, i_row);
+        switch ((Tilemap::Tiles) row[i_col]) {
+          case Tilemap::Tiles::WALL_H: models.push_back(get_model(position + offset_h, 0)); break;
+          case Tilemap::Tiles::WALL_V: models.push_back(get_model(position + offset_v, 90)); break;
+          case Tilemap::Tiles::WALL_L: models.insert(models.end(), { get_model(position + offset_v, 90), get_model(position + offset_h, 0) }); break;
+          case Tilemap::Tiles::WALL_GAMMA: models.insert(models.end(), { get_model(position + offset_h, 0), get_model(position + offset_v_gamma, 90) }); break;
+          default: break;
+        }
+      }
+    }
+
+    std::vector<BoundingBox> bboxes;
+    for (const glm::mat4& model : WallsMerger::merge(models, LENGTH)) {
+      BoundingBox bbox(glm::vec3(0.0f), glm::vec3(LENGTH, HEIGHT, DEPTH) / 2.0f);
+      bbox.transform(model);
+      bboxes.push_back(bbox);
+    }
+
+    return bboxes;
+  }
+
+  /* Bboxes of doors, windows & trees, & of a small box on each free tile (e.g. targets) */
+  std::vector<BoundingBox> get_bboxes_props(const Tilemap& tilemap) {
+    std::vector<BoundingBox> bboxes;
+
+    for (size_t i_row = 0; i_row < tilemap.n_rows; ++i_row) {
+      std::string_view row = tilemap.get_row(i_row);
+      for (size_t i_col = 0; i_col < row.size(); ++i_col) {
+        switch ((Tilemap::Tiles) row[i_col]) {
+          case Tilemap::Tiles::DOOR_H: bboxes.push_back(BoundingBox(glm::vec3(i_col + 0.5f, 1.75f, i_row), glm::vec3(0.5f, 1.75f, 0.0f))); break;
+          case Tilemap::Tiles::WINDOW: bboxes.push_back(BoundingBox(glm::vec3(i_col + 0.5f, 1.75f, i_row), glm::vec3(0.5f, 0.5f, 0.0f))); break;
+          case Tilemap::Tiles::TREE: bboxes.push_back(BoundingBox(glm::vec3(i_col, 1.5f, i_row), glm::vec3(0.5f, 1.5f, 0.5f))); break;
+          case Tilemap::Tiles::SPACE: bboxes.push_back(BoundingBox(glm::vec3(i_col + 0.5f, 1.0f, i_row + 0.5f), glm::vec3(0.25f, 1.0f, 0.25f))); break;
+          default: break;
+        }
+      }
+    }
+
+    return bboxes;
+  }
+
+  void print_occlusion(const std::string& name, const std::string& path, const std::string& path_dump="") {
+    Tilemap tilemap(path);
+    std::vector<BoundingBox> bboxes_walls = get_bboxes_walls(tilemap);
+    std::vector<BoundingBox> bboxes_props = get_bboxes_props(tilemap);
+    OcclusionBuffer occlusion;
+
+    // cameras on random empty tiles at eyes height
+    std::mt19937 random(0);
+    size_t n_visible_frustum = 0, n_visible_occlusion = 0, n_occluders = 0;
+    duration<double, std::micro> interval_rasterize(0), interval_test(0);
+
+    for (size_t i_view = 0; i_view < N_VIEWS; ++i_view) {
+      unsigned int i_row, i_col;
+      do {
+        i_row = random() % tilemap.n_rows;
+        i_col = random() % tilemap.n_cols;
+      } while (tilemap.get_tile(i_row, i_col) != Tilemap::Tiles::SPACE);
+
+      float angle = (random() % 360) * 3.14159265f / 180.0f;
+      Camera camera(glm::vec3(i_col + 0.5f, 2.0f, i_row + 0.5f), glm::vec3(std::cos(angle), 0.0f, std::sin(angle)), glm::vec3(0.0f, 1.0f, 0.0f));
+      Frustum frustum(NEAR, FAR, ASPECT_RATIO);
+      frustum.calculate_planes(camera);
+      glm::mat4 projection = glm::perspective(glm::radians(camera.fov), ASPECT_RATIO, NEAR, FAR);
+
+      std::vector<unsigned int> indices_walls, indices_props;
+      for (size_t i_bbox = 0; i_bbox < bboxes_walls.size(); ++i_bbox) {
+        if (frustum.intersect(bboxes_walls[i_bbox]) != Intersection::OUTSIDE)
+          indices_walls.push_back(i_bbox);
+      }
+      for (size_t i_bbox = 0; i_bbox < bboxes_props.size(); ++i_bbox) {
+        if (frustum.intersect(bboxes_props[i_bbox]) != Intersection::OUTSIDE)
+          indices_props.push_back(i_bbox);
+      }
+
+      steady_clock::time_point time_start = steady_clock::now();
+      occlusion.clear(camera.get_view(), projection);
+      for (unsigned int index : indices_walls)
+        occlusion.rasterize(bboxes_walls[index]);
+      interval_rasterize += steady_clock::now() - time_start;
+
+      time_start = steady_clock::now();
+      for (unsigned int index : indices_walls)
+        n_visible_occlusion += occlusion.is_visible(bboxes_walls[index]);
+      for (unsigned int index : indices_props)
+        n_visible_occlusion += occlusion.is_visible(bboxes_props[index]);
+      interval_test += steady_clock::now() - time_start;
+
+      n_visible_frustum += indices_walls.size() + indices_props.size();
+      n_occluders += occlusion.get_stats().n_occluders;
+    }
+
+    if (!path_dump.empty())
+      occlusion.save(path_dump);
+
+    std::cout << name << " | " << n_occluders / N_VIEWS << " | " << n_visible_frustum / N_VIEWS << " | " << n_visible_occlusion / N_VIEWS << " | "
+              << 100.0f * (n_visible_frustum - n_visible_occlusion) / n_visible_frustum << "% | "
+              << interval_rasterize.count() / N_VIEWS << " | " << interval_test.count() / N_VIEWS << '\n';
+  }
+}
+
+int main() {
+  std::cout << "level | occluders | instances in frustum | not occluded | occluded | rasterization (us) | tests (us)" << '\n';
+  print_occlusion("map.txt", "assets/levels/map.txt", "occlusion.pgm");
+
+  for (unsigned int n_tiles : { 10000, 100000 }) {
+    LevelGenerator::Parameters parameters;
+    parameters.n_rows = parameters.n_cols = std::ceil(std::sqrt((double) n_tiles));
+    parameters.n_rooms = n_tiles / 256;
+    parameters.density_props = 0.1f;
+    LevelGenerator generator(parameters);
+
+    const std::string path = "assets/levels/generated.txt";
+    if (!generator.save(path)) {
+      std::cout << "Failed to save " << path << '\n';
+      return 1;
+    }
+
+    print_occlusion(std::to_string(n_tiles) + " tiles", path);
+  }
+
+  return 0;
+}
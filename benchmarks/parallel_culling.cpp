@@ -0,0 +1,192 @@
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "levels/level_generator.hpp"
+#include "levels/pvs.hpp"
+#include "levels/portals.hpp"
+#include "levels/tilemap.hpp"
+#include "levels/visibility.hpp"
+#include "levels/walls_merger.hpp"
+#include "math/bvh.hpp"
+#include "navigation/camera.hpp"
+#include "navigation/frustum.hpp"
+#include "navigation/occlusion_buffer.hpp"
+#include "utils/job_system.hpp"
+
+using namespace std::chrono;
+
+/**
+ * Culling of props renderers (frustum culling of their BVH then occlusion) one after the other vs. as jobs on all threads,
+ * from random free tiles on game's level & on generated levels (walls rasterized beforehand like in `LevelRenderer`)
+ * Instances kept on all threads must be the same as on the calling thread alone
+ */
+namespace {
+  const float NEAR = 0.001f, FAR = 50.0f, ASPECT_RATIO = 16.0f / 9.0f;
+  const float LENGTH = 1.0f, HEIGHT = 3.5f, DEPTH = 0.2f;
+  const unsigned int N_VIEWS = 200;
+
+  /* Unit wall box at given center rotated by `angle` in deg (same as `WallsRenderer::calculate_uniforms_full()`) */
+  glm::mat4 get_model(const glm::vec3& center, float angle) {
+    return glm::rotate(glm::translate(glm::mat4(1.0f), center), glm::radians(angle), glm::vec3(0.0f, 1.0f, 0.0f));
+  }
+
+  /* Bboxes of merged walls runs (occluders) */
+  std::vector<BoundingBox> get_bboxes_walls(const Tilemap& tilemap) {
+    std::vector<glm::mat4> models;
+    glm::vec3 offset_h(LENGTH / 2, HEIGHT / 2, DEPTH / 2);
+    glm::vec3 offset_v(DEPTH / 2, HEIGHT / 2, -LENGTH / 2);
+    glm::vec3 offset_v_gamma(DEPTH / 2, HEIGHT / 2, LENGTH / 2);
+
+    for (size_t i_row = 0; i_row < tilemap.n_rows; ++i_row) {
+      std::string_view row = tilemap.get_row(i_row);
+      for (size_t i_col = 0; i_col < row.size(); ++i_col) {
+        glm::vec3 position(i_col, 0, i_row);
+        switch ((Tilemap::Tiles) row[i_col]) {
+          case Tilemap::Tiles::WALL_H: models.push_back(get_model(position + offset_h, 0)); break;
+          case Tilemap::Tiles::WALL_V: models.push_back(get_model(position + offset_v, 90)); break;
+          case Tilemap::Tiles::WALL_L: models.insert(models.end(), { get_model(position + offset_v, 90), get_model(position + offset_h, 0) }); break;
+          case Tilemap::Tiles::WALL_GAMMA: models.insert(models.end(), { get_model(position + offset_h, 0), get_model(position + offset_v_gamma, 90) }); break;
+          default: break;
+        }
+      }
+    }
+
+    std::vector<BoundingBox> bboxes;
+    for (const glm::mat4& model : WallsMerger::merge(models, LENGTH)) {
+      BoundingBox bbox(glm::vec3(0.0f), glm::vec3(LENGTH, HEIGHT, DEPTH) / 2.0f);
+      bbox.transform(model);
+      bboxes.push_back(bbox);
+    }
+
+    return bboxes;
+  }
+
+  /* Bboxes of each props renderer: doors, windows, trees & a small box on each free tile (targets) */
+  std::array<std::vector<BoundingBox>, 4> get_bboxes_props(const Tilemap& tilemap) {
+    std::array<std::vector<BoundingBox>, 4> bboxes;
+
+    for (size_t i_row = 0; i_row < tilemap.n_rows; ++i_row) {
+      std::string_view row = tilemap.get_row(i_row);
+      for (size_t i_col = 0; i_col < row.size(); ++i_col) {
+        switch ((Tilemap::Tiles) row[i_col]) {
+          case Tilemap::Tiles::DOOR_H: bboxes[0].push_back(BoundingBox(glm::vec3(i_col + 0.5f, 1.75f, i_row), glm::vec3(0.5f, 1.75f, 0.0f))); break;
+          case Tilemap::Tiles::WINDOW: bboxes[1].push_back(BoundingBox(glm::vec3(i_col + 0.5f, 1.75f, i_row), glm::vec3(0.5f, 0.5f, 0.0f))); break;
+          case Tilemap::Tiles::TREE: bboxes[2].push_back(BoundingBox(glm::vec3(i_col, 1.5f, i_row), glm::vec3(0.5f, 1.5f, 0.5f))); break;
+          case Tilemap::Tiles::SPACE: bboxes[3].push_back(BoundingBox(glm::vec3(i_col + 0.5f, 1.0f, i_row + 0.5f), glm::vec3(0.25f, 1.0f, 0.25f))); break;
+          default: break;
+        }
+      }
+    }
+
+    return bboxes;
+  }
+
+  /* Instances kept by each props renderer on every view, & time spent culling them (walls rasterization excluded) */
+  std::vector<unsigned int> cull(const Tilemap& tilemap, JobSystem& jobs, duration<double, std::micro>& interval) {
+    std::vector<BoundingBox> bboxes_walls = get_bboxes_walls(tilemap);
+    math::BVH bvh_walls(bboxes_walls);
+    std::array<std::vector<BoundingBox>, 4> bboxes_props = get_bboxes_props(tilemap);
+    std::vector<math::BVH> bvhs_props;
+    for (const std::vector<BoundingBox>& bboxes : bboxes_props)
+      bvhs_props.push_back(math::BVH(bboxes));
+
+    // default PVS & portals are inactive (everything visible), so culling stages are frustum & occlusion
+    Pvs pvs;
+    Portals portals;
+    OcclusionBuffer occlusion;
+    Visibility visibility{ pvs, portals, occlusion };
+    std::array<std::vector<unsigned int>, 4> indices_props;
+    std::vector<unsigned int> indices_kept;
+
+    std::mt19937 random(0);
+    for (size_t i_view = 0; i_view < N_VIEWS; ++i_view) {
+      unsigned int i_row, i_col;
+      do {
+        i_row = random() % tilemap.n_rows;
+        i_col = random() % tilemap.n_cols;
+      } while (tilemap.get_tile(i_row, i_col) != Tilemap::Tiles::SPACE);
+
+      float angle = (random() % 360) * 3.14159265f / 180.0f;
+      Camera camera(glm::vec3(i_col + 0.5f, 2.0f, i_row + 0.5f), glm::vec3(std::cos(angle), 0.0f, std::sin(angle)), glm::vec3(0.0f, 1.0f, 0.0f));
+      Frustum frustum(NEAR, FAR, ASPECT_RATIO);
+      frustum.calculate_planes(camera);
+      glm::mat4 projection = glm::perspective(glm::radians(camera.fov), ASPECT_RATIO, NEAR, FAR);
+
+      occlusion.clear(camera.get_view(), projection);
+      for (unsigned int index : frustum.cull(bvh_walls))
+        occlusion.rasterize(bboxes_walls[index]);
+
+      steady_clock::time_point time_start = steady_clock::now();
+      std::array<std::function<void()>, 4> culls_props;
+      for (size_t i_props = 0; i_props < bboxes_props.size(); ++i_props) {
+        culls_props[i_props] = [&, i_props]() {
+          visibility.cull(frustum.cull(bvhs_props[i_props]), bboxes_props[i_props], indices_props[i_props], jobs);
+        };
+      }
+
+      JobSystem::Counter counter(0);
+      for (std::function<void()>& cull_props : culls_props)
+        jobs.run(cull_props, counter);
+      jobs.wait(counter);
+      interval += steady_clock::now() - time_start;
+
+      for (const std::vector<unsigned int>& indices : indices_props)
+        indices_kept.insert(indices_kept.end(), indices.begin(), indices.end());
+    }
+
+    return indices_kept;
+  }
+
+  bool print_culling(const std::string& name, const std::string& path) {
+    Tilemap tilemap(path);
+    JobSystem jobs_serial(0), jobs_parallel;
+
+    duration<double, std::micro> interval_serial(0), interval_parallel(0);
+    std::vector<unsigned int> indices_serial = cull(tilemap, jobs_serial, interval_serial);
+    std::vector<unsigned int> indices_parallel = cull(tilemap, jobs_parallel, interval_parallel);
+
+    std::cout << name << " | " << indices_serial.size() / N_VIEWS << " | " << jobs_parallel.get_n_threads() + 1 << " | "
+              << interval_serial.count() / N_VIEWS << " | " << interval_parallel.count() / N_VIEWS << " | "
+              << interval_serial / interval_parallel << '\n';
+
+    if (indices_parallel != indices_serial) {
+      std::cout << "Instances culled on all threads differ from the ones culled on the calling thread" << '\n';
+      return false;
+    }
+
+    return true;
+  }
+}
+
+int main() {
+  std::cout << "level | instances kept | threads | 1 thread (us) | all threads (us) | speedup" << '\n';
+  if (!print_culling("map.txt", "assets/levels/map.txt"))
+    return 1;
+
+  for (unsigned int n_tiles : { 10000, 100000 }) {
+    LevelGenerator::Parameters parameters;
+    parameters.n_rows = parameters.n_cols = std::ceil(std::sqrt((double) n_tiles));
+    parameters.n_rooms = n_tiles / 256;
+    parameters.density_props = 0.1f;
+    LevelGenerator generator(parameters);
+
+    const std::string path = "assets/levels/generated.txt";
+    if (!generator.save(path)) {
+      std::cout << "Failed to save " << path << '\n';
+      return 1;
+    }
+
+    if (!print_culling(std::to_string(n_tiles) + " tiles", path))
+      return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,124 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "levels/level_generator.hpp"
+#include "levels/portals.hpp"
+#include "navigation/camera.hpp"
+#include "navigation/frustum.hpp"
+
+using namespace std::chrono;
+
+/**
+ * Instances inside frustum vs. inside frustum narrowed through portals,
+ * seen from random free tiles looking in random directions on game's level & on generated multi-room levels
+ */
+namespace {
+  const float NEAR = 0.001f, FAR = 50.0f, ASPECT_RATIO = 16.0f / 9.0f;
+  const unsigned int N_VIEWS = 200;
+
+  /* Bboxes of walls, doors, windows & trees tiles (same sizes as level renderers) */
+  void get_bboxes(const Tilemap& tilemap, std::vector<BoundingBox>& bboxes, std::vector<BoundingBox>& bboxes_doors, std::vector<BoundingBox>& bboxes_windows) {
+    glm::vec3 half_diagonal_h(0.5f, 1.75f, 0.1f), half_diagonal_v(0.1f, 1.75f, 0.5f);
+
+    for (size_t i_row = 0; i_row < tilemap.n_rows; ++i_row) {
+      std::string_view row = tilemap.get_row(i_row);
+      for (size_t i_col = 0; i_col < row.size(); ++i_col) {
+        glm::vec3 center_h(i_col + 0.5f, 1.75f, i_row + 0.1f), center_v(i_col + 0.1f, 1.75f, i_row - 0.5f);
+        switch ((Tilemap::Tiles) row[i_col]) {
+          case Tilemap::Tiles::WALL_H: bboxes.push_back(BoundingBox(center_h, half_diagonal_h)); break;
+          case Tilemap::Tiles::WALL_V: bboxes.push_back(BoundingBox(center_v, half_diagonal_v)); break;
+          case Tilemap::Tiles::WALL_L: bboxes.insert(bboxes.end(), { BoundingBox(center_h, half_diagonal_h), BoundingBox(center_v, half_diagonal_v) }); break;
+          case Tilemap::Tiles::WALL_GAMMA: bboxes.insert(bboxes.end(), { BoundingBox(center_h, half_diagonal_h), BoundingBox(center_v + glm::vec3(0, 0, 1), half_diagonal_v) }); break;
+          case Tilemap::Tiles::DOOR_H: bboxes_doors.push_back(BoundingBox(glm::vec3(i_col + 0.5f, 1.75f, i_row), glm::vec3(0.5f, 1.75f, 0.0f))); break;
+          case Tilemap::Tiles::WINDOW: bboxes_windows.push_back(BoundingBox(glm::vec3(i_col + 0.5f, 1.75f, i_row), glm::vec3(0.5f, 0.5f, 0.0f))); break;
+          case Tilemap::Tiles::TREE: bboxes.push_back(BoundingBox(glm::vec3(i_col, 1.5f, i_row), glm::vec3(0.5f, 1.5f, 0.5f))); break;
+          default: break;
+        }
+      }
+    }
+
+    bboxes.insert(bboxes.end(), bboxes_doors.begin(), bboxes_doors.end());
+    bboxes.insert(bboxes.end(), bboxes_windows.begin(), bboxes_windows.end());
+  }
+
+  void print_portals(const std::string& name, const std::string& path) {
+    Tilemap tilemap(path);
+    std::vector<BoundingBox> bboxes, bboxes_doors, bboxes_windows;
+    get_bboxes(tilemap, bboxes, bboxes_doors, bboxes_windows);
+
+    steady_clock::time_point time_start = steady_clock::now();
+    Portals portals;
+    portals.build(tilemap, glm::ivec2(0, 0), glm::ivec2(tilemap.n_cols, tilemap.n_rows), glm::vec3(0.0f), bboxes_doors, bboxes_windows);
+    duration<double, std::milli> interval_build = steady_clock::now() - time_start;
+
+    // cameras on random empty tiles at eyes height
+    std::mt19937 random(0);
+    size_t n_visible_frustum = 0, n_visible_portals = 0, n_rooms_visible = 0;
+    duration<double, std::micro> interval_traverse(0), interval_cull(0);
+
+    for (size_t i_view = 0; i_view < N_VIEWS; ++i_view) {
+      unsigned int i_row, i_col;
+      do {
+        i_row = random() % tilemap.n_rows;
+        i_col = random() % tilemap.n_cols;
+      } while (tilemap.get_tile(i_row, i_col) != Tilemap::Tiles::SPACE);
+
+      float angle = (random() % 360) * 3.14159265f / 180.0f;
+      Camera camera(glm::vec3(i_col + 0.5f, 2.0f, i_row + 0.5f), glm::vec3(std::cos(angle), 0.0f, std::sin(angle)), glm::vec3(0.0f, 1.0f, 0.0f));
+      Frustum frustum(NEAR, FAR, ASPECT_RATIO);
+      frustum.calculate_planes(camera);
+      glm::mat4 view = camera.get_view();
+      glm::mat4 projection = glm::perspective(glm::radians(camera.fov), ASPECT_RATIO, NEAR, FAR);
+
+      time_start = steady_clock::now();
+      portals.traverse(view, projection, frustum);
+      interval_traverse += steady_clock::now() - time_start;
+      n_rooms_visible += portals.get_n_rooms_visible();
+
+      std::vector<unsigned int> indices;
+      for (size_t i_bbox = 0; i_bbox < bboxes.size(); ++i_bbox) {
+        if (frustum.intersect(bboxes[i_bbox]) != Intersection::OUTSIDE)
+          indices.push_back(i_bbox);
+      }
+
+      time_start = steady_clock::now();
+      for (unsigned int index : indices)
+        n_visible_portals += portals.is_visible(bboxes[index]);
+      interval_cull += steady_clock::now() - time_start;
+      n_visible_frustum += indices.size();
+    }
+
+    std::cout << name << " | " << portals.get_n_rooms() << " | " << interval_build.count() << " | "
+              << (float) n_rooms_visible / N_VIEWS << " | " << n_visible_frustum / N_VIEWS << " | " << n_visible_portals / N_VIEWS << " | "
+              << (float) n_visible_frustum / n_visible_portals << "x | " << interval_traverse.count() / N_VIEWS << " | " << interval_cull.count() / N_VIEWS << '\n';
+  }
+}
+
+int main() {
+  std::cout << "level | rooms | labeling (ms) | rooms visible | instances in frustum | through portals | reduction | traversal (us) | culling (us)" << '\n';
+  print_portals("map.txt", "assets/levels/map.txt");
+
+  for (unsigned int n_tiles : { 10000, 100000 }) {
+    LevelGenerator::Parameters parameters;
+    parameters.n_rows = parameters.n_cols = std::ceil(std::sqrt((double) n_tiles));
+    parameters.n_rooms = n_tiles / 256;
+    parameters.density_props = 0.1f;
+    LevelGenerator generator(parameters);
+
+    const std::string path = "assets/levels/generated.txt";
+    if (!generator.save(path)) {
+      std::cout << "Failed to save " << path << '\n';
+      return 1;
+    }
+
+    print_portals(std::to_string(n_tiles) + " tiles", path);
+  }
+
+  return 0;
+}
@@ -0,0 +1,62 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <glm/glm.hpp>
+
+#include "levels/level_generator.hpp"
+#include "levels/pvs.hpp"
+
+using namespace std::chrono;
+
+/**
+ * Time to bake potentially visible sets of all cells & fraction of cells around camera's cell kept by them,
+ * on game's level & on generated levels (where rooms walls hide most of the cells within far plane)
+ */
+namespace {
+  void print_pvs(const std::string& name, const std::string& path) {
+    Tilemap tilemap(path);
+    glm::ivec2 n_cells((tilemap.n_cols + Pvs::SIZE_CELL - 1) / Pvs::SIZE_CELL, (tilemap.n_rows + Pvs::SIZE_CELL - 1) / Pvs::SIZE_CELL);
+
+    // cells within radius inside map & visible ones among them
+    size_t n_cells_window = 0, n_cells_visible = 0;
+    steady_clock::time_point time_start = steady_clock::now();
+
+    for (int z = 0; z < n_cells.y; ++z) {
+      for (int x = 0; x < n_cells.x; ++x) {
+        Pvs::Cells cells = Pvs::bake(tilemap, glm::ivec2(x, z));
+        n_cells_visible += cells.count();
+        n_cells_window += (std::min(z + Pvs::RADIUS, n_cells.y - 1) - std::max(z - Pvs::RADIUS, 0) + 1) *
+                          (std::min(x + Pvs::RADIUS, n_cells.x - 1) - std::max(x - Pvs::RADIUS, 0) + 1);
+      }
+    }
+
+    duration<double, std::milli> interval = steady_clock::now() - time_start;
+    size_t n_cells_total = n_cells.x * n_cells.y;
+    std::cout << name << " | " << n_cells_total << " | " << interval.count() << " | " << interval.count() / n_cells_total << " | "
+              << 100.0f * n_cells_visible / n_cells_window << "%" << '\n';
+  }
+}
+
+int main() {
+  std::cout << "level | cells | baking (ms) | per cell (ms) | visible cells within radius" << '\n';
+  print_pvs("map.txt", "assets/levels/map.txt");
+
+  for (unsigned int n_tiles : { 10000, 100000, 1000000 }) {
+    LevelGenerator::Parameters parameters;
+    parameters.n_rows = parameters.n_cols = std::ceil(std::sqrt((double) n_tiles));
+    parameters.n_rooms = n_tiles / 256;
+    parameters.density_props = 0.1f;
+    LevelGenerator generator(parameters);
+
+    const std::string path = "assets/levels/generated.txt";
+    if (!generator.save(path)) {
+      std::cout << "Failed to save " << path << '\n';
+      return 1;
+    }
+
+    print_pvs(std::to_string(n_tiles) + " tiles", path);
+  }
+
+  return 0;
+}
@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "math/bounding_box.hpp"
+#include "math/bvh.hpp"
+#include "math/ray.hpp"
+
+using namespace std::chrono;
+
+/**
+ * Compare closest-hit raycast (shooting) over all targets bboxes (batched slab test)
+ * with BVH raycast on levels with 1k, 10k & 100k targets
+ */
+namespace {
+  /* Targets of samurai's size scattered randomly over a square level (same density for all sizes) */
+  std::vector<BoundingBox> generate_targets(unsigned int n_targets, float& size, std::mt19937& generator) {
+    std::vector<BoundingBox> bboxes(n_targets);
+    size = std::sqrt(10.0f * n_targets);
+    std::uniform_real_distribution<float> distribution(0.0f, size);
+    glm::vec3 half_diagonal(0.3f, 1.0f, 0.3f);
+
+    for (BoundingBox& bbox : bboxes)
+      bbox = BoundingBox(glm::vec3(distribution(generator), 1.0f, distribution(generator)), half_diagonal);
+
+    return bboxes;
+  }
+
+  /* Average duration of raycast function per ray in nanoseconds (distances to closest hit, as ties have same distance) */
+  template <typename Function>
+  double time_raycasts(Function raycast, const std::vector<Ray>& rays, std::vector<float>& distances) {
+    steady_clock::time_point time_start = steady_clock::now();
+    for (size_t i_ray = 0; i_ray < rays.size(); ++i_ray)
+      distances[i_ray] = raycast(rays[i_ray]);
+    duration<double, std::nano> interval = steady_clock::now() - time_start;
+
+    return interval.count() / rays.size();
+  }
+}
+
+int main() {
+  const unsigned int n_rays = 10000;
+  std::mt19937 generator(0);
+
+  std::cout << "n_targets | hits | flat (ns/ray) | bvh (ns/ray) | speedup" << '\n';
+
+  for (unsigned int n_targets : { 1000, 10000, 100000 }) {
+    float size;
+    std::vector<BoundingBox> bboxes = generate_targets(n_targets, size, generator);
+    math::BVH bvh(bboxes);
+
+    // horizontal rays shot at camera's elevation from random positions in random directions
+    std::uniform_real_distribution<float> distribution_position(0.0f, size);
+    std::uniform_real_distribution<float> distribution_angle(0.0f, 2.0f * M_PI);
+    std::vector<Ray> rays;
+    for (size_t i_ray = 0; i_ray < n_rays; ++i_ray) {
+      float angle = distribution_angle(generator);
+      glm::vec3 origin(distribution_position(generator), 2.0f, distribution_position(generator));
+      rays.push_back(Ray(origin, glm::vec3(std::cos(angle), -0.05f, std::sin(angle))));
+    }
+
+    // no hit => infinite distance
+    std::vector<float> distances_flat(n_rays), distances_bvh(n_rays);
+    double duration_flat = time_raycasts([&](const Ray& ray) {
+      float distance = std::numeric_limits<float>::infinity();
+      BoundingBox::raycast(ray, bboxes.data(), bboxes.size(), distance);
+      return distance;
+    }, rays, distances_flat);
+    double duration_bvh = time_raycasts([&](const Ray& ray) {
+      float distance;
+      bvh.raycast(ray, distance);
+      return distance;
+    }, rays, distances_bvh);
+
+    size_t n_hits = std::count_if(distances_flat.begin(), distances_flat.end(), [](float distance) { return !std::isinf(distance); });
+    std::cout << n_targets << " | " << n_hits << " | " << duration_flat << " | "
+              << duration_bvh << " | " << duration_flat / duration_bvh << "x" << '\n';
+
+    if (distances_flat != distances_bvh) {
+      std::cout << "Mismatch between flat & bvh closest hits" << '\n';
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "render/render_queue.hpp"
+
+using namespace std::chrono;
+
+/**
+ * Program, texture & vao changes between consecutive draw packets in submission order vs. once sorted by their keys,
+ * & radix sort of render queue vs. `std::sort()` of the same keys
+ * Packets drawn by `flush()` must come in the same order as keys sorted by `std::sort()`
+ */
+namespace {
+  const unsigned int N_PROGRAMS = 8, N_TEXTURES = 64, N_VAOS = 256;
+  const float FAR = 50.0f, RATIO_TRANSLUCENT = 0.1f;
+
+  /* Packets of random meshes (each vao drawn with its own program & texture), a tenth of them translucent */
+  std::vector<DrawState> get_states(size_t n_packets) {
+    std::mt19937 random(0);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    std::vector<DrawState> states(n_packets);
+
+    for (DrawState& state : states) {
+      state.is_translucent = distribution(random) < RATIO_TRANSLUCENT;
+      state.vao = random() % N_VAOS;
+      state.program = 1 + state.vao % N_PROGRAMS;
+      state.texture = 1 + (state.vao / N_PROGRAMS) % N_TEXTURES;
+      state.depth = distribution(random) * FAR;
+    }
+
+    return states;
+  }
+}
+
+int main() {
+  std::cout << "packets | state changes (programs/textures/vaos) submitted | state changes sorted | radix sort (us) | std::sort (us)" << '\n';
+
+  for (size_t n_packets : { 1000, 10000, 100000 }) {
+    std::vector<DrawState> states = get_states(n_packets);
+    RenderQueue queue;
+    std::vector<uint64_t> keys, keys_drawn;
+
+    // key of each packet recorded when it's drawn
+    auto draw = [](void* context, const void* data, size_t index) {
+      static_cast<std::vector<uint64_t>*>(context)->push_back(static_cast<const uint64_t*>(data)[index]);
+    };
+    for (const DrawState& state : states)
+      keys.push_back(RenderQueue::get_key(state));
+    for (size_t i_packet = 0; i_packet < states.size(); ++i_packet)
+      queue.submit(states[i_packet], { draw, &keys_drawn, keys.data(), i_packet });
+
+    RenderQueue::StateChanges changes_submitted = queue.get_state_changes();
+    steady_clock::time_point time_start = steady_clock::now();
+    queue.sort();
+    duration<double, std::micro> interval_radix = steady_clock::now() - time_start;
+    RenderQueue::StateChanges changes_sorted = queue.get_state_changes();
+
+    std::vector<uint64_t> keys_sorted = keys;
+    time_start = steady_clock::now();
+    std::sort(keys_sorted.begin(), keys_sorted.end());
+    duration<double, std::micro> interval_std = steady_clock::now() - time_start;
+
+    std::cout << n_packets << " | "
+              << changes_submitted.n_programs << '/' << changes_submitted.n_textures << '/' << changes_submitted.n_vaos << " | "
+              << changes_sorted.n_programs << '/' << changes_sorted.n_textures << '/' << changes_sorted.n_vaos << " | "
+              << interval_radix.count() << " | " << interval_std.count() << '\n';
+
+    // packets aren't two-sided, so no gl call made by queue itself
+    queue.flush();
+    if (keys_drawn != keys_sorted) {
+      std::cout << "Packets drawn in a different order than their sorted keys" << '\n';
+      return 1;
+    }
+  }
+
+  return 0;
+}
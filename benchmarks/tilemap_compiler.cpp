@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "levels/chunks_streamer.hpp"
+
+using namespace std::chrono;
+namespace fs = std::filesystem;
+
+/**
+ * Compile generated levels of rooms (walls, doors, windows, trees & enemies) into renderers entries
+ * with the previous serial compiler (map copied row by row, walls tiles searched in a list)
+ * vs. whole mapped tilemap compiled by bands of rows on 1 & all threads (`TilesEntries::compile()`),
+ * and vs. level's startup which only compiles chunks around spawn (as in game, PVS of their cells baked too)
+ */
+namespace {
+  const float HEIGHT_WALLS = 3.5f;
+
+  /* Total # of entries emitted by a compiler (compared between both) */
+  struct Counts {
+    size_t n_walls = 0;
+    size_t n_doors = 0;
+    size_t n_windows = 0;
+    size_t n_trees = 0;
+    size_t n_targets = 0;
+
+    bool operator==(const Counts& counts) const {
+      return n_walls == counts.n_walls && n_doors == counts.n_doors && n_windows == counts.n_windows &&
+             n_trees == counts.n_trees && n_targets == counts.n_targets;
+    }
+  };
+
+  /* Rooms of 16x16 tiles with a door & a window in each horizontal wall, a tree & an enemy inside */
+  void generate_tilemap(const std::string& path, unsigned int size) {
+    std::ofstream file(path);
+    std::string row(size, ' ');
+
+    for (unsigned int i_row = 0; i_row < size; ++i_row) {
+      for (unsigned int i_col = 0; i_col < size; ++i_col) {
+        unsigned int y = i_row % 16, x = i_col % 16;
+        char tile = ' ';
+        if (y == 0)
+          tile = (x == 0) ? 'G' : (x == 8) ? '=' : (x == 4) ? 'w' : '-';
+        else if (x == 0)
+          tile = '|';
+        else if (y == 8)
+          tile = (x == 4) ? 't' : (x == 12) ? 'e' : ' ';
+        row[i_col] = tile;
+      }
+
+      file << row << '\n';
+    }
+  }
+
+  /* Center of wall tile at mid-height (same as `Chunk`) */
+  glm::vec3 get_center_wall(const glm::vec3& position_tile, float angle) {
+    glm::mat4 model = glm::scale(
+      glm::rotate(glm::translate(glm::mat4(1.0f), position_tile), angle, glm::vec3(0.0f, 1.0f, 0.0f)),
+      glm::vec3(1.0f, HEIGHT_WALLS, 1.0f)
+    );
+    return glm::vec3(model * glm::vec4(0.5f, 0.5f, 0.0f, 1.0f));
+  }
+
+  /* Previous compiler: rows read into separate vectors & whole map parsed on one thread */
+  Counts compile_serial(const std::string& path) {
+    std::vector<std::vector<char>> map;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line))
+      map.push_back(std::vector<char>(line.begin(), line.end()));
+
+    std::vector<Tilemap::Tiles> tiles_walls = {
+      Tilemap::Tiles::WALL_H, Tilemap::Tiles::WALL_V, Tilemap::Tiles::WALL_L, Tilemap::Tiles::WALL_GAMMA,
+    };
+    std::vector<WallEntry> walls;
+    std::vector<glm::vec3> positions_doors, positions_windows, positions_trees, positions_targets, positions_walls;
+
+    for (size_t i_row = 0; i_row < map.size(); ++i_row) {
+      for (size_t i_col = 0; i_col < map[0].size(); ++i_col) {
+        Tilemap::Tiles tile = (Tilemap::Tiles) map[i_row][i_col];
+        glm::vec3 position_tile = {i_col, 0, i_row};
+        float angle = 0.0f;
+
+        switch (tile) {
+          case Tilemap::Tiles::WALL_H: walls.push_back({ position_tile, WallOrientation::HORIZONTAL }); break;
+          case Tilemap::Tiles::WALL_V: walls.push_back({ position_tile, WallOrientation::VERTICAL }); angle = glm::radians(90.0f); break;
+          case Tilemap::Tiles::WALL_L: walls.push_back({ position_tile, WallOrientation::L_SHAPED }); angle = glm::radians(90.0f); break;
+          case Tilemap::Tiles::WALL_GAMMA: walls.push_back({ position_tile, WallOrientation::GAMMA_SHAPED }); angle = glm::radians(-90.0f); break;
+          case Tilemap::Tiles::ENEMMY: positions_targets.push_back(position_tile); continue;
+          case Tilemap::Tiles::DOOR_H: positions_doors.push_back(position_tile); break;
+          case Tilemap::Tiles::WINDOW: positions_windows.push_back(position_tile); break;
+          case Tilemap::Tiles::TREE: positions_trees.push_back(position_tile); break;
+          default: break;
+        }
+
+        if (std::find(tiles_walls.begin(), tiles_walls.end(), tile) != tiles_walls.end())
+          positions_walls.push_back(get_center_wall(position_tile, angle));
+      }
+    }
+
+    return { walls.size(), positions_doors.size(), positions_windows.size(), positions_trees.size(), positions_targets.size() };
+  }
+
+  /* Whole mapped tilemap compiled by bands of rows into a single output (calling thread runs jobs too) */
+  Counts compile_bands(const std::string& path, unsigned int n_threads) {
+    JobSystem jobs(n_threads - 1);
+    Tilemap tilemap(path);
+    std::vector<glm::uvec2> positions_targets = tilemap.find(Tilemap::Tiles::ENEMMY, jobs);
+    TilesEntries entries = TilesEntries::compile(tilemap, glm::vec3(0.0f), HEIGHT_WALLS, jobs);
+
+    return { entries.walls.size(), entries.positions_doors.size(), entries.positions_windows.size(), entries.positions_trees.size(), positions_targets.size() };
+  }
+
+  /* Chunks around map's center compiled by `ChunksStreamer`, entries merged like `LevelRenderer::update()` */
+  Counts compile_startup(const std::string& path, unsigned int n_threads) {
+    JobSystem jobs(n_threads - 1);
+    Tilemap tilemap(path);
+    std::vector<glm::uvec2> positions_targets = tilemap.find(Tilemap::Tiles::ENEMMY, jobs);
+
+    glm::vec3 center(tilemap.n_cols / 2.0f, 0.0f, tilemap.n_rows / 2.0f);
+    ChunksStreamer streamer(tilemap, glm::vec3(0.0f), HEIGHT_WALLS, 4, 64 << 20, n_threads);
+    streamer.update(center, true);
+
+    std::vector<WallEntry> walls;
+    std::vector<glm::vec3> positions_doors, positions_windows, positions_trees, positions_walls;
+    for (const std::shared_ptr<const Chunk>& chunk : streamer.get_chunks()) {
+      walls.insert(walls.end(), chunk->walls.begin(), chunk->walls.end());
+      positions_doors.insert(positions_doors.end(), chunk->positions_doors.begin(), chunk->positions_doors.end());
+      positions_trees.insert(positions_trees.end(), chunk->positions_trees.begin(), chunk->positions_trees.end());
+      positions_windows.insert(positions_windows.end(), chunk->positions_windows.begin(), chunk->positions_windows.end());
+      positions_walls.insert(positions_walls.end(), chunk->positions_walls.begin(), chunk->positions_walls.end());
+    }
+
+    return { walls.size(), positions_doors.size(), positions_windows.size(), positions_trees.size(), positions_targets.size() };
+  }
+
+  /* Duration of given compiler in milliseconds */
+  template <typename Function>
+  double time_compiling(Function compile, Counts& counts) {
+    steady_clock::time_point time_start = steady_clock::now();
+    counts = compile();
+    duration<double, std::milli> interval = steady_clock::now() - time_start;
+
+    return interval.count();
+  }
+}
+
+int main() {
+  unsigned int n_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  fs::path directory = fs::temp_directory_path() / "benchmark_tilemap_compiler";
+  fs::create_directories(directory);
+
+  std::cout << "size | walls | serial (ms) | bands 1 thread (ms) | bands " << n_threads << " threads (ms) | startup (ms) | speedup" << '\n';
+
+  for (unsigned int size : { 1000, 4000, 10000 }) {
+    std::string path = (directory / ("map_" + std::to_string(size) + ".txt")).string();
+    generate_tilemap(path, size);
+
+    Counts counts_serial, counts_bands, counts_parallel, counts_startup;
+    double duration_serial = time_compiling([&]() { return compile_serial(path); }, counts_serial);
+    double duration_bands = time_compiling([&]() { return compile_bands(path, 1); }, counts_bands);
+    double duration_parallel = time_compiling([&]() { return compile_bands(path, n_threads); }, counts_parallel);
+    double duration_startup = time_compiling([&]() { return compile_startup(path, n_threads); }, counts_startup);
+    fs::remove(path);
+
+    std::cout << size << "x" << size << " | " << counts_serial.n_walls << " | " << duration_serial << " | " << duration_bands << " | "
+              << duration_parallel << " | " << duration_startup << " | " << duration_serial / duration_startup << "x" << '\n';
+
+    if (!(counts_bands == counts_serial) || !(counts_parallel == counts_serial)) {
+      std::cout << "Bands compiler emitted different entries than serial compiler" << '\n';
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,102 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "levels/level_generator.hpp"
+#include "levels/walls_merger.hpp"
+
+using namespace std::chrono;
+
+/**
+ * Walls instances (& bboxes) drawn before & after merging collinear adjacent walls,
+ * on game's level & on generated levels from 1k to 1M tiles
+ */
+namespace {
+  const float LENGTH = 1.0f, HEIGHT = 3.5f, DEPTH = 0.2f;
+
+  /* Unit wall box at given center rotated by `angle` in deg (same as `WallsRenderer::calculate_uniforms_full()`) */
+  glm::mat4 get_model(const glm::vec3& center, float angle) {
+    return glm::rotate(glm::translate(glm::mat4(1.0f), center), glm::radians(angle), glm::vec3(0.0f, 1.0f, 0.0f));
+  }
+
+  /* One box per wall tile (two for L-shaped walls) with same offsets & angles as `WallsRenderer` */
+  std::vector<glm::mat4> get_models_walls(const std::vector<std::string>& rows) {
+    std::vector<glm::mat4> models;
+    glm::vec3 offset_h(LENGTH / 2, HEIGHT / 2, DEPTH / 2);
+    glm::vec3 offset_v(DEPTH / 2, HEIGHT / 2, -LENGTH / 2);
+    glm::vec3 offset_v_gamma(DEPTH / 2, HEIGHT / 2, LENGTH / 2);
+
+    for (size_t i_row = 0; i_row < rows.size(); ++i_row) {
+      for (size_t i_col = 0; i_col < rows[i_row].size(); ++i_col) {
+        glm::vec3 position(i_col, 0, i_row);
+        switch (rows[i_row][i_col]) {
+          case '-': models.push_back(get_model(position + offset_h, 0)); break;
+          case '|': models.push_back(get_model(position + offset_v, 90)); break;
+          case 'L': models.insert(models.end(), { get_model(position + offset_v, 90), get_model(position + offset_h, 0) }); break;
+          case 'G': models.insert(models.end(), { get_model(position + offset_h, 0), get_model(position + offset_v_gamma, 90) }); break;
+          default: break;
+        }
+      }
+    }
+
+    return models;
+  }
+
+  /* Walls below & above each window */
+  std::vector<glm::mat4> get_models_around_windows(const std::vector<std::string>& rows) {
+    std::vector<glm::mat4> models;
+    float height_subwall = (HEIGHT - 1.0f) / 2;
+
+    for (size_t i_row = 0; i_row < rows.size(); ++i_row) {
+      for (size_t i_col = 0; i_col < rows[i_row].size(); ++i_col) {
+        if (rows[i_row][i_col] != 'w')
+          continue;
+
+        glm::vec3 position_bottom = glm::vec3(i_col, 0, i_row) + glm::vec3(LENGTH / 2, height_subwall / 2, DEPTH / 2);
+        glm::vec3 position_top = position_bottom + glm::vec3(0, height_subwall + 1.0f, 0);
+        models.insert(models.end(), { get_model(position_bottom, 0), get_model(position_top, 0) });
+      }
+    }
+
+    return models;
+  }
+
+  void print_counts(const std::string& name, const std::vector<std::string>& rows) {
+    std::vector<glm::mat4> models = get_models_walls(rows);
+    std::vector<glm::mat4> models_around_windows = get_models_around_windows(rows);
+
+    steady_clock::time_point time_start = steady_clock::now();
+    std::vector<glm::mat4> models_runs = WallsMerger::merge(models, LENGTH);
+    std::vector<glm::mat4> models_runs_around_windows = WallsMerger::merge(models_around_windows, LENGTH);
+    duration<double, std::milli> interval = steady_clock::now() - time_start;
+
+    std::cout << name << " | " << models.size() << " | " << models_runs.size() << " | " << (float) models.size() / models_runs.size() << "x | "
+              << models_around_windows.size() << " | " << models_runs_around_windows.size() << " | " << interval.count() << '\n';
+  }
+}
+
+int main() {
+  std::cout << "level | walls | runs | reduction | walls around windows | runs | merging (ms)" << '\n';
+
+  std::vector<std::string> rows;
+  std::ifstream file("assets/levels/map.txt");
+  for (std::string row; std::getline(file, row);)
+    rows.push_back(row);
+  print_counts("map.txt", rows);
+
+  for (unsigned int n_tiles : { 1000, 10000, 100000, 1000000 }) {
+    LevelGenerator::Parameters parameters;
+    parameters.n_rows = parameters.n_cols = std::ceil(std::sqrt((double) n_tiles));
+    parameters.n_rooms = n_tiles / 256;
+    parameters.n_enemies = n_tiles / 512;
+    parameters.density_props = 0.1f;
+    LevelGenerator generator(parameters);
+    print_counts(std::to_string(n_tiles) + " tiles", generator.get_rows());
+  }
+
+  return 0;
+}
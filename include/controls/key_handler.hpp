@@ -18,6 +18,9 @@ private:
 
   /* Observers (references so they can be modified) */
   CameraFPS& m_camera;
+
+  /* trace exported once per press on <p> (not on every frame key is held) */
+  bool m_is_pressed_profiler;
 };
 
 #endif // KEY_HANDLER_HPP
@@ -3,6 +3,7 @@
 
 #include "window.hpp"
 #include "navigation/camera_fps.hpp"
+#include "levels/level_renderer.hpp"
 #include "audio/audio.hpp"
 
 /**
@@ -13,7 +14,7 @@
 class MouseHandler {
 public:
   /* No need for instance constructor to init static private members */
-  static void init(Window* window, CameraFPS* camera, Audio* audio);
+  static void init(Window* window, CameraFPS* camera, Audio* audio, const LevelRenderer* level);
 
   /* static methods can be passed as function pointers callbacks (no `this` argument) */
   static void on_mouse_move(GLFWwindow* window, double xpos, double ypos);
@@ -34,6 +35,9 @@ private:
 
   /* irrklang sound engine (for playing sound effects) */
   static Audio* m_audio;
+
+  /* targets & walls shot at on click */
+  static const LevelRenderer* m_level;
 };
 
 #endif // MOUSE_HANDLER_HPP
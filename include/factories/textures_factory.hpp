@@ -3,9 +3,11 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "texture/texture_2d.hpp"
 #include "texture/texture_3d.hpp"
+#include "loaders/assets_loader.hpp"
 
 /*
  * Factory to produce 2D/3D texture (exploit runtime polymorphism)
@@ -13,7 +15,7 @@
  */
 class TexturesFactory {
 public:
-  TexturesFactory();
+  TexturesFactory(AssetsLoader& assets_loader);
 
   template <typename T>
   T get(const std::string& key) const;
@@ -21,23 +23,10 @@ public:
   void free();
 
 private:
-  std::unique_ptr<Texture2D> m_health;
-  std::unique_ptr<Texture2D> m_crosshair;
-  std::unique_ptr<Texture2D> m_wall_diffuse;
-  std::unique_ptr<Texture2D> m_wall_normal;
-  std::unique_ptr<Texture2D> m_door_diffuse;
-  std::unique_ptr<Texture2D> m_door_normal;
-  std::unique_ptr<Texture2D> m_floor_diffuse;
-  std::unique_ptr<Texture2D> m_floor_normal;
-  std::unique_ptr<Texture2D> m_ceiling_diffuse;
-  std::unique_ptr<Texture2D> m_ceiling_normal;
-  std::unique_ptr<Texture2D> m_window;
-
-  /**
-   * using pointers bcos base class Texture is abstract (non-constructible)
-   * avoid unique_ptr as values bcos map is init from initializer_list => range ctor => copy items (pair)
-   * and copying not allowed with unique_ptr
-   */
+  /* smart pointers freed when out of scope (map below only references them) */
+  std::vector<std::unique_ptr<Texture2D>> m_textures_2d;
+
+  /* using pointers bcos base class Texture is abstract (non-constructible) */
   std::unordered_map<std::string, Texture*> m_textures;
 };
 
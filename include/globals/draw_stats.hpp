@@ -0,0 +1,10 @@
+#ifndef GLOBALS_DRAW_STATS_HPP
+#define GLOBALS_DRAW_STATS_HPP
+
+#include "profiling/draw_stats.hpp"
+
+// draw stats declared as a global variable (i.e. accessible from every renderer)
+// https://stackoverflow.com/a/3627979/2228912 
+extern DrawStats draw_stats;
+
+#endif // GLOBALS_DRAW_STATS_HPP
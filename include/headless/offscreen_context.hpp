@@ -0,0 +1,34 @@
+#ifndef OFFSCREEN_CONTEXT_HPP
+#define OFFSCREEN_CONTEXT_HPP
+
+#include <glad/glad.h>
+#include <EGL/egl.h>
+
+/**
+ * OpenGL context without any window or display (EGL surfaceless platform), e.g. Mesa llvmpipe on a build agent
+ * Replaces `Window` in headless mode: frames rendered to a framebuffer with color & depth/stencil renderbuffers
+ */
+class OffscreenContext {
+public:
+  unsigned int width;
+  unsigned int height;
+
+  OffscreenContext(unsigned int w, unsigned int h);
+  bool is_null() const;
+  bool load_gl();
+  void destroy();
+
+private:
+  EGLDisplay m_display;
+  EGLContext m_context;
+
+  /* offscreen framebuffer (replaces default framebuffer of a window) */
+  GLuint m_fbo;
+  GLuint m_rbo_color;
+  GLuint m_rbo_depth_stencil;
+
+  EGLDisplay get_display() const;
+  void create_framebuffer();
+};
+
+#endif // OFFSCREEN_CONTEXT_HPP
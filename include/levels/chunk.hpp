@@ -0,0 +1,61 @@
+#ifndef CHUNK_HPP
+#define CHUNK_HPP
+
+#include <array>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "entries/wall_entry.hpp"
+#include "levels/tilemap.hpp"
+#include "levels/pvs.hpp"
+#include "utils/job_system.hpp"
+
+/**
+ * Entries parsed from a block of tiles, passed to level renderers (walls centers also used for collision with camera)
+ * Tiles are counted before being parsed into vectors allocated once, so blocks (e.g. bands of rows)
+ * can be parsed in parallel at their offsets in a single output (see `compile()`)
+ */
+struct TilesEntries {
+  /* # of entries of each kind in a block, or offsets of its entries in output */
+  struct Counts {
+    size_t n_walls = 0;
+    size_t n_doors = 0;
+    size_t n_trees = 0;
+    size_t n_windows = 0;
+  };
+
+  /* positions of tiles elements (origin at tilemap's upper-left corner) */
+  std::vector<WallEntry> walls;
+  std::vector<glm::vec3> positions_doors;
+  std::vector<glm::vec3> positions_trees;
+  std::vector<glm::vec3> positions_windows;
+  std::vector<glm::vec3> positions_walls;
+
+  static Counts count(const Tilemap& tilemap, const glm::uvec2& tile_min, const glm::uvec2& tile_max);
+  static TilesEntries compile(const Tilemap& tilemap, const glm::vec3& position_level, float height_walls, JobSystem& jobs);
+  void resize(const Counts& counts);
+  void fill(const Tilemap& tilemap, const glm::uvec2& tile_min, const glm::uvec2& tile_max, Counts offsets, const glm::vec3& position_level, float height_walls);
+};
+
+/**
+ * Square block of tiles parsed on streaming thread (see `ChunksStreamer`)
+ * Holds entries passed to level renderers, walls centers used for collision with camera,
+ * & potentially visible sets of its cells (baked on streaming thread too)
+ */
+struct Chunk : TilesEntries {
+  /* # of tiles along each side */
+  static constexpr unsigned int SIZE = 32;
+  static constexpr unsigned int N_CELLS = SIZE / Pvs::SIZE_CELL;
+
+  /* column & row of chunk in tilemap (in chunks not tiles) */
+  glm::ivec2 coords;
+
+  /* cells visible from each of chunk's cells (row by row) */
+  std::array<Pvs::Cells, N_CELLS * N_CELLS> pvs;
+
+  Chunk(const Tilemap& tilemap, const glm::ivec2& coords, const glm::vec3& position_level, float height_walls);
+  size_t get_size() const;
+  Pvs get_pvs(const glm::ivec2& cell, const glm::vec3& position_level) const;
+};
+
+#endif // CHUNK_HPP
@@ -0,0 +1,66 @@
+#ifndef CHUNKS_STREAMER_HPP
+#define CHUNKS_STREAMER_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "levels/chunk.hpp"
+
+/**
+ * Keeps chunks of tilemap around camera resident (parsed on background threads as camera moves)
+ * Chunks out of range are evicted & radius shrunk if needed, so memory used stays within a budget whatever map's size
+ * (budget covers chunks & data calculated from them by renderers, see `set_size_renderers()`)
+ */
+class ChunksStreamer {
+public:
+  ChunksStreamer(const Tilemap& tilemap, const glm::vec3& position_level, float height_walls, unsigned int radius=4, size_t budget=64 << 20, unsigned int n_threads=std::thread::hardware_concurrency());
+  ~ChunksStreamer();
+  bool update(const glm::vec3& position, bool wait=false);
+  std::vector<std::shared_ptr<const Chunk>> get_chunks() const;
+  void set_size_renderers(size_t size_renderers, size_t size_chunks);
+  size_t get_size() const;
+
+  ChunksStreamer(const ChunksStreamer&) = delete;
+  ChunksStreamer& operator=(const ChunksStreamer&) = delete;
+
+private:
+  const Tilemap& m_tilemap;
+  glm::vec3 m_position_level;
+  float m_height_walls;
+
+  /* max. distance (in chunks) of resident chunks from camera's chunk & max. bytes used by them */
+  unsigned int m_radius;
+  size_t m_budget;
+
+  /* resident chunks & chunks being built by their key (only accessed from main thread) */
+  std::unordered_map<uint64_t, std::shared_ptr<const Chunk>> m_chunks;
+  std::unordered_set<uint64_t> m_keys_queued;
+  size_t m_size;
+
+  /* bytes used by renderers per byte of chunk they're calculated from (measured on last update of renderers) */
+  double m_ratio_renderers;
+
+  /* shared with streaming thread (guarded by mutex) */
+  std::deque<glm::ivec2> m_queue;
+  std::vector<std::shared_ptr<const Chunk>> m_chunks_built;
+  unsigned int m_n_building;
+  bool m_is_stopped;
+  std::mutex m_mutex;
+  std::condition_variable m_condition_queue;
+  std::condition_variable m_condition_built;
+  std::vector<std::thread> m_threads;
+
+  void run();
+  unsigned int get_radius() const;
+  static uint64_t get_key(const glm::ivec2& coords);
+  static unsigned int get_distance(const glm::ivec2& coords1, const glm::ivec2& coords2);
+};
+
+#endif // CHUNKS_STREAMER_HPP
@@ -3,33 +3,56 @@
 
 #include "factories/shaders_factory.hpp"
 #include "factories/textures_factory.hpp"
-#include "render/renderer.hpp"
+#include "render/instanced_renderer.hpp"
+#include "render/render_queue.hpp"
 #include "navigation/frustum.hpp"
+#include "levels/visibility.hpp"
 
 /* Called from LevelRenderer to render doors */
 class DoorsRenderer {
 public:
+  /* per-instance data calculated from resident chunks off main thread (see `LevelRenderer`) */
+  struct Instances {
+    std::vector<glm::mat4> models;
+    std::vector<glm::mat4> normals_mats;
+    std::vector<unsigned int> textures_indices;
+    std::vector<BoundingBox> bboxes;
+    math::BVH bvh;
+
+    size_t get_size() const;
+  };
+
   DoorsRenderer(const ShadersFactory& shaders_factory, const TexturesFactory& textures_factory);
-  void calculate_uniforms(const std::vector<glm::vec3>& positions);
-  void calculate_bboxes(const std::vector<glm::vec3>& positions_tiles);
-  void set_transform(const Transformation& t, const Frustum& frustum);
-  void draw(const Uniforms& u);
+  Instances calculate_instances(const std::vector<glm::vec3>& positions_tiles) const;
+  void set_instances(Instances& instances);
+  void cull(const Frustum& frustum, const Visibility& visibility, JobSystem& jobs);
+  void set_transform(const Transformation& t);
+  const std::vector<BoundingBox>& get_bboxes() const;
+  void submit(RenderQueue& queue, const Uniforms& u, const glm::vec3& position_camera);
   void free();
 
 private:
   const glm::vec3 m_size = { 1.0, 3.5, 0 };
 
-  Renderer m_renderer;
+  InstancedRenderer m_renderer;
 
   Texture2D m_tex_diffuse;
   Texture2D m_tex_normal;
 
   std::vector<glm::mat4> m_models;
   std::vector<BoundingBox> m_bboxes;
+  math::BVH m_bvh;
+  FrustumCache m_cache_frustum;
+
+  /* visible instances on last frame (buffer reused between frames) */
+  std::vector<unsigned int> m_indices;
 
   std::vector<glm::mat4> m_normals_mats;
+
+  /* distinct textures & index of each instance's textures in them (all doors share the same textures) */
   std::vector<Texture2D> m_textures_diffuse;
   std::vector<Texture2D> m_textures_normal;
+  std::vector<unsigned int> m_textures_indices;
 };
 
 #endif // DOORS_RENDERER_HPP
@@ -6,7 +6,8 @@
 #include "entries/wall_entry.hpp"
 #include "factories/shaders_factory.hpp"
 #include "factories/textures_factory.hpp"
-#include "render/renderer.hpp"
+#include "render/instanced_renderer.hpp"
+#include "render/render_queue.hpp"
 #include "texture/texture_2d.hpp"
 
 /* Called from LevelRenderer to render floor & ceiling */
@@ -14,7 +15,7 @@ class FloorsRenderer {
 public:
   FloorsRenderer(const ShadersFactory& shaders_factory, const TexturesFactory& textures_factory, const glm::vec2& size);
   void set_transform(const Transformation& t);
-  void draw(const Uniforms& uniforms);
+  void submit(RenderQueue& queue, const Uniforms& uniforms);
   void free();
 
 private:
@@ -22,7 +23,7 @@ private:
   const float m_height = 3.5;
   glm::vec2 m_size;
 
-  Renderer m_renderer;
+  InstancedRenderer m_renderer;
 
   /* textures (lifecycle managed by TexturesFactory) */
   Texture2D m_tex_floor_diffuse;
@@ -34,8 +35,11 @@ private:
   const unsigned int m_n_floors = 2;
   std::vector<glm::mat4> m_models_floors;
   std::vector<glm::mat4> m_normals_mats_floors;
+
+  /* distinct textures (floor & ceiling) & index of each instance's textures in them */
   std::vector<Texture2D> m_textures_diffuse;
   std::vector<Texture2D> m_textures_normal;
+  std::vector<unsigned int> m_textures_indices;
 
   void calculate_uniforms();
 };
@@ -0,0 +1,60 @@
+#ifndef LEVEL_GENERATOR_HPP
+#define LEVEL_GENERATOR_HPP
+
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Seeded generator of tilemaps in the format parsed by `Tilemap` (e.g. for culling & collision benchmarks at scale)
+ * Grid of rooms all reachable from each other, with extra passages, trees, windows & enemies
+ * Same parameters & seed give the same map on any platform (only raw outputs of mt19937 are used)
+ */
+class LevelGenerator {
+public:
+  struct Parameters {
+    unsigned int n_rows = 64;
+    unsigned int n_cols = 64;
+    unsigned int n_rooms = 16;
+
+    /* fraction of walls between neighbouring rooms with a passage (besides those keeping every room reachable) */
+    float density_corridors = 0.3f;
+
+    /* fraction of free tiles with a tree & of outer horiz. walls tiles with a window */
+    float density_props = 0.02f;
+
+    unsigned int n_enemies = 16;
+    unsigned int seed = 0;
+  };
+
+  LevelGenerator(const Parameters& parameters);
+  const std::vector<std::string>& get_rows() const;
+  unsigned int get_n_rooms() const;
+  bool save(const std::string& path) const;
+  bool save_camera_path(const std::string& path) const;
+
+private:
+  Parameters m_parameters;
+  std::mt19937 m_random;
+
+  /* walls lines between rooms (first & last ones are map's borders) */
+  std::vector<unsigned int> m_rows_walls;
+  std::vector<unsigned int> m_cols_walls;
+  unsigned int m_n_rooms;
+
+  /* tiles with a horiz. wall (towards +x) & with a vert. wall (towards -z), both with an L-shaped one (see `WallsRenderer::calculate_offsets()`) */
+  std::vector<std::vector<bool>> m_walls_h;
+  std::vector<std::vector<bool>> m_walls_v;
+  std::vector<std::string> m_rows;
+
+  void generate_walls();
+  void generate_passages();
+  void generate_tiles();
+  void generate_props();
+  void connect(unsigned int i_room, bool is_left);
+  bool is_free(unsigned int i_row, unsigned int i_col) const;
+  unsigned int get_random(unsigned int n);
+  float get_random_float();
+};
+
+#endif // LEVEL_GENERATOR_HPP
@@ -1,6 +1,10 @@
 #ifndef LEVEL_RENDERER_HPP
 #define LEVEL_RENDERER_HPP
 
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 
 #include "render/renderer.hpp"
@@ -13,7 +17,12 @@
 #include "levels/targets_renderer.hpp"
 
 #include "levels/tilemap.hpp"
+#include "levels/chunks_streamer.hpp"
+#include "levels/portals.hpp"
+#include "navigation/occlusion_buffer.hpp"
+#include "render/render_queue.hpp"
 #include "shader/program.hpp"
+#include "utils/job_system.hpp"
 
 #include "entries/target_entry.hpp"
 #include "entries/wall_orientation.hpp"
@@ -26,22 +35,52 @@
 
 /**
  * Renderer for level items (e.g. walls, doors...)
+ * Only items in chunks of tilemap streamed around camera are passed to renderers (targets excepted),
+ * & only those in cells potentially visible from camera's cell (see `Pvs`), seen through portals (see `Portals`),
+ * & not hidden behind walls (see `OcclusionBuffer`) are drawn
+ * Renderers instances are calculated from resident chunks on a background thread when they change
  */
 struct LevelRenderer {
   /* Used to block camera from going through walls */
   std::vector<glm::vec3> positions_walls;
 
-  LevelRenderer(Assimp::Importer& importer, const ShadersFactory& shaders_factory, const TexturesFactory& textures_factory);
+  LevelRenderer(AssetsLoader& assets_loader, const ShadersFactory& shaders_factory, const TexturesFactory& textures_factory, const std::string& path_tilemap="assets/levels/map.txt");
+  ~LevelRenderer();
+  bool update(const glm::vec3& position, bool wait=false);
   void draw(const Uniforms& u={});
   void set_transform(const Transformation& t, const Frustum& frustum);
+  bool save_occlusion_buffer(const std::string& path) const;
+  int raycast_targets(const Ray& ray) const;
   void free();
 
+  LevelRenderer(const LevelRenderer&) = delete;
+  LevelRenderer& operator=(const LevelRenderer&) = delete;
+
 private:
+  /* data calculated from a set of resident chunks, swapped in at once */
+  struct Instances {
+    std::vector<std::shared_ptr<const Chunk>> chunks;
+    std::vector<glm::vec3> positions_walls;
+    DoorsRenderer::Instances doors;
+    WallsRenderer::Instances walls;
+    TreesRenderer::Instances trees;
+    WindowsRenderer::Instances windows;
+    Portals portals;
+
+    /* bytes used by data above (measured before it's moved into renderers) & by chunks it was calculated from */
+    size_t size;
+    size_t size_chunks;
+  };
+
   /* Height of walls & elevation of ceiling */
   const float m_height = 3.5;
 
+  /* position of level */
+  glm::vec3 m_position;
+
   /* declared before `m_renderer_floor` as nrows/ncols needed to avoid stretching texture */
   Tilemap m_tilemap;
+  ChunksStreamer m_streamer;
 
   /**
    * Renderers for wall, window, ceiling/floor tiles, & trees props
@@ -55,18 +94,38 @@ private:
   WindowsRenderer m_renderer_windows;
   TargetsRenderer m_renderer_targets;
 
-  /* position of level */
-  glm::vec3 m_position;
-
-  /* positions of tiles elements (parsed only once in constructor) */
-  std::vector<glm::vec3> m_positions_doors;
-  std::vector<glm::vec3> m_positions_trees;
-  std::vector<glm::vec3> m_positions_windows;
-  std::vector<WallEntry> m_walls;
-
-  void parse_tilemap();
-  void calculate_uniforms();
-  void calculate_bboxes();
+  /* resident chunks (PVS of camera's cell looked up in them) */
+  std::vector<std::shared_ptr<const Chunk>> m_chunks;
+
+  /* rooms & portals in resident chunks */
+  Portals m_portals;
+
+  /* depth buffer rasterized on cpu from walls each frame */
+  OcclusionBuffer m_occlusion;
+
+  /* renderers culled in parallel on its workers */
+  JobSystem m_jobs;
+
+  /* draw packets of renderers sorted to minimize state changes & camera position for their depth */
+  RenderQueue m_queue;
+  glm::vec3 m_position_camera;
+
+  /* latest resident chunks & instances calculated from them on background thread (guarded by mutex) */
+  std::vector<std::shared_ptr<const Chunk>> m_chunks_pending;
+  std::unique_ptr<Instances> m_instances_calculated;
+  bool m_has_chunks_pending;
+  bool m_is_calculating;
+  bool m_is_stopped;
+  std::mutex m_mutex;
+  std::condition_variable m_condition_pending;
+  std::condition_variable m_condition_calculated;
+  std::thread m_thread;
+
+  void parse_targets();
+  void run();
+  std::unique_ptr<Instances> calculate_instances(const std::vector<std::shared_ptr<const Chunk>>& chunks) const;
+  void set_instances(Instances& instances);
+  Pvs get_pvs(const glm::vec3& position) const;
 };
 
 #endif // LEVEL_RENDERER_HPP
@@ -0,0 +1,62 @@
+#ifndef PORTALS_HPP
+#define PORTALS_HPP
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "levels/tilemap.hpp"
+#include "math/bounding_box.hpp"
+#include "navigation/frustum.hpp"
+
+/**
+ * Runtime portal culling: rooms are tiles regions enclosed by walls, doors & windows in resident chunks,
+ * & doors & windows between two rooms are portals
+ * Each frame, rooms are traversed from camera's room through portals, with frustum narrowed to each portal's screen rectangle,
+ * & instances are only visible if inside narrowed frustum of a room they touch
+ */
+class Portals {
+public:
+  Portals();
+  void build(const Tilemap& tilemap, const glm::ivec2& tile_min, const glm::ivec2& tile_max, const glm::vec3& position_level,
+             const std::vector<BoundingBox>& bboxes_doors, const std::vector<BoundingBox>& bboxes_windows);
+  void traverse(const glm::mat4& view, const glm::mat4& projection, const Frustum& frustum);
+  bool is_visible(const BoundingBox& bbox) const;
+  unsigned int get_n_rooms() const;
+  unsigned int get_n_rooms_visible() const;
+  size_t get_size() const;
+
+private:
+  /* door or window between two rooms */
+  struct Portal {
+    BoundingBox bbox;
+    unsigned int rooms[2];
+  };
+
+  /* resident tiles (upper-left corner & size) & room of each one (row by row) */
+  glm::ivec2 m_tile_min;
+  glm::ivec2 m_size;
+  glm::vec3 m_position_level;
+  std::vector<unsigned int> m_rooms;
+  unsigned int m_n_rooms;
+
+  /* portals & indices of portals of each room (starting at its offset) */
+  std::vector<Portal> m_portals;
+  std::vector<unsigned int> m_offsets_rooms;
+  std::vector<unsigned int> m_portals_rooms;
+
+  /* false if camera outside resident tiles (everything visible) */
+  bool m_is_active;
+
+  /* screen rectangle (NDC) each room is seen through (empty if hidden) & frustum narrowed to it */
+  std::vector<glm::vec4> m_rects;
+  std::vector<Frustum> m_frustums;
+  unsigned int m_n_rooms_visible;
+
+  /* traversal of each room/portal pair (indexed like `m_portals_rooms`) & rooms in traversal's queue (reused each frame) */
+  std::vector<unsigned char> m_traversals;
+  std::vector<bool> m_is_queued;
+
+  unsigned int get_room(int i_row, int i_col) const;
+};
+
+#endif // PORTALS_HPP
@@ -0,0 +1,39 @@
+#ifndef PVS_HPP
+#define PVS_HPP
+
+#include <bitset>
+#include <glm/glm.hpp>
+
+#include "levels/tilemap.hpp"
+#include "math/bounding_box.hpp"
+
+/**
+ * Potentially visible set (PVS) of camera's cell: tilemap is split into square cells of tiles,
+ * & cells visible from each cell are baked with chunks (see `Chunk`) by casting rays from each cell on xz-plane
+ * Instances whose bbox overlaps none of the cells visible from camera's cell are skipped after frustum culling
+ */
+class Pvs {
+public:
+  /* # of tiles along each side of a cell & max. distance (in cells) of visible cells (covers camera's far plane) */
+  static constexpr unsigned int SIZE_CELL = 8;
+  static constexpr int RADIUS = 7;
+  static constexpr unsigned int N_CELLS = (2 * RADIUS + 1) * (2 * RADIUS + 1);
+
+  /* visibility of cells around a cell (one bit each, row by row) */
+  using Cells = std::bitset<N_CELLS>;
+
+  static Cells bake(const Tilemap& tilemap, const glm::ivec2& cell);
+
+  Pvs();
+  Pvs(const glm::ivec2& cell, const Cells& cells, const glm::vec3& position_level);
+  bool is_visible(const BoundingBox& bbox) const;
+
+private:
+  /* everything visible if camera's cell isn't baked (e.g. camera outside of level) */
+  bool m_is_baked;
+  glm::ivec2 m_cell;
+  Cells m_cells;
+  glm::vec3 m_position_level;
+};
+
+#endif // PVS_HPP
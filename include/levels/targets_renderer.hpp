@@ -3,33 +3,40 @@
 
 #include "factories/shaders_factory.hpp"
 #include "entries/target_entry.hpp"
-#include "render/model_renderer.hpp"
+#include "loaders/assets_loader.hpp"
+#include "render/lod_renderer.hpp"
+#include "render/render_queue.hpp"
 #include "math/bounding_box.hpp"
 #include "navigation/frustum.hpp"
+#include "levels/visibility.hpp"
 
 /* Target to destroy on intersection with mouse cursor */
 class TargetsRenderer {
 public:
-  TargetsRenderer(const ShadersFactory& shaders_factory, Assimp::Importer& importer);
+  TargetsRenderer(const ShadersFactory& shaders_factory, AssetsLoader& assets_loader);
   void calculate_bboxes();
   void calculate_uniforms();
-  void set_transform(const Transformation& t, const Frustum& frustum);
-  void draw(const Uniforms& uniforms);
+  void cull(const Transformation& t, const Frustum& frustum, const Visibility& visibility);
+  void set_transform(const Transformation& t);
+  void submit(RenderQueue& queue, const Uniforms& uniforms, const glm::vec3& position_camera);
+  int raycast(const Ray& ray, float& distance) const;
   void free();
 
 private:
-  /* delegate drawing to model renderer */
-  assimp_utils::Model m_model3d;
-  ModelRenderer m_renderer;
+  /* delegate drawing to renderer of model's LODs */
+  LodRenderer m_renderer;
 
-  /* Bounding box in local space */
+  /* Bounding box in local space & hierarchy of targets bboxes in world space (targets are static) */
   BoundingBox m_bounding_box;
+  math::BVH m_bvh;
+  FrustumCache m_cache_frustum;
+
+  /* visible & alive targets on last frame (buffer reused between frames) */
+  std::vector<unsigned int> m_indices;
 
   /* Uniform matrices for all targets (dead & alive) */
   std::vector<glm::mat4> m_models;
   std::vector<glm::mat4> m_normals_mats;
-
-  std::vector<glm::mat4> cull_dead(const std::vector<glm::mat4>& matrices, const std::vector<TargetEntry> targets);
 };
 
 #endif // TARGETS_RENDERER_HPP
@@ -2,11 +2,19 @@
 #define TILEMAP_HPP
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <glm/glm.hpp>
 
+#include "utils/job_system.hpp"
+#include "utils/mapped_file.hpp"
+
+/**
+ * Tilemap file mapped in memory & only indexed by rows at load,
+ * so tiles of very large maps are read on demand (see `Chunk`) instead of being copied all at once
+ */
 struct Tilemap {
   // types & enums constants
-  using Map = std::vector<std::vector<char>>;
   enum class Tiles : char {
     WALL_H = '-',
     WALL_V = '|',
@@ -32,9 +40,20 @@ struct Tilemap {
    */
   unsigned int n_rows;
   unsigned int n_cols;
-  Map map;
 
   Tilemap(const std::string& path);
+  Tiles get_tile(unsigned int i_row, unsigned int i_col) const;
+  bool has_wall_h(int i_row, int i_col) const;
+  bool has_wall_v(int i_row, int i_col) const;
+  std::string_view get_row(unsigned int i_row) const;
+  std::vector<glm::uvec2> find(Tiles tile, JobSystem& jobs) const;
+
+private:
+  MappedFile m_file;
+
+  /* start of each row in mapped file & its length without line ending (rows can be shorter than first one) */
+  std::vector<size_t> m_offsets_rows;
+  std::vector<unsigned int> m_lengths_rows;
 };
 
 #endif // TILEMAP_HPP
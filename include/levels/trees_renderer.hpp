@@ -3,28 +3,46 @@
 
 #include "factories/shaders_factory.hpp"
 #include "factories/textures_factory.hpp"
-#include "render/model_renderer.hpp"
+#include "loaders/assets_loader.hpp"
+#include "render/lod_renderer.hpp"
+#include "render/render_queue.hpp"
 #include "shader/uniforms.hpp"
 #include "navigation/frustum.hpp"
+#include "levels/visibility.hpp"
 
 /* Called from LevelRenderer to render trees props */
 class TreesRenderer {
 public:
-  TreesRenderer(const ShadersFactory& shaders_factory, const TexturesFactory& textures_factory, Assimp::Importer& importer);
-  void calculate_uniforms(const std::vector<glm::vec3>& positions);
-  void calculate_bboxes(const std::vector<glm::vec3>& positions);
-  void set_transform(const Transformation& t, const Frustum& frustum);
-  void draw(const Uniforms& uniforms);
+  /* per-instance data calculated from resident chunks off main thread (see `LevelRenderer`) */
+  struct Instances {
+    std::vector<glm::mat4> models;
+    std::vector<glm::mat4> normals_mats;
+    std::vector<BoundingBox> bboxes;
+    math::BVH bvh;
+
+    size_t get_size() const;
+  };
+
+  TreesRenderer(const ShadersFactory& shaders_factory, const TexturesFactory& textures_factory, AssetsLoader& assets_loader);
+  Instances calculate_instances(const std::vector<glm::vec3>& positions) const;
+  void set_instances(Instances& instances);
+  void cull(const Transformation& t, const Frustum& frustum, const Visibility& visibility, JobSystem& jobs);
+  void set_transform(const Transformation& t);
+  void submit(RenderQueue& queue, const Uniforms& uniforms, const glm::vec3& position_camera);
   void free();
 
 private:
-  ModelRenderer m_renderer;
+  LodRenderer m_renderer;
 
   /* Bounding box in local space & world space */
   BoundingBox m_bounding_box;
   std::vector<BoundingBox> m_bboxes;
+  math::BVH m_bvh;
+  FrustumCache m_cache_frustum;
+
+  /* visible instances on last frame (buffer reused between frames) */
+  std::vector<unsigned int> m_indices;
 
-  std::vector<glm::vec3> m_positions;
   std::vector<glm::mat4> m_models;
   std::vector<glm::mat4> m_normals_mats;
 };
@@ -0,0 +1,26 @@
+#ifndef VISIBILITY_HPP
+#define VISIBILITY_HPP
+
+#include <vector>
+
+#include "levels/pvs.hpp"
+#include "levels/portals.hpp"
+#include "math/bounding_box.hpp"
+#include "navigation/occlusion_buffer.hpp"
+#include "utils/job_system.hpp"
+
+/**
+ * Culling stages applied by level renderers after frustum culling (see `LevelRenderer::set_transform()`)
+ * Cheapest stage first: static PVS of camera's cell, rooms seen through portals, then occlusion by walls rasterized on cpu
+ * Only read by culling jobs (occlusion buffer filled beforehand), so it's shared by renderers culled in parallel
+ */
+struct Visibility {
+  const Pvs& pvs;
+  const Portals& portals;
+  OcclusionBuffer& occlusion;
+
+  bool is_visible(const BoundingBox& bbox) const;
+  void cull(const std::vector<unsigned int>& indices, const std::vector<BoundingBox>& bboxes, std::vector<unsigned int>& indices_out, JobSystem& jobs) const;
+};
+
+#endif // VISIBILITY_HPP
@@ -0,0 +1,15 @@
+#ifndef WALLS_MERGER_HPP
+#define WALLS_MERGER_HPP
+
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * Greedy merging of collinear adjacent walls boxes (one tile long) into runs drawn as a single box scaled along its length
+ * Cuts instances & bboxes of long walls (e.g. corridors), runs end at tiles without a wall (e.g. door or window)
+ */
+struct WallsMerger {
+  static std::vector<glm::mat4> merge(const std::vector<glm::mat4>& models, float length);
+};
+
+#endif // WALLS_MERGER_HPP
@@ -4,20 +4,35 @@
 #include <vector>
 
 #include "entries/wall_entry.hpp"
-#include "render/renderer.hpp"
+#include "render/instanced_renderer.hpp"
+#include "render/render_queue.hpp"
 #include "factories/shaders_factory.hpp"
 #include "factories/textures_factory.hpp"
 #include "navigation/frustum.hpp"
+#include "levels/visibility.hpp"
 
 /* Called from LevelRenderer to render walls */
 class WallsRenderer {
 public:
+  /* per-instance data of full walls & walls around windows calculated from resident chunks off main thread (see `LevelRenderer`) */
+  struct Instances {
+    std::vector<glm::mat4> models;
+    std::vector<glm::mat4> models_around_windows;
+    std::vector<BoundingBox> bboxes;
+    std::vector<BoundingBox> bboxes_around_windows;
+    math::BVH bvh;
+    math::BVH bvh_around_windows;
+
+    size_t get_size() const;
+  };
+
   WallsRenderer(const ShadersFactory& shaders_factory, const TexturesFactory& textures_factory);
-  void set_transform(const Transformation& t, const Frustum& frustum);
-  void calculate_uniforms(const std::vector<WallEntry>& entries, const std::vector<glm::vec3>& positions_windows);
-  void calculate_bboxes();
-  void draw();
-  void draw_walls_around_window();
+  void cull(const Frustum& frustum, const Visibility& visibility, JobSystem& jobs);
+  void set_transform(const Transformation& t);
+  Instances calculate_instances(const std::vector<WallEntry>& entries, const std::vector<glm::vec3>& positions_windows) const;
+  void set_instances(Instances& instances);
+  void submit(RenderQueue& queue, const glm::vec3& position_camera);
+  float raycast(const Ray& ray) const;
   void free();
 
 private:
@@ -39,19 +54,27 @@ private:
   /* Bounding box in local space & bboxes in world space */
   BoundingBox m_bbox, m_bbox_around_windows;
   std::vector<BoundingBox> m_bboxes, m_bboxes_around_windows;
+  math::BVH m_bvh, m_bvh_around_windows;
+  FrustumCache m_cache_frustum, m_cache_frustum_around_windows;
+
+  /* visible walls on last frame (buffers reused between frames) */
+  std::vector<unsigned int> m_indices, m_indices_around_windows;
 
   /* TODO: same renderer (shader, vao attributes) but with updated vbo */
-  Renderer m_renderer;
-  Renderer m_renderer_subwall;
+  InstancedRenderer m_renderer;
+  InstancedRenderer m_renderer_subwall;
 
   /* Texture3D was stretching without repeat */
   Texture2D m_texture;
 
-  std::array<glm::vec3, 2> calculate_offsets(const WallEntry& entry);
-  std::array<float, 2> calculate_angles(const WallEntry& entry);
-  void calculate_uniforms_full(const std::vector<WallEntry>& entries);
-  void calculate_uniforms_around_window(const std::vector<glm::vec3>& positions_windows);
-  std::vector<BoundingBox> calculate_bboxes_for(bool is_around_window);
+  /* referenced by packets until render queue is flushed */
+  Uniforms m_uniforms;
+
+  std::array<glm::vec3, 2> calculate_offsets(const WallEntry& entry) const;
+  std::array<float, 2> calculate_angles(const WallEntry& entry) const;
+  std::vector<glm::mat4> calculate_uniforms_full(const std::vector<WallEntry>& entries) const;
+  std::vector<glm::mat4> calculate_uniforms_around_window(const std::vector<glm::vec3>& positions_windows) const;
+  static std::vector<BoundingBox> calculate_bboxes_for(const std::vector<glm::mat4>& models, const BoundingBox& bbox_local);
 };
 
 #endif // WALLS_RENDERER_HPP
@@ -4,17 +4,30 @@
 #include "factories/shaders_factory.hpp"
 #include "factories/textures_factory.hpp"
 #include "math/bounding_box.hpp"
-#include "render/renderer.hpp"
+#include "render/instanced_renderer.hpp"
+#include "render/render_queue.hpp"
 #include "navigation/frustum.hpp"
+#include "levels/visibility.hpp"
 
 /* Window 2D sprite having an image as a texture */
 class WindowsRenderer {
 public:
+  /* per-instance data calculated from resident chunks off main thread (see `LevelRenderer`) */
+  struct Instances {
+    std::vector<glm::mat4> models;
+    std::vector<BoundingBox> bboxes;
+    math::BVH bvh;
+
+    size_t get_size() const;
+  };
+
   WindowsRenderer(const ShadersFactory& shaders_factory, const TexturesFactory& textures_factory);
-  void calculate_uniforms(const std::vector<glm::vec3>& positions_tiles);
-  void calculate_bboxes(const std::vector<glm::vec3>& positions_tiles);
-  void set_transform(const Transformation& t, const Frustum& frustum);
-  void draw();
+  Instances calculate_instances(const std::vector<glm::vec3>& positions_tiles) const;
+  void set_instances(Instances& instances);
+  void cull(const Frustum& frustum, const Visibility& visibility, JobSystem& jobs);
+  void set_transform(const Transformation& t);
+  const std::vector<BoundingBox>& get_bboxes() const;
+  void submit(RenderQueue& queue, const glm::vec3& position_camera);
   void free();
 
 private:
@@ -22,10 +35,18 @@ private:
   const glm::vec3 m_size = { 1, 1, 0 };
 
   Texture2D m_texture;
-  Renderer m_renderer;
+  InstancedRenderer m_renderer;
+
+  /* referenced by packets until render queue is flushed */
+  Uniforms m_uniforms;
 
   std::vector<glm::mat4> m_models;
   std::vector<BoundingBox> m_bboxes;
+  math::BVH m_bvh;
+  FrustumCache m_cache_frustum;
+
+  /* visible instances on last frame (buffer reused between frames) */
+  std::vector<unsigned int> m_indices;
 };
 
 #endif // WINDOWS_RENDERER_HPP
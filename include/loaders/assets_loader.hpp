@@ -0,0 +1,118 @@
+#ifndef ASSETS_LOADER_HPP
+#define ASSETS_LOADER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "texture/image.hpp"
+#include "models/model.hpp"
+#include "render/storage_renderer.hpp"
+
+/**
+ * Decodes images & imports 3d models on a pool of worker threads (no gl calls made there)
+ * `load_*()` queue an asset, `get_*()` wait for it & are called from gl thread to upload it
+ * so assets queued together load in parallel instead of one after another
+ * Also registry of models by path: each model imported once & shared by handle between its renderers,
+ * with its meshes uploaded once to gpu & freed with the last renderer releasing them
+ */
+class AssetsLoader {
+public:
+  /* meshes of a model on gpu (one vbo/vao each) & its materials without vertexes, shared by all renderers drawing it */
+  struct ModelMeshes {
+    assimp_utils::ModelHandle model;
+    std::vector<StorageRenderer> renderers;
+  };
+
+  /* uploads meshes of given model (called for the 1st renderer of model only) */
+  using Upload = std::function<std::vector<StorageRenderer>(const assimp_utils::Model& model)>;
+
+  AssetsLoader(unsigned int n_threads = std::thread::hardware_concurrency());
+  ~AssetsLoader();
+  void load_image(const std::string& path);
+  void load_model(const std::string& path);
+  void load_lods(const std::string& path, const std::vector<float>& ratios);
+  Image get_image(const std::string& path);
+  assimp_utils::ModelHandle get_model(const std::string& path);
+  assimp_utils::ModelHandle find_model(const std::string& key) const;
+  const ModelMeshes& acquire_meshes(const std::string& key, const Upload& upload);
+  void release_meshes(const std::string& key);
+  void release_vertexes();
+  void print_stats();
+
+  static std::string get_key_lod(const std::string& path, unsigned int lod);
+
+  AssetsLoader(const AssetsLoader&) = delete;
+  AssetsLoader& operator=(const AssetsLoader&) = delete;
+
+private:
+  /* start & end of asset's loading on worker thread in ms since loader's creation */
+  struct Timing {
+    std::string path;
+    double start;
+    double end;
+  };
+
+  /* meshes optimized on import (not loaded from cache), ACMR summed over their triangles */
+  struct StatsMeshes {
+    unsigned int n_meshes = 0;
+    size_t n_vertexes_before = 0;
+    size_t n_vertexes_after = 0;
+    size_t n_triangles = 0;
+    double n_misses_before = 0.0;
+    double n_misses_after = 0.0;
+  };
+
+  /* LODs simplified from imported models (triangles summed over all LODs) */
+  struct StatsLods {
+    unsigned int n_lods = 0;
+    size_t n_triangles_before = 0;
+    size_t n_triangles_after = 0;
+  };
+
+  std::vector<std::thread> m_threads;
+  std::chrono::steady_clock::time_point m_time_start;
+
+  /* jobs, timings & meshes/LODs stats shared with workers (guarded by mutex) */
+  std::deque<std::function<void()>> m_jobs;
+  std::vector<Timing> m_timings;
+  StatsMeshes m_stats_meshes;
+  StatsLods m_stats_lods;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  bool m_is_stopped;
+
+  /**
+   * model in registry: full model until vertexes are released, & its meshes on gpu with the # of renderers using them
+   * LODs don't own their textures (shared with model they were simplified from, freed with it)
+   */
+  struct EntryModel {
+    assimp_utils::ModelHandle model;
+    ModelMeshes meshes;
+    unsigned int n_renderers = 0;
+    bool is_owner_textures = true;
+  };
+
+  /* assets being loaded (only accessed from gl thread), path of model each LOD being loaded is simplified from, & models with their textures uploaded */
+  std::unordered_map<std::string, std::shared_future<Image>> m_images;
+  std::unordered_map<std::string, std::shared_future<std::shared_ptr<assimp_utils::Model>>> m_models;
+  std::unordered_map<std::string, std::string> m_lods;
+  std::unordered_map<std::string, EntryModel> m_models_uploaded;
+
+  template <typename T>
+  std::shared_future<T> submit(const std::string& path, std::function<T()> load);
+  void run();
+  double get_time() const;
+  void add_stats(const assimp_utils::Model& model);
+  void add_stats_lod(const assimp_utils::Model& model, const assimp_utils::Model& lod);
+};
+
+#endif // ASSETS_LOADER_HPP
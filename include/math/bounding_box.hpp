@@ -24,7 +24,9 @@ struct BoundingBox {
 
   bool check_collision(const BoundingBox& bounding_box);
   int check_collision(const std::vector<BoundingBox>& bounding_boxes);
-  bool intersects(const Ray& ray);
+  bool intersects(const Ray& ray) const;
+  bool intersects(const Ray& ray, float& distance) const;
+  static int raycast(const Ray& ray, const BoundingBox* bboxes, size_t n_bboxes, float& distance);
 
   /* Friend: non-member function that has access to class' private fields */
   friend std::ostream& operator<<(std::ostream& stream, const BoundingBox& bbox);
@@ -0,0 +1,30 @@
+#ifndef BOUNDING_BOXES_SOA_HPP
+#define BOUNDING_BOXES_SOA_HPP
+
+#include <vector>
+
+#include "math/bounding_box.hpp"
+
+/**
+ * Centers & half-diagonals of bboxes as structure of arrays (SoA) for SIMD frustum culling
+ * Arrays padded to a multiple of `WIDTH` so kernels don't need a scalar tail loop
+ */
+struct BoundingBoxesSoA {
+  /* # of floats in an AVX register */
+  static const unsigned int WIDTH = 8;
+
+  /* # of bboxes (without padding) */
+  size_t size;
+
+  std::vector<float> centers_x;
+  std::vector<float> centers_y;
+  std::vector<float> centers_z;
+  std::vector<float> half_diagonals_x;
+  std::vector<float> half_diagonals_y;
+  std::vector<float> half_diagonals_z;
+
+  BoundingBoxesSoA();
+  BoundingBoxesSoA(const std::vector<BoundingBox>& bboxes);
+};
+
+#endif // BOUNDING_BOXES_SOA_HPP
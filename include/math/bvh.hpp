@@ -0,0 +1,51 @@
+#ifndef BVH_HPP
+#define BVH_HPP
+
+#include <functional>
+#include <vector>
+
+#include "math/bounding_box.hpp"
+#include "math/ray.hpp"
+
+/**
+ * Static bounding volume hierarchy built once from tiles bboxes (in LevelRenderer's ctor)
+ * Used by Frustum to accept/reject whole subtrees instead of testing every tile,
+ * and for raycasting (shooting) without testing every target/wall
+ */
+namespace math {
+  struct BVHNode {
+    BoundingBox bbox;
+
+    /* range of items covered by node in `BVH::indices` (contiguous as items are partitioned in-place) */
+    unsigned int first;
+    unsigned int count;
+
+    /* index of left child (right child stored right after it), 0 for leaves as root can't be a child */
+    unsigned int left;
+
+    bool is_leaf() const;
+  };
+
+  struct BVH {
+    /* max # of items in a leaf & max depth of tree (median split => depth ~ log2(n_items)) */
+    static const unsigned int MAX_LEAF_SIZE = 4;
+    static const unsigned int MAX_DEPTH = 64;
+
+    std::vector<BVHNode> nodes;
+
+    /* indices of items in caller's vector & their bboxes, both sorted in tree order */
+    std::vector<unsigned int> indices;
+    std::vector<BoundingBox> bboxes;
+
+    BVH() = default;
+    BVH(const std::vector<BoundingBox>& bboxes_items);
+    int raycast(const Ray& ray, float& distance, const std::function<bool(unsigned int)>& is_ignored = nullptr) const;
+    size_t get_size() const;
+
+  private:
+    void build(unsigned int i_node, const std::vector<BoundingBox>& bboxes_items);
+    BoundingBox calculate_bbox(unsigned int first, unsigned int count, const std::vector<BoundingBox>& bboxes_items) const;
+  };
+}
+
+#endif // BVH_HPP
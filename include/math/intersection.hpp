@@ -0,0 +1,11 @@
+#ifndef INTERSECTION_HPP
+#define INTERSECTION_HPP
+
+/* Position of a bbox rel. to a volume (e.g. frustum) */
+enum class Intersection {
+  OUTSIDE,
+  INSIDE,
+  INTERSECTING,
+};
+
+#endif // INTERSECTION_HPP
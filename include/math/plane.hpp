@@ -19,6 +19,7 @@ namespace math {
     float get_signed_distance(const glm::vec3& point) const;
     bool is_in_front_of_plane(const glm::vec3& point) const;
     bool is_in_front_of_plane(const BoundingBox& bbox) const;
+    bool is_fully_in_front_of_plane(const BoundingBox& bbox) const;
   };
 }
 
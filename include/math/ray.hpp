@@ -7,6 +7,12 @@ struct Ray {
   glm::vec3 origin;
   glm::vec3 direction;
 
+  /* precomputed for slab test (inf on axes parallel to ray) */
+  glm::vec3 inverse_direction;
+
+  /* direction has a zero component (slab test then checks for origin on planes of slabs parallel to ray) */
+  bool has_parallel_axis;
+
   Ray(const glm::vec3& orig, const glm::vec3& dir);
 };
 
@@ -0,0 +1,33 @@
+#ifndef SPATIAL_GRID_HPP
+#define SPATIAL_GRID_HPP
+
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * Uniform grid of points (e.g. walls centers) bucketed by their cell on the horizontal xz-plane
+ * Built once from tilemap (in LevelRenderer's ctor), then queried by moving agents (e.g. camera)
+ * by only inspecting the 3x3 cells around them (no allocation per query)
+ */
+namespace math {
+  struct SpatialGrid {
+    SpatialGrid();
+    SpatialGrid(const std::vector<glm::vec3>& points, float cell_size);
+    bool is_close_to(const glm::vec3& position, float distance) const;
+
+  private:
+    /* cells are squares of side `m_cell_size` (>= max query distance for 3x3 cells to be enough) */
+    float m_cell_size;
+    glm::ivec2 m_origin;
+    unsigned int m_n_cols;
+    unsigned int m_n_rows;
+
+    /* points sorted by cell & offsets of each cell in them (cell i covers [offsets[i], offsets[i+1]) */
+    std::vector<glm::vec3> m_points;
+    std::vector<unsigned int> m_offsets;
+
+    glm::ivec2 get_cell(const glm::vec3& position) const;
+  };
+}
+
+#endif // SPATIAL_GRID_HPP
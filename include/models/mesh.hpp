@@ -1,10 +1,12 @@
 #ifndef MESH_HPP
 #define MESH_HPP
 
+#include <string>
 #include <vector>
 #include <glm/glm.hpp>
 #include <assimp/mesh.h>
 
+#include "models/mesh_optimizer.hpp"
 #include "texture/texture_2d.hpp"
 #include "shader/uniforms.hpp"
 
@@ -16,12 +18,18 @@
  */
 namespace assimp_utils {
   struct Mesh {
+    /* floats (11 per vertex) or `VertexQuantized` stored bitwise */
     std::vector<float> vertexes;
     std::vector<unsigned int> indices;
 
-    /* used to calculate bounding box for 3d model (for collision detection) */
+    /* mesh's bbox corners used to calculate bounding box for 3d model (for collision detection) */
     std::vector<glm::vec3> positions;
 
+    /* quantized positions decoded in shader relative to mesh's bbox */
+    bool is_quantized = false;
+    glm::vec3 position_min;
+    glm::vec3 position_extent;
+
     unsigned int material;
     glm::vec3 color;
     Texture2D texture_diffuse;
@@ -31,15 +39,28 @@ namespace assimp_utils {
     bool has_texture_diffuse;
     bool has_texture_normal;
 
+    /* images paths relative to model's directory (kept to load textures from mesh cache) */
+    std::string filename_texture_diffuse;
+    std::string filename_texture_normal;
+
+    /* optimization done on import, reported by assets loader (zero vertexes when loaded from mesh cache) */
+    MeshOptimizer::Stats stats_optimizer = {};
+
     /* Default constructor needed by std::vector::resize() (`= default` => ctor defined by compiler) */
     Mesh() = default;
-    Mesh(aiMesh* mesh);
-    void set_uniforms(Uniforms& uniforms);
+    Mesh(aiMesh* mesh, bool quantize=false);
+    void set_uniforms(Uniforms& uniforms) const;
+    Mesh simplify(float ratio) const;
+    Mesh get_materials() const;
+    std::vector<glm::vec3> get_positions_vertexes() const;
 
   private:
     aiMesh* m_mesh;
+    void set_bounds();
     void set_vertexes();
+    void set_vertexes_quantized();
     void set_indices();
+    void optimize();
   };
 }
 
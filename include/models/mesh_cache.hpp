@@ -0,0 +1,28 @@
+#ifndef MESH_CACHE_HPP
+#define MESH_CACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "models/mesh.hpp"
+
+/**
+ * Cooked binary copy of meshes parsed by Assimp (vertexes, indices, positions, colors & textures filenames)
+ * Written next to model (e.g. `sniper.obj.mesh`) on first load, then memory-mapped on next launches
+ * to copy each array in one go instead of parsing the .obj again
+ * Cache is stale (ignored & overwritten) when model or a material library it references (`mtllib`) is newer,
+ * or when format version or vertexes layout (floats or quantized) changes
+ */
+namespace assimp_utils {
+  struct MeshCache {
+    static const uint32_t MAGIC = 0x4853454d; // "MESH" in little-endian
+    static const uint32_t VERSION = 4;
+
+    static std::string get_path(const std::string& path_model);
+    static bool load(const std::string& path_model, std::vector<Mesh>& meshes, bool is_quantized);
+    static bool save(const std::string& path_model, const std::vector<Mesh>& meshes);
+  };
+}
+
+#endif // MESH_CACHE_HPP
@@ -0,0 +1,38 @@
+#ifndef MESH_OPTIMIZER_HPP
+#define MESH_OPTIMIZER_HPP
+
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * Optimization pass run on meshes after their import (results saved in mesh cache):
+ * 1. welding of identical vertexes (Assimp's .obj importer duplicates vertexes for each face)
+ * 2. triangles reordered for post-transform vertex cache with Tipsify
+ * 3. clusters of triangles sorted to draw outward-facing ones first (less overdraw)
+ * 4. vertexes reordered by first use in indices (sequential vertex fetches)
+ * Sander et al. 2007: https://gfx.cs.princeton.edu/pubs/Sander_2007_%3ETR/tipsy.pdf
+ */
+namespace assimp_utils {
+  struct MeshOptimizer {
+    /* Average cache miss ratio (# of vertex shader invocations per triangle), 0.5 at best & 3 at worst */
+    struct Stats {
+      unsigned int n_vertexes_before;
+      unsigned int n_vertexes_after;
+      float acmr_before;
+      float acmr_after;
+    };
+
+    static const unsigned int CACHE_SIZE = 16;
+
+    static Stats optimize(std::vector<float>& vertexes, std::vector<unsigned int>& indices, std::vector<glm::vec3>& positions);
+    static float get_acmr(const std::vector<unsigned int>& indices, unsigned int n_vertexes, unsigned int cache_size=CACHE_SIZE);
+
+  private:
+    static void weld(std::vector<float>& vertexes, std::vector<unsigned int>& indices, std::vector<glm::vec3>& positions);
+    static std::vector<unsigned int> reorder_tipsify(std::vector<unsigned int>& indices, unsigned int n_vertexes);
+    static void reorder_clusters(std::vector<unsigned int>& indices, const std::vector<unsigned int>& boundaries, const std::vector<glm::vec3>& positions);
+    static void reorder_vertexes(std::vector<float>& vertexes, std::vector<unsigned int>& indices, std::vector<glm::vec3>& positions);
+  };
+}
+
+#endif // MESH_OPTIMIZER_HPP
@@ -0,0 +1,19 @@
+#ifndef MESH_SIMPLIFIER_HPP
+#define MESH_SIMPLIFIER_HPP
+
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * Quadric error metric simplification (Garland & Heckbert 1997) used to generate levels of detail
+ * Edges collapsed onto one of their existing vertexes (only indices change, so vertexes buffer can be shared)
+ * Vertexes on borders or attributes seams (e.g. uv discontinuities) are never removed to keep silhouette & texturing
+ * https://www.cs.cmu.edu/~garland/Papers/quadrics.pdf
+ */
+namespace assimp_utils {
+  struct MeshSimplifier {
+    static std::vector<unsigned int> simplify(const std::vector<unsigned int>& indices, const std::vector<glm::vec3>& positions, unsigned int n_indices_target);
+  };
+}
+
+#endif // MESH_SIMPLIFIER_HPP
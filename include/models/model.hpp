@@ -1,6 +1,7 @@
 #ifndef MODEL_HPP
 #define MODEL_HPP
 
+#include <memory>
 #include <unordered_map>
 #include <assimp/scene.h>
 #include <assimp/Importer.hpp>
@@ -10,30 +11,48 @@
 /**
  * Wrapper struct around Assimp::aiScene class
  * Serves as parent of all meshes inside scene (i.e. 3D model in *.obj format)
+ * Meshes read from binary cache when up to date (see `MeshCache`), otherwise parsed with Assimp
  * Namespace to avoid confusion with `entities/Model`
  */
 namespace assimp_utils {
   struct Model {
     std::vector<assimp_utils::Mesh> meshes;
 
-    Model(const std::string& path, Assimp::Importer& importer);
-    void free();
+    Model(const std::string& path, Assimp::Importer& importer, bool quantize=true);
+    void upload_textures();
+    void share_textures(const Model& model);
+    Model get_lod(float ratio) const;
+    Model get_materials() const;
+    void free() const;
 
   private:
+    /* only used by `get_lod()` & `get_materials()` (fields set one by one) */
+    Model() = default;
+
     const aiScene* m_scene;
 
     /* Path to model to load & directory from it to get texture images */
     std::string m_path;
     std::string m_directory;
 
+    /* pack vertexes in compact format (see `VertexQuantized`) */
+    bool m_is_quantized;
+
     /* Optimization: avoid loading a texture image more than once (as it's quite costly) */
+    std::unordered_map<std::string, Image> m_images;
     std::unordered_map<std::string, Texture2D> m_textures_loaded;
 
     bool load_scene(Assimp::Importer& importer);
+    void parse_scene(Assimp::Importer& importer);
     void set_mesh_color(aiMaterial* material, unsigned int index);
-    void set_mesh_texture(aiMaterial* material, unsigned int index, aiTextureType type);
-    void load_textures(aiMaterial* material, unsigned int index);
+    void set_mesh_textures(aiMaterial* material, unsigned int index);
+    void load_image(const std::string& filename);
+    void load_textures(unsigned int index);
+    Texture2D load_texture(const std::string& filename, GLenum texture_unit);
   };
+
+  /* Immutable model shared by renderers drawing it (imported once per path by `AssetsLoader`) */
+  using ModelHandle = std::shared_ptr<const Model>;
 }
 
 #endif // MODEL_HPP
@@ -0,0 +1,30 @@
+#ifndef VERTEX_QUANTIZED_HPP
+#define VERTEX_QUANTIZED_HPP
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+/**
+ * Compact vertex (20 bytes instead of 11 floats = 44 bytes) decoded in `texture_mesh.vert`
+ * - position: normalized 16-bit integers relative to mesh's bbox
+ * - normal & tangent: octahedral encoding in normalized 16-bit integers
+ * - texture coord: half floats
+ * Stored bitwise in `Mesh::vertexes` (vbo only takes floats), attributes formats set by `ModelRenderer`
+ */
+namespace assimp_utils {
+  struct VertexQuantized {
+    uint16_t position[3];
+    uint16_t padding;
+    int16_t normal[2];
+    int16_t tangent[2];
+    uint16_t texture_coord[2];
+
+    VertexQuantized(const glm::vec3& p, const glm::vec3& n, const glm::vec2& uv, const glm::vec3& t,
+                    const glm::vec3& position_min, const glm::vec3& position_extent);
+    static glm::vec2 encode_octahedral(const glm::vec3& direction);
+  };
+
+  static_assert(sizeof(VertexQuantized) % sizeof(float) == 0, "packed vertexes stored as floats");
+}
+
+#endif // VERTEX_QUANTIZED_HPP
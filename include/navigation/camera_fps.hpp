@@ -5,13 +5,14 @@
 #include <glm/glm.hpp>
 #include <vector>
 
+#include "math/spatial_grid.hpp"
 #include "navigation/camera.hpp"
 #include "navigation/direction.hpp"
 #include "navigation/zoom.hpp"
 
 struct CameraFPS : public Camera {
-  /* boundaries of level (i.e. position of walls) */
-  std::vector<glm::vec3> boundaries;
+  /* boundaries of level (i.e. position of walls) bucketed in a grid */
+  math::SpatialGrid boundaries;
 
   /* for a continuous jumping/falling */
   bool is_jumping;
@@ -22,6 +23,7 @@ struct CameraFPS : public Camera {
   void rotate(float x_offset, float y_offset);
   void zoom(Zoom z);
   void update();
+  void set_boundaries(const std::vector<glm::vec3>& positions_walls);
 
 private:
   // camera movements constants
@@ -34,6 +36,9 @@ private:
   const float MIN_Y = 2.0f;
   const float MAX_Y = 3.0f;
 
+  // min distance to walls centers (also size of boundaries grid cells)
+  const float DISTANCE_BOUNDARIES = 1.2f;
+
   // direction of movement
   glm::vec3 m_forward_dir;
 
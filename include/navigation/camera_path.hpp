@@ -0,0 +1,22 @@
+#ifndef CAMERA_PATH_HPP
+#define CAMERA_PATH_HPP
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "navigation/camera.hpp"
+
+/**
+ * Camera keyframes (position & look direction) parsed from a text file (e.g. `assets/paths/flythrough.txt`)
+ * Used to fly camera through level in headless mode (same path on every run)
+ */
+struct CameraPath {
+  std::vector<glm::vec3> positions;
+  std::vector<glm::vec3> directions;
+
+  CameraPath(const std::string& path);
+  void set_camera(Camera& camera, float t) const;
+};
+
+#endif // CAMERA_PATH_HPP
@@ -2,16 +2,22 @@
 #ifndef FRUSTUM_HPP
 #define FRUSTUM_HPP
 
+#include <array>
 #include <vector>
 
 #include "math/bounding_box.hpp"
+#include "math/bounding_boxes_soa.hpp"
+#include "math/bvh.hpp"
+#include "math/intersection.hpp"
 #include "math/plane.hpp"
 #include "navigation/camera.hpp"
+#include "navigation/frustum_cache.hpp"
 
 class Frustum {
 public:
   Frustum(float n, float f, float aspect);
   void calculate_planes(const Camera& camera);
+  Frustum narrow(const glm::mat4& view_projection, const glm::vec4& rect) const;
   void print_planes();
 
   template <typename T>
@@ -20,6 +26,22 @@ public:
   template <typename T>
   std::vector<T> cull(const std::vector<T>& arr, const std::vector<BoundingBox>& bboxes) const;
 
+  Intersection intersect(const BoundingBox& bbox) const;
+  std::vector<unsigned int> cull(const math::BVH& bvh) const;
+  const std::vector<unsigned int>& cull(const math::BVH& bvh, FrustumCache& cache) const;
+
+  template <typename T>
+  std::vector<T> cull(const std::vector<T>& arr, const math::BVH& bvh) const;
+
+  /**
+   * SIMD culling of SoA bboxes (AVX2 if supported by cpu, SSE2 otherwise) into caller's `indices`
+   * For flat lists without hierarchy (static level tiles are culled faster through their BVH, see frustum_culling_simd benchmark)
+   */
+  void cull(const BoundingBoxesSoA& bboxes, std::vector<unsigned int>& indices) const;
+  void cull_sse2(const BoundingBoxesSoA& bboxes, std::vector<unsigned int>& indices) const;
+  void cull_avx2(const BoundingBoxesSoA& bboxes, std::vector<unsigned int>& indices) const;
+  static bool has_avx2();
+
 private:
   float near;
   float far;
@@ -31,6 +53,14 @@ private:
   math::Plane bottom_plane;
   math::Plane near_plane;
   math::Plane far_plane;
+
+  std::array<const math::Plane*, 6> get_planes() const;
+  std::array<glm::vec3, 8> get_corners() const;
+  bool is_within(const std::array<math::Plane, 6>& planes) const;
+  Intersection intersect(const BoundingBox& bbox, unsigned char& mask, unsigned char& plane_first, FrustumCache::Stats& stats) const;
+  bool is_inside(const BoundingBox& bbox, unsigned char mask, unsigned char& plane_first, FrustumCache::Stats& stats) const;
+  void cull(const math::BVH& bvh, unsigned char* planes_nodes, unsigned char* planes_items, FrustumCache::Stats& stats, std::vector<unsigned int>& indices) const;
+  void cull_scalar(const BoundingBoxesSoA& bboxes, std::vector<unsigned int>& indices) const;
 };
 
 #endif // FRUSTUM_HPP
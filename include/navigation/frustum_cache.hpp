@@ -0,0 +1,40 @@
+#ifndef FRUSTUM_CACHE_HPP
+#define FRUSTUM_CACHE_HPP
+
+#include <array>
+#include <vector>
+
+#include "math/plane.hpp"
+
+/**
+ * Frustum culling of a BVH kept between frames (temporal coherence), owned by its caller & passed to `Frustum::cull()`
+ * Culling skipped while frustum stays inside the slightly larger one items were culled with (same camera pose & fov,
+ * or slow turn/walk), otherwise plane which rejected each node/item on last cull tested first (likely to reject it again)
+ * Must be invalidated when BVH is rebuilt
+ */
+struct FrustumCache {
+  /* # of culls skipped (0 or 1 per cull), of plane-bbox tests & of bboxes rejected by plane tested first */
+  struct Stats {
+    unsigned int n_skipped = 0;
+    unsigned int n_tests = 0;
+    unsigned int n_early_outs = 0;
+  };
+
+  /* visible items on last cull */
+  std::vector<unsigned int> indices;
+
+  /* index of last rejecting plane (in `Frustum::get_planes()`) for each BVH node & each item in tree order */
+  std::vector<unsigned char> planes_nodes;
+  std::vector<unsigned char> planes_items;
+
+  /* frustum planes (pushed outward) `indices` were culled with */
+  std::array<math::Plane, 6> planes;
+  bool is_valid = false;
+
+  /* stats of last cull */
+  Stats stats;
+
+  void invalidate();
+};
+
+#endif // FRUSTUM_CACHE_HPP
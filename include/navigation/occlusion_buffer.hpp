@@ -0,0 +1,55 @@
+#ifndef OCCLUSION_BUFFER_HPP
+#define OCCLUSION_BUFFER_HPP
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "math/bounding_box.hpp"
+
+/**
+ * Software occlusion culling: low-resolution depth buffer rasterized on the cpu from large occluders (walls boxes),
+ * then instances bboxes tested against it before their matrices are uploaded
+ * Conservative: occluders only cover pixels they fully cover with their farthest depth over the pixel,
+ * & bboxes are hidden only if their nearest depth is behind every pixel of their screen rectangle
+ * Rows of 4 pixels rasterized & tested at once with SSE2 (scalar fallback on other architectures)
+ * Once occluders are rasterized, bboxes can be tested from several threads (e.g. culling jobs)
+ */
+class OcclusionBuffer {
+public:
+  static constexpr unsigned int WIDTH = 256;
+  static constexpr unsigned int HEIGHT = 128;
+
+  /* occluders rasterized & bboxes tested/occluded since last `clear()` */
+  struct Stats {
+    unsigned int n_occluders = 0;
+    unsigned int n_tests = 0;
+    unsigned int n_occluded = 0;
+  };
+
+  OcclusionBuffer();
+  void clear(const glm::mat4& view, const glm::mat4& projection);
+  void rasterize(const BoundingBox& bbox);
+  bool is_visible(const BoundingBox& bbox);
+  void cull(std::vector<unsigned int>& indices, const std::vector<BoundingBox>& bboxes);
+  Stats get_stats() const;
+  bool save(const std::string& path) const;
+
+private:
+  /* view distance of nearest occluder at each pixel (rows from bottom to top) */
+  std::vector<float> m_depths;
+
+  glm::mat4 m_view_projection;
+  glm::vec3 m_position_camera;
+
+  /* counted from culling jobs (see `Stats`) */
+  unsigned int m_n_occluders;
+  std::atomic<unsigned int> m_n_tests;
+  std::atomic<unsigned int> m_n_occluded;
+
+  void rasterize_polygon(const glm::vec4* vertexes, unsigned int n_vertexes);
+  glm::vec3 project(const glm::vec4& clip) const;
+};
+
+#endif // OCCLUSION_BUFFER_HPP
@@ -0,0 +1,32 @@
+#ifndef DRAW_STATS_HPP
+#define DRAW_STATS_HPP
+
+#include <atomic>
+
+/**
+ * Draw calls & instances issued by renderers, instances hidden by occlusion culling,
+ * & frustum culls skipped or plane tests (rejections by last rejecting plane) since last reset (written per frame in headless mode)
+ * State changes: program, texture & vao changes between consecutive draws of the render queue (see `RenderQueue`)
+ */
+struct DrawStats {
+  unsigned int n_draw_calls = 0;
+  unsigned int n_instances = 0;
+  unsigned int n_occlusion_tests = 0;
+  unsigned int n_occluded = 0;
+  unsigned int n_changes_programs = 0;
+  unsigned int n_changes_textures = 0;
+  unsigned int n_changes_vaos = 0;
+
+  /* added by culling jobs on several threads */
+  std::atomic<unsigned int> n_culls_skipped { 0 };
+  std::atomic<unsigned int> n_plane_tests { 0 };
+  std::atomic<unsigned int> n_early_outs { 0 };
+
+  void add(unsigned int n_instances_draw);
+  void add_occlusion(unsigned int n_tests, unsigned int n_occluded_tests);
+  void add_culling(unsigned int n_skipped, unsigned int n_tests, unsigned int n_early_outs_tests);
+  void add_state_changes(unsigned int n_programs, unsigned int n_textures, unsigned int n_vaos);
+  void reset();
+};
+
+#endif // DRAW_STATS_HPP
@@ -0,0 +1,82 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Scoped zones (nestable, from any thread) recorded only when built with `PROFILING` defined
+ * otherwise macros expand to nothing (no overhead)
+ * e.g. `PROFILE_ZONE("LevelRenderer::set_transform");` at the top of a scope
+ */
+#ifdef PROFILING
+  #define PROFILE_CONCAT_IMPL(a, b) a##b
+  #define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+  #define PROFILE_ZONE(name) ProfilerZone PROFILE_CONCAT(profiler_zone_, __LINE__)(name)
+#else
+  #define PROFILE_ZONE(name)
+#endif
+
+/* Zone recorded when it ends (start & end in ns since profiler's epoch), name must outlive profiler (literal) */
+struct ProfilerEvent {
+  const char* name;
+  uint64_t start;
+  uint64_t end;
+};
+
+/* Event in ring buffer, fields atomic as slot can be overwritten while exporter copies it (plain moves on x86) */
+struct ProfilerSlot {
+  std::atomic<const char*> name;
+  std::atomic<uint64_t> start;
+  std::atomic<uint64_t> end;
+};
+
+/**
+ * Ring buffer of events written by one thread only (no lock), oldest events overwritten when full
+ * `n_events` published after event is written, so reader only sees complete events
+ * & can tell which ones were overwritten while it copied them (seqlock)
+ */
+struct ProfilerThread {
+  static const size_t CAPACITY = 1 << 16;
+
+  unsigned int id;
+  std::unique_ptr<std::array<ProfilerSlot, CAPACITY>> events;
+  std::atomic<uint64_t> n_events;
+
+  ProfilerThread(unsigned int id_thread);
+  void push(const ProfilerEvent& event);
+  std::vector<ProfilerEvent> get_events();
+};
+
+/* Collects events from threads buffers & exports them in Chrome trace event format (chrome://tracing or Perfetto) */
+class Profiler {
+public:
+  static uint64_t now();
+  static ProfilerThread& get_thread();
+  static bool export_chrome_trace(const std::string& path);
+
+private:
+  /* buffers outlive their threads (so events from finished threads are exported), mutex only locked on registration & export */
+  static std::vector<std::unique_ptr<ProfilerThread>> m_threads;
+  static std::mutex m_mutex;
+};
+
+/* RAII: zone starts on construction & is recorded on destruction (end of scope) */
+class ProfilerZone {
+public:
+  ProfilerZone(const char* name);
+  ~ProfilerZone();
+
+private:
+  /* thread's buffer retrieved before starting zone (registration not included in 1st zone's duration) */
+  ProfilerThread& m_thread;
+  const char* m_name;
+  uint64_t m_start;
+};
+
+#endif // PROFILER_HPP
@@ -0,0 +1,61 @@
+#ifndef INSTANCE_BUFFER_HPP
+#define INSTANCE_BUFFER_HPP
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+/**
+ * Shader storage buffer (SSBO) with per-instance data indexed by `gl_InstanceID` in instancing shaders
+ * Replaces uniform arrays whose size was capped at compile-time by MAX_N_INSTANCES
+ * Binding point must match `layout (std430, binding = ...)` in shaders
+ */
+class InstanceBuffer {
+public:
+  InstanceBuffer(GLuint binding);
+  void upload(const std::vector<glm::mat4>& data);
+  void upload(const std::vector<glm::vec3>& data);
+  void upload(const std::vector<unsigned int>& data);
+  void upload(const std::vector<glm::mat4>& data, const std::vector<unsigned int>& indices);
+  void upload(const std::vector<glm::vec3>& data, const std::vector<unsigned int>& indices);
+  void upload(const std::vector<unsigned int>& data, const std::vector<unsigned int>& indices);
+  void bind() const;
+  void free();
+
+private:
+  GLuint m_id;
+  GLuint m_binding;
+
+  /* size of data store in bytes (only reallocated when it grows) & of last uploaded data */
+  size_t m_capacity;
+  size_t m_size;
+
+  void upload(const void* data, size_t size);
+
+  template <typename TData, typename TBuffer>
+  void gather(const std::vector<TData>& data, const std::vector<unsigned int>* indices);
+};
+
+/**
+ * Per-instance buffers read by instancing shaders, with their binding points:
+ * models (0), normals_mats (1), colors (2), textures_indices (3)
+ */
+struct InstanceBuffers {
+  InstanceBuffers();
+
+  template <typename T>
+  void upload(const std::string& name, const std::vector<T>& data);
+
+  template <typename T>
+  void upload(const std::string& name, const std::vector<T>& data, const std::vector<unsigned int>& indices);
+
+  void bind() const;
+  void free();
+
+private:
+  std::unordered_map<std::string, InstanceBuffer> m_buffers;
+};
+
+#endif // INSTANCE_BUFFER_HPP
@@ -0,0 +1,80 @@
+#ifndef INSTANCED_RENDERER_HPP
+#define INSTANCED_RENDERER_HPP
+
+#include "render/storage_renderer.hpp"
+#include "render/instance_buffer.hpp"
+#include "globals/draw_stats.hpp"
+
+/**
+ * Renderer whose per-instance data (models/normals matrices, colors, textures indices)
+ * is uploaded to shader storage buffers instead of uniform arrays, so one instanced draw
+ * isn't capped by the size of these arrays in shaders
+ */
+class InstancedRenderer : public StorageRenderer {
+public:
+  InstancedRenderer(const Program& program, const Geometry& geometry, const std::vector<Attribute>& attributes, bool is_text=false);
+  void set_transform(const Transformation& t);
+  void set_transform(const Transformation& t, const std::vector<glm::mat4>& models, const std::vector<unsigned int>& indices);
+
+  template <typename T>
+  void set_instance_arr(const std::string& name, const std::vector<T>& u);
+
+  template <typename T>
+  void set_instance_arr(const std::string& name, const std::vector<T>& u, const std::vector<unsigned int>& indices);
+
+  /* bind instances buffers then delegate to Renderer (forwards its optional args) */
+  template <typename... Args>
+  void draw(const Uniforms& u={}, Args... args);
+
+  template <typename... Args>
+  void draw_lines(const Uniforms& u, Args... args);
+
+  template <typename... Args>
+  void draw_with_outlines(const Uniforms& u, Args... args);
+
+  GLuint get_program() const;
+  void free();
+
+private:
+  InstanceBuffers m_buffers;
+
+  /* program drawn with (in keys of render queue's packets) */
+  GLuint m_id_program;
+};
+
+template <typename T>
+void InstancedRenderer::set_instance_arr(const std::string& name, const std::vector<T>& u) {
+  m_buffers.upload(name, u);
+}
+
+/* Only elements of `u` at `indices` (e.g. visible instances) uploaded */
+template <typename T>
+void InstancedRenderer::set_instance_arr(const std::string& name, const std::vector<T>& u, const std::vector<unsigned int>& indices) {
+  m_buffers.upload(name, u, indices);
+}
+
+template <typename... Args>
+void InstancedRenderer::draw(const Uniforms& u, Args... args) {
+  m_buffers.bind();
+  Renderer::draw(u, args...);
+  draw_stats.add(m_n_instances);
+}
+
+template <typename... Args>
+void InstancedRenderer::draw_lines(const Uniforms& u, Args... args) {
+  m_buffers.bind();
+  Renderer::draw_lines(u, args...);
+  draw_stats.add(m_n_instances);
+}
+
+template <typename... Args>
+void InstancedRenderer::draw_with_outlines(const Uniforms& u, Args... args) {
+  m_buffers.bind();
+  Renderer::draw_with_outlines(u, args...);
+
+  // two passes (object then its scaled-up outline)
+  draw_stats.add(m_n_instances);
+  draw_stats.add(m_n_instances);
+}
+
+#endif // INSTANCED_RENDERER_HPP
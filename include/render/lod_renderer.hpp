@@ -0,0 +1,38 @@
+#ifndef LOD_RENDERER_HPP
+#define LOD_RENDERER_HPP
+
+#include "render/model_renderer.hpp"
+
+/**
+ * Instances of a 3D model drawn with a level of detail (LOD) matching their size on screen
+ * LODs generated by assets loader's workers by simplifying model's meshes (see `MeshSimplifier`),
+ * instances bucketed by LOD so each LOD is still one instanced draw per mesh
+ */
+class LodRenderer {
+public:
+  LodRenderer(const Program& program, AssetsLoader& assets_loader, const std::string& path, const std::vector<Attribute>& attributes);
+  void select_lods(const Transformation& transformation, const std::vector<glm::mat4>& models, const std::vector<unsigned int>& indices);
+  void set_transform(const Transformation& transformation, const std::vector<glm::mat4>& models, const std::vector<glm::mat4>& normals_mats);
+  void draw(const Uniforms& u={});
+  void submit(RenderQueue& queue, const DrawState& state, const Uniforms& u);
+  void free();
+
+  std::vector<glm::vec3> get_positions();
+  static void load(AssetsLoader& assets_loader, const std::string& path);
+
+private:
+  /* one renderer per LOD, from full model to coarsest */
+  std::vector<ModelRenderer> m_renderers;
+
+  /* bounding sphere in local space */
+  glm::vec3 m_center;
+  float m_radius;
+
+  /* LOD of each instance on last frame (kept for hysteresis) & instances drawn with each LOD (reused each frame) */
+  std::vector<unsigned int> m_lods;
+  std::vector<std::vector<unsigned int>> m_indices_lods;
+
+  unsigned int select_lod(unsigned int lod_previous, float size) const;
+};
+
+#endif // LOD_RENDERER_HPP
@@ -1,8 +1,11 @@
 #ifndef MODEL_RENDERER_HPP
 #define MODEL_RENDERER_HPP
 
+#include "loaders/assets_loader.hpp"
 #include "models/model.hpp"
-#include "render/renderer.hpp"
+#include "render/storage_renderer.hpp"
+#include "render/instance_buffer.hpp"
+#include "render/render_queue.hpp"
 
 /**
  * Each mesh inside 3D model is rendered separately using `Renderer` class,
@@ -10,18 +13,39 @@
  */
 struct ModelRenderer {
   /* used by class `entities/Player` & `entities/Target` to calculate bbox */
-  std::vector<Renderer> renderers;
+  std::vector<StorageRenderer> renderers;
 
-  ModelRenderer(const Program& program, const assimp_utils::Model& model, const std::vector<Attribute>& attributes);
+  ModelRenderer(const Program& program, AssetsLoader& assets_loader, const std::string& path, const std::vector<Attribute>& attributes);
   void draw(const Uniforms& u={}, bool with_outlines=false);
+  void submit(RenderQueue& queue, DrawState state, const Uniforms& u);
   void set_transform(const Transformation& transformation);
-  void set_uniform_arr(const std::string& name, const std::vector<glm::mat4>& u);
+  void set_transform(const Transformation& transformation, const std::vector<glm::mat4>& models, const std::vector<unsigned int>& indices);
+  void set_instance_arr(const std::string& name, const std::vector<glm::mat4>& u);
+  void set_instance_arr(const std::string& name, const std::vector<glm::mat4>& u, const std::vector<unsigned int>& indices);
   void free();
 
   std::vector<glm::vec3> get_positions();
 
 private:
-  assimp_utils::Model m_model;
+  /* registry sharing model's meshes on gpu with other renderers (released on `free()`) & key of model in it */
+  AssetsLoader* m_assets_loader;
+  std::string m_path;
+
+  /* materials of model's meshes (without vertexes), shared with other renderers */
+  assimp_utils::ModelHandle m_model;
+
+  /* per-instance data shared by all meshes (uploaded once instead of for each mesh) */
+  InstanceBuffers m_buffers;
+
+  /* # of instances from last transformation (for draw stats) */
+  unsigned int m_n_instances;
+
+  /* program drawn with (in keys of render queue's packets) */
+  GLuint m_id_program;
+
+  void draw_mesh(size_t i_mesh, const Uniforms& u);
+  static std::vector<StorageRenderer> upload(const Program& program, const assimp_utils::Model& model, const std::vector<Attribute>& attributes);
+  static void set_attributes_quantized(Renderer& renderer);
 };
 
 #endif // MODEL_RENDERER_HPP
@@ -0,0 +1,87 @@
+#ifndef RENDER_QUEUE_HPP
+#define RENDER_QUEUE_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "math/bounding_box.hpp"
+
+/* GL state a packet is drawn with (packets sharing it sorted next to each other) */
+struct DrawState {
+  /* drawn in increasing order (e.g. level before overlays) */
+  unsigned int pass = 0;
+
+  /* drawn after opaque packets of same pass, from back to front */
+  bool is_translucent = false;
+
+  /* drawn with face culling disabled (e.g. doors & windows surfaces seen from both sides) */
+  bool is_two_sided = false;
+
+  GLuint program = 0;
+  GLuint texture = 0;
+  unsigned int vao = 0;
+
+  /* distance to camera of nearest instance drawn */
+  float depth = 0.0f;
+};
+
+/**
+ * Draw call made by render queue: plain function pointer & its arguments (no allocation per packet, unlike `std::function`)
+ * e.g. renderer drawn as context, uniforms as data & mesh as index (both pointed-to objects must outlive `flush()`)
+ */
+struct DrawCallback {
+  void (*draw)(void* context, const void* data, size_t index);
+  void* context;
+  const void* data;
+  size_t index;
+};
+
+/* One draw call submitted by a renderer & called back once packets are sorted by their key */
+struct DrawPacket {
+  uint64_t key;
+  DrawState state;
+  DrawCallback callback;
+};
+
+/**
+ * Draw packets of a frame sorted by a 64-bit key (pass, translucency, program, texture, vao then depth) before being drawn,
+ * so consecutive draws share as much state as possible & translucent ones are drawn last from back to front
+ * Program, textures & vao are still bound by `Renderer::draw()` (opengl-utils) for each packet, so only state changes
+ * between consecutive packets are counted (not binds issued), & face culling is only toggled when it changes
+ */
+class RenderQueue {
+public:
+  /* state changes needed to draw packets in their current order */
+  struct StateChanges {
+    unsigned int n_programs = 0;
+    unsigned int n_textures = 0;
+    unsigned int n_vaos = 0;
+  };
+
+  void submit(const DrawState& state, const DrawCallback& callback);
+  void sort();
+  void flush();
+  StateChanges get_state_changes() const;
+  size_t size() const;
+  unsigned int get_vao(const void* owner);
+
+  static uint64_t get_key(const DrawState& state);
+  static float get_depth(const glm::vec3& position_camera, const std::vector<BoundingBox>& bboxes, const std::vector<unsigned int>& indices);
+
+private:
+  /* packets in submission order (capacity kept between frames) */
+  std::vector<DrawPacket> m_packets;
+
+  /* keys & indices of packets, sorted by `sort()` (second buffer swapped with first on each radix pass) */
+  std::vector<std::pair<uint64_t, unsigned int>> m_order;
+  std::vector<std::pair<uint64_t, unsigned int>> m_order_sorted;
+
+  /* small index for each vao (by address of renderer owning it) to fit in keys */
+  std::unordered_map<const void*, unsigned int> m_vaos;
+};
+
+#endif // RENDER_QUEUE_HPP
@@ -0,0 +1,19 @@
+#ifndef STORAGE_RENDERER_HPP
+#define STORAGE_RENDERER_HPP
+
+#include "render/renderer.hpp"
+
+/**
+ * Renderer whose per-instance data is read from shader storage buffers (bound by its owner before drawing)
+ * Only view/projection matrices & # of instances are set on it, instead of `Renderer::set_transform()`
+ * which also sets a `models[i]` uniform per instance (these don't exist in shaders reading instances buffers)
+ */
+class StorageRenderer : public Renderer {
+public:
+  StorageRenderer(const Program& program, const Geometry& geometry, const std::vector<Attribute>& attributes, bool is_text=false);
+  StorageRenderer(const StorageRenderer& renderer, const Program& program);
+  void set_transform(const glm::mat4& view, const glm::mat4& projection, unsigned int n_instances);
+  unsigned int get_n_instances() const;
+};
+
+#endif // STORAGE_RENDERER_HPP
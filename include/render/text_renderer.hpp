@@ -1,11 +1,11 @@
 #ifndef TEXT_RENDERER_HPP
 #define TEXT_RENDERER_HPP
 
-#include "render/renderer.hpp"
+#include "render/instanced_renderer.hpp"
 #include "text/font.hpp"
 #include "text/glyphs.hpp"
 
-class TextRenderer : public Renderer {
+class TextRenderer : public InstancedRenderer {
 public:
   TextRenderer(const Program& program, const std::vector<Attribute>& attributes, const Font& font);
   void draw_text(const std::string& text, const Uniforms& u={});
@@ -0,0 +1,21 @@
+#ifndef PROGRAM_BINARY_HPP
+#define PROGRAM_BINARY_HPP
+
+#include "shader/program.hpp"
+#include "shaders/program_cache.hpp"
+
+/**
+ * Program linked from a binary saved by `ProgramCache` instead of compiled from its shaders sources
+ * No shader attached (default-constructed `Program`), so freeing it only deletes its own program
+ */
+class ProgramBinary : public Program {
+public:
+  ProgramBinary(const ProgramCache::Binary& binary);
+  bool is_linked() const;
+
+private:
+  /* false when binary is rejected by driver (program deleted) */
+  bool m_is_linked;
+};
+
+#endif // PROGRAM_BINARY_HPP
@@ -0,0 +1,31 @@
+#ifndef PROGRAM_CACHE_HPP
+#define PROGRAM_CACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+
+/**
+ * Linked shader programs saved in driver's binary format (`glGetProgramBinary()`) to skip their compilation on next launches
+ * Written to `assets/shaders/cache/<name>.program`, and ignored (then overwritten) when shaders sources,
+ * gpu driver (vendor, renderer & version) or format version change, or when binary is rejected by driver
+ */
+struct ProgramCache {
+  static const uint32_t MAGIC = 0x4d475250; // "PRGM" in little-endian
+  static const uint32_t VERSION = 1;
+
+  /* Driver-specific binary & its format */
+  struct Binary {
+    GLenum format;
+    std::vector<char> data;
+  };
+
+  static std::string get_path(const std::string& name);
+  static uint64_t get_hash(const std::string& path_vertex, const std::string& path_fragment);
+  static bool load(const std::string& name, uint64_t hash, Binary& binary);
+  static bool save(const std::string& name, uint64_t hash, GLuint program);
+  static bool upload(GLuint program, const Binary& binary);
+};
+
+#endif // PROGRAM_CACHE_HPP
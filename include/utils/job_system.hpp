@@ -0,0 +1,100 @@
+#ifndef JOB_SYSTEM_HPP
+#define JOB_SYSTEM_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Pool of worker threads running short jobs (e.g. culling of each renderer) with work stealing:
+ * each thread pushes & pops jobs at the back of its own queue, idle threads steal from the front of others queues
+ * Jobs are a function pointer & a range (no allocation when pushed), & thread waiting on them runs jobs meanwhile
+ * (so jobs can wait on sub-jobs, & everything runs on caller's thread without workers)
+ * Functions given to `run()`/`parallel_for()` are referenced by jobs, so they must outlive the call to `wait()`
+ */
+class JobSystem {
+public:
+  /* # of jobs left (decremented when a job finishes) */
+  using Counter = std::atomic<unsigned int>;
+
+  JobSystem(unsigned int n_threads=std::max(std::thread::hardware_concurrency(), 1u) - 1);
+  ~JobSystem();
+
+  template <typename Function>
+  void run(Function& function, Counter& counter);
+
+  template <typename Function>
+  void parallel_for(size_t n, size_t size_chunk, Function& function, Counter& counter);
+
+  void wait(Counter& counter);
+  unsigned int get_n_threads() const;
+
+  JobSystem(const JobSystem&) = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+
+private:
+  /* max. # of jobs in a queue (pushed jobs run immediately when it's full) */
+  static const size_t SIZE_QUEUE = 1024;
+
+  struct Job {
+    void (*execute)(void* function, size_t first, size_t last);
+    void* function;
+    size_t first;
+    size_t last;
+    Counter* counter;
+  };
+
+  /* ring buffer of jobs guarded by its own mutex (owner works at the back, thieves at the front) */
+  struct Queue {
+    std::array<Job, SIZE_QUEUE> jobs;
+    size_t front = 0;
+    size_t size = 0;
+    std::mutex mutex;
+  };
+
+  /* queue of each worker thread, after the one shared by other threads (e.g. main thread) */
+  std::vector<std::unique_ptr<Queue>> m_queues;
+  std::vector<std::thread> m_threads;
+
+  /* # of jobs in all queues, workers sleep while it's zero */
+  std::atomic<unsigned int> m_n_jobs;
+  bool m_is_stopped;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+
+  void push(const Job& job);
+  bool pop(Job& job);
+  bool steal(Job& job);
+  void execute(const Job& job);
+  void run_worker(unsigned int i_queue);
+  unsigned int get_queue_thread() const;
+};
+
+/* Run `function()` on a worker (or on waiting thread) */
+template <typename Function>
+void JobSystem::run(Function& function, Counter& counter) {
+  auto execute = [](void* function_job, size_t, size_t) { (*static_cast<Function*>(function_job))(); };
+  counter++;
+  push({ execute, &function, 0, 0, &counter });
+}
+
+/**
+ * Run `function(first, last)` on consecutive chunks of [0, n) in parallel
+ * @param size_chunk Max. # of elements in a chunk (large enough for a job to outweigh its scheduling)
+ */
+template <typename Function>
+void JobSystem::parallel_for(size_t n, size_t size_chunk, Function& function, Counter& counter) {
+  auto execute = [](void* function_job, size_t first, size_t last) { (*static_cast<Function*>(function_job))(first, last); };
+
+  for (size_t first = 0; first < n; first += size_chunk) {
+    counter++;
+    push({ execute, &function, first, std::min(first + size_chunk, n), &counter });
+  }
+}
+
+#endif // JOB_SYSTEM_HPP
@@ -0,0 +1,22 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Read-only mapping of whole file (unmapped on destruction)
+ * Pages are only read from disk when accessed & can be dropped by the os (not counted as allocated memory)
+ */
+struct MappedFile {
+  const char* data = nullptr;
+  size_t size = 0;
+
+  MappedFile(const std::string& path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+};
+
+#endif // MAPPED_FILE_HPP
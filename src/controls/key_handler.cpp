@@ -1,8 +1,10 @@
 #include "controls/key_handler.hpp"
+#include "profiling/profiler.hpp"
 
 KeyHandler::KeyHandler(const Window& window, CameraFPS& camera):
   m_window(window),
-  m_camera(camera)
+  m_camera(camera),
+  m_is_pressed_profiler(false)
 {
 }
 
@@ -16,6 +18,15 @@ void KeyHandler::on_keypress() {
     m_window.close();
   }
 
+  // dump zones recorded so far to open in chrome://tracing or ui.perfetto.dev
+  bool is_pressed_profiler = m_window.is_key_pressed(GLFW_KEY_P);
+  if (is_pressed_profiler && !m_is_pressed_profiler) {
+#ifdef PROFILING
+    Profiler::export_chrome_trace("trace.json");
+#endif
+  }
+  m_is_pressed_profiler = is_pressed_profiler;
+
   // TODO: if <spacebar> is pressed while jumping, camera can stick to ceiling
   if (m_window.is_key_pressed(GLFW_KEY_SPACE)) {
     m_camera.is_jumping = true;
@@ -17,26 +17,28 @@ Window* MouseHandler::m_window;
 int MouseHandler::m_xmouse;
 int MouseHandler::m_ymouse;
 Audio* MouseHandler::m_audio;
+const LevelRenderer* MouseHandler::m_level;
 
 /**
  * Initialize static members
  * @param window
  * @param camera Pointer to camera to control with mouse
- * @param cube Check for its intersection with camera's intersection
  * @param audio
+ * @param level Its targets checked for intersection with camera's line of sight
  */
-void MouseHandler::init(Window* window, CameraFPS* camera, Audio* audio) {
+void MouseHandler::init(Window* window, CameraFPS* camera, Audio* audio, const LevelRenderer* level) {
   // init static members: initial mouse's xy-coords at center of screen
   m_camera = camera;
   m_window = window;
   m_xmouse = m_window->width / 2;
   m_ymouse = m_window->height / 2;
   m_audio = audio;
+  m_level = level;
 }
 
 /**
  * listener for click on mouse buttons
- * Check for intersection between camera's line of sight & cube
+ * Kill closest target on camera's line of sight (if not behind a wall)
  */
 void MouseHandler::on_mouse_click(GLFWwindow* window, int button, int action, int mods) {
   // callback called for all mouse buttons and on press & release
@@ -46,26 +48,13 @@ void MouseHandler::on_mouse_click(GLFWwindow* window, int button, int action, in
   // play gun shot sound
   m_audio->shot();
   Ray ray(m_camera->position, m_camera->direction);
+  int i_target = m_level->raycast_targets(ray);
 
-  for (size_t i_target = 0; i_target < targets.size(); ++i_target) {
-    TargetEntry& target_entry = targets[i_target];
-    if (target_entry.is_dead)
-      continue;
-
-    // TODO: target2 would still be killed before target3 even if former in bg
-    std::cout << "Target: " << i_target << '\n';
-    BoundingBox bounding_box = target_entry.bounding_box;
-    bool is_intersecting = bounding_box.intersects(ray);
-
-    // remove target & increase score on intersection
-    if (is_intersecting) {
-      target_entry.is_dead = true;
-      score++;
-      std::cout << "Intersecting!" << '\n';
-      return;
-    } else {
-      std::cout << "Not intersecting!" << '\n';
-    }
+  // remove target & increase score on intersection
+  if (i_target != BoundingBox::NO_COLLISION) {
+    targets[i_target].is_dead = true;
+    score++;
+    std::cout << "Target " << i_target << " killed" << '\n';
   }
 }
 
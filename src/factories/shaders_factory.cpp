@@ -1,19 +1,72 @@
+#include <chrono>
+#include <iostream>
+#include <vector>
+
 #include "factories/shaders_factory.hpp"
+#include "shaders/program_cache.hpp"
+#include "shaders/program_binary.hpp"
+
+using namespace std::chrono;
 
-/* Similar to how programs are managed in <imgui-paint>/Canvas */
-ShadersFactory::ShadersFactory():
-  m_programs {
-    { "text", Program("assets/shaders/instancing/texture_surface.vert", "assets/shaders/texture_text.frag") },
+namespace {
+  /* Vertex & fragment shaders of each program by key */
+  struct ProgramEntry {
+    std::string key;
+    std::string path_vertex;
+    std::string path_fragment;
+  };
+
+  const std::vector<ProgramEntry> PROGRAMS_ENTRIES = {
+    { "text", "assets/shaders/instancing/texture_surface.vert", "assets/shaders/texture_text.frag" },
 
     // instancing (draw same geometry multiple times at once)
-    { "phong", Program("assets/shaders/instancing/phong.vert", "assets/shaders/instancing/phong.frag") },
-    { "basic", Program("assets/shaders/instancing/basic.vert", "assets/shaders/instancing/basic.frag") },
-    { "texture_surface", Program("assets/shaders/instancing/texture_surface.vert", "assets/shaders/instancing/texture_surface.frag") },
-    { "texture", Program("assets/shaders/instancing/texture_mesh.vert", "assets/shaders/instancing/texture_mesh.frag") },
-    { "tile", Program("assets/shaders/instancing/tile.vert", "assets/shaders/instancing/tile.frag") },
-    { "texture_cube", Program("assets/shaders/instancing/texture_cube.vert", "assets/shaders/instancing/texture_cube.frag") },
+    { "phong", "assets/shaders/instancing/phong.vert", "assets/shaders/instancing/phong.frag" },
+    { "basic", "assets/shaders/instancing/basic.vert", "assets/shaders/instancing/basic.frag" },
+    { "texture_surface", "assets/shaders/instancing/texture_surface.vert", "assets/shaders/instancing/texture_surface.frag" },
+    { "texture", "assets/shaders/instancing/texture_mesh.vert", "assets/shaders/instancing/texture_mesh.frag" },
+    { "tile", "assets/shaders/instancing/tile.vert", "assets/shaders/instancing/tile.frag" },
+    { "texture_cube", "assets/shaders/instancing/texture_cube.vert", "assets/shaders/instancing/texture_cube.frag" },
+  };
+}
+
+/**
+ * Similar to how programs are managed in <imgui-paint>/Canvas
+ * Programs linked from their cached binaries when possible (see `ProgramCache`), compiled & cached otherwise
+ */
+ShadersFactory::ShadersFactory() {
+  steady_clock::time_point time_start = steady_clock::now();
+  unsigned int n_hits = 0;
+
+  for (const ProgramEntry& entry : PROGRAMS_ENTRIES) {
+    steady_clock::time_point time_start_program = steady_clock::now();
+    uint64_t hash = ProgramCache::get_hash(entry.path_vertex, entry.path_fragment);
+    ProgramCache::Binary binary;
+    bool is_hit = false;
+
+    if (ProgramCache::load(entry.key, hash, binary)) {
+      ProgramBinary program(binary);
+      is_hit = program.is_linked();
+
+      if (is_hit)
+        m_programs.insert({ entry.key, program });
+    }
+
+    // binary missing, stale, or rejected by driver
+    if (!is_hit) {
+      Program program(entry.path_vertex, entry.path_fragment);
+      if (!program.has_failed())
+        ProgramCache::save(entry.key, hash, program.id);
+
+      m_programs.insert({ entry.key, program });
+    }
+
+    duration<double, std::milli> interval = steady_clock::now() - time_start_program;
+    std::cout << "- Program " << entry.key << ": " << (is_hit ? "cache hit" : "cache miss") << " in " << interval.count() << "ms" << '\n';
+    n_hits += is_hit;
   }
-{
+
+  duration<double, std::milli> interval = steady_clock::now() - time_start;
+  std::cout << "Programs: " << n_hits << "/" << PROGRAMS_ENTRIES.size() << " loaded from cache in " << interval.count() << "ms" << '\n';
 }
 
 /**
@@ -2,40 +2,46 @@
 
 #include "factories/textures_factory.hpp"
 
-/* Similar to how programs are managed in <imgui-paint>/Canvas */
-TexturesFactory::TexturesFactory():
-  // smart pointer freed when out of scopt (doesn't work if inserted directly into m_textures bcos it copies a unique_ptr)
-  m_crosshair(std::make_unique<Texture2D>(Image("assets/images/surfaces/crosshair.png"))),
-  m_health(std::make_unique<Texture2D>(Image("assets/images/surfaces/health.png"))),
-  m_wall_diffuse(std::make_unique<Texture2D>(Image("assets/images/level/wall_diffuse.jpg"), GL_TEXTURE0)),
-  m_wall_normal(std::make_unique<Texture2D>(Image("assets/images/level/wall_normal.jpg"), GL_TEXTURE1)),
-  m_door_diffuse(std::make_unique<Texture2D>(Image("assets/images/level/door_diffuse.jpg"), GL_TEXTURE0)),
-  m_door_normal(std::make_unique<Texture2D>(Image("assets/images/level/door_normal.jpg"), GL_TEXTURE1)),
-  m_window(std::make_unique<Texture2D>(Image("assets/images/surfaces/window.png"))),
-
-  // different texture units as floor/ceiling rendered in same shader by instancing
-  m_floor_diffuse(std::make_unique<Texture2D>(Image("assets/images/level/floor_diffuse.jpg"), GL_TEXTURE0)),
-  m_floor_normal(std::make_unique<Texture2D>(Image("assets/images/level/floor_normal.jpg"), GL_TEXTURE1)),
-  m_ceiling_diffuse(std::make_unique<Texture2D>(Image("assets/images/level/ceiling_diffuse.jpg"), GL_TEXTURE2)),
-  m_ceiling_normal(std::make_unique<Texture2D>(Image("assets/images/level/ceiling_normal.jpg"), GL_TEXTURE3)),
-
-  m_textures {
+namespace {
+  /* Image & texture unit of each texture by key */
+  struct TextureEntry {
+    std::string key;
+    std::string path;
+    GLenum index;
+  };
+
+  const std::vector<TextureEntry> TEXTURES_ENTRIES = {
     // 2D textures for HUDS
-    { "crosshair", m_crosshair.get() },
-    { "health", m_health.get() },
+    { "crosshair", "assets/images/surfaces/crosshair.png", GL_TEXTURE0 },
+    { "health", "assets/images/surfaces/health.png", GL_TEXTURE0 },
 
     // textures used in LevelRenderer (incl. FloorsRenderer, WallsRenderer)
-    { "window", m_window.get() },
-    { "door_diffuse", m_door_diffuse.get() },
-    { "door_normal", m_door_normal.get() },
-    { "floor_diffuse", m_floor_diffuse.get() },
-    { "floor_normal", m_floor_normal.get() },
-    { "ceiling_diffuse", m_ceiling_diffuse.get() },
-    { "ceiling_normal", m_ceiling_normal.get() },
-    { "wall_diffuse", m_wall_diffuse.get() },
-    { "wall_normal", m_wall_normal.get() },
+    { "window", "assets/images/surfaces/window.png", GL_TEXTURE0 },
+    { "door_diffuse", "assets/images/level/door_diffuse.jpg", GL_TEXTURE0 },
+    { "door_normal", "assets/images/level/door_normal.jpg", GL_TEXTURE1 },
+    { "wall_diffuse", "assets/images/level/wall_diffuse.jpg", GL_TEXTURE0 },
+    { "wall_normal", "assets/images/level/wall_normal.jpg", GL_TEXTURE1 },
+
+    // different texture units as floor/ceiling rendered in same shader by instancing
+    { "floor_diffuse", "assets/images/level/floor_diffuse.jpg", GL_TEXTURE0 },
+    { "floor_normal", "assets/images/level/floor_normal.jpg", GL_TEXTURE1 },
+    { "ceiling_diffuse", "assets/images/level/ceiling_diffuse.jpg", GL_TEXTURE2 },
+    { "ceiling_normal", "assets/images/level/ceiling_normal.jpg", GL_TEXTURE3 },
+  };
+}
+
+/**
+ * Similar to how programs are managed in <imgui-paint>/Canvas
+ * All images queued first to be decoded in parallel, then uploaded one by one as soon as they're ready
+ */
+TexturesFactory::TexturesFactory(AssetsLoader& assets_loader) {
+  for (const TextureEntry& entry : TEXTURES_ENTRIES)
+    assets_loader.load_image(entry.path);
+
+  for (const TextureEntry& entry : TEXTURES_ENTRIES) {
+    m_textures_2d.push_back(std::make_unique<Texture2D>(assets_loader.get_image(entry.path), entry.index));
+    m_textures[entry.key] = m_textures_2d.back().get();
   }
-{
 }
 
 /**
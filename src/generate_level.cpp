@@ -0,0 +1,45 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "levels/level_generator.hpp"
+
+using namespace std::chrono;
+
+/**
+ * Write a generated tilemap & a camera path flying through its rooms (e.g. for `headless` on large levels)
+ * Rooms, enemies & props scale with # of tiles by default (one room per 256 tiles)
+ * Usage: ./generate_level [n_tiles] [seed] [output_tilemap] [output_camera_path] [n_rooms] [density_corridors] [density_props] [n_enemies]
+ */
+int main(int argc, char* argv[]) {
+  unsigned int n_tiles = (argc > 1) ? std::atoi(argv[1]) : 10000;
+  unsigned int seed = (argc > 2) ? std::atoi(argv[2]) : 0;
+  std::string path_tilemap = (argc > 3) ? argv[3] : "assets/levels/generated.txt";
+  std::string path_camera = (argc > 4) ? argv[4] : "assets/paths/generated.txt";
+
+  LevelGenerator::Parameters parameters;
+  parameters.n_rows = parameters.n_cols = std::ceil(std::sqrt((double) n_tiles));
+  parameters.n_rooms = (argc > 5) ? std::atoi(argv[5]) : std::max(n_tiles / 256, 1u);
+  parameters.density_corridors = (argc > 6) ? std::atof(argv[6]) : 0.3f;
+  parameters.density_props = (argc > 7) ? std::atof(argv[7]) : 0.02f;
+  parameters.n_enemies = (argc > 8) ? std::atoi(argv[8]) : std::max(n_tiles / 512, 1u);
+  parameters.seed = seed;
+
+  steady_clock::time_point time_start = steady_clock::now();
+  LevelGenerator generator(parameters);
+  duration<double, std::milli> interval = steady_clock::now() - time_start;
+
+  if (!generator.save(path_tilemap) || !generator.save_camera_path(path_camera)) {
+    std::cout << "Failed to write " << path_tilemap << " or " << path_camera << '\n';
+    return 1;
+  }
+
+  const std::vector<std::string>& rows = generator.get_rows();
+  std::cout << "Level: " << rows.size() << " rows x " << rows[0].size() << " cols, " << generator.get_n_rooms() << " rooms"
+            << " (seed " << seed << ", generated in " << interval.count() << " ms)" << '\n';
+  std::cout << "Tilemap: " << path_tilemap << ", camera path: " << path_camera << '\n';
+
+  return 0;
+}
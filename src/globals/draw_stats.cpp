@@ -0,0 +1,4 @@
+#include "globals/draw_stats.hpp"
+
+// incremented by renderers on each draw call
+DrawStats draw_stats;
@@ -0,0 +1,172 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "headless/offscreen_context.hpp"
+
+#include "navigation/camera.hpp"
+#include "navigation/camera_path.hpp"
+#include "navigation/frustum.hpp"
+
+#include "levels/level_renderer.hpp"
+#include "factories/shaders_factory.hpp"
+#include "factories/textures_factory.hpp"
+#include "render/lod_renderer.hpp"
+#include "loaders/assets_loader.hpp"
+#include "shader/shader_exception.hpp"
+
+#include "globals/lights.hpp"
+#include "globals/draw_stats.hpp"
+#include "profiling/profiler.hpp"
+
+using namespace std::chrono;
+
+/**
+ * Headless benchmark: level rendered offscreen (no window or display, e.g. Mesa llvmpipe on a build agent)
+ * while camera flies along a scripted path, with per-frame stats written to a csv file
+ * Usage: ./headless [camera_path] [n_frames] [output_csv] [tilemap]
+ */
+int main(int argc, char* argv[]) {
+  std::string path_camera = (argc > 1) ? argv[1] : "assets/paths/flythrough.txt";
+  unsigned int n_frames = (argc > 2) ? std::atoi(argv[2]) : 600;
+  std::string path_csv = (argc > 3) ? argv[3] : "frames.csv";
+  std::string path_tilemap = (argc > 4) ? argv[4] : "assets/levels/map.txt";
+
+  ////////////////////////////////////////////////
+  // Offscreen context & camera
+  ////////////////////////////////////////////////
+
+  // same resolution on every run (results comparable between runs)
+  OffscreenContext context(1280, 720);
+
+  if (context.is_null()) {
+    std::cout << "Failed to create offscreen OpenGL context" << "\n";
+    return 1;
+  }
+
+  // initialize glad before calling gl functions
+  if (!context.load_gl()) {
+    std::cout << "Failed to load Glad (OpenGL) or offscreen framebuffer" << "\n";
+    context.destroy();
+    return 1;
+  } else {
+    std::cout << "Opengl version: " << glGetString(GL_VERSION) << "\n";
+    std::cout << "Opengl renderer: " << glGetString(GL_RENDERER) << "\n";
+  }
+
+  CameraPath camera_path(path_camera);
+  if (camera_path.positions.empty()) {
+    std::cout << "No keyframes in camera path: " << path_camera << "\n";
+    context.destroy();
+    return 1;
+  }
+
+  // camera placed along path in every frame
+  Camera camera(camera_path.positions[0], camera_path.directions[0], glm::vec3(0.0f, 1.0f, 0.0f));
+
+  // transformation matrices (same as in main)
+  float near = 0.001,
+        far = 50.0;
+  float aspect_ratio = (float) context.width / (float) context.height;
+  glm::mat4 projection3d = glm::perspective(glm::radians(camera.fov), aspect_ratio, near, far);
+  Frustum frustum(near, far, aspect_ratio);
+
+  ////////////////////////////////////////////////
+  // Renderers
+  ////////////////////////////////////////////////
+
+  // import level's 3d models & simplify their LODs on worker threads while shaders are compiled
+  AssetsLoader assets_loader;
+  LodRenderer::load(assets_loader, "assets/models/tree/tree.obj");
+  LodRenderer::load(assets_loader, "assets/models/samurai/samurai.obj");
+
+  ShadersFactory shaders_factory;
+  if (shaders_factory.has_failed()) {
+    context.destroy();
+    throw ShaderException();
+  }
+
+  TexturesFactory textures_factory(assets_loader);
+  steady_clock::time_point time_level = steady_clock::now();
+  LevelRenderer level(assets_loader, shaders_factory, textures_factory, path_tilemap);
+  level.update(camera.position, true);
+  duration<double, std::milli> interval_level = steady_clock::now() - time_level;
+  std::cout << "Level loaded in " << interval_level.count() << " ms" << '\n';
+  assets_loader.print_stats();
+  assets_loader.release_vertexes();
+
+  // same opengl state as in main
+  glEnable(GL_DEPTH_TEST);
+  glEnable(GL_BLEND);
+  glEnable(GL_STENCIL_TEST);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+  glEnable(GL_CULL_FACE);
+
+  ////////////////////////////////////////////////
+  // Frames loop
+  ////////////////////////////////////////////////
+
+  // cpu: building & submitting frame, frame: also waiting for gpu (or llvmpipe threads) to finish rendering it
+  std::ofstream file_csv(path_csv);
+  file_csv << "frame,cpu_ms,frame_ms,draw_calls,instances,occlusion_tests,occluded,culls_skipped,plane_tests,early_outs,program_changes,texture_changes,vao_changes" << '\n';
+
+  for (size_t i_frame = 0; i_frame < n_frames; ++i_frame) {
+    float t = (n_frames > 1) ? (float) i_frame / (n_frames - 1) : 0.0f;
+    camera_path.set_camera(camera, t);
+    PROFILE_ZONE("frame");
+
+    steady_clock::time_point time_start = steady_clock::now();
+    draw_stats.reset();
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // waits for chunks around camera so every run renders the same frames
+    level.update(camera.position, true);
+
+    glm::mat4 view = camera.get_view();
+    frustum.calculate_planes(camera);
+
+    level.set_transform({ {glm::mat4(1.0f)}, view, projection3d }, frustum);
+    level.draw({
+      {"position_camera", camera.position},
+      {"positions_lights[0]", lights[0].position},
+      {"positions_lights[1]", lights[1].position},
+      {"positions_lights[2]", lights[2].position},
+    });
+
+    duration<double, std::milli> duration_cpu = steady_clock::now() - time_start;
+    {
+      PROFILE_ZONE("glFinish");
+      glFinish();
+    }
+    duration<double, std::milli> duration_frame = steady_clock::now() - time_start;
+
+    file_csv << i_frame << ',' << duration_cpu.count() << ',' << duration_frame.count() << ','
+             << draw_stats.n_draw_calls << ',' << draw_stats.n_instances << ','
+             << draw_stats.n_occlusion_tests << ',' << draw_stats.n_occluded << ','
+             << draw_stats.n_culls_skipped << ',' << draw_stats.n_plane_tests << ',' << draw_stats.n_early_outs << ','
+             << draw_stats.n_changes_programs << ',' << draw_stats.n_changes_textures << ',' << draw_stats.n_changes_vaos << '\n';
+  }
+
+  std::cout << "Wrote " << n_frames << " frames stats to " << path_csv << "\n";
+  if (level.save_occlusion_buffer("occlusion.pgm"))
+    std::cout << "Wrote occlusion buffer of last frame to occlusion.pgm" << "\n";
+
+#ifdef PROFILING
+  if (Profiler::export_chrome_trace("trace.json"))
+    std::cout << "Wrote zones trace to trace.json" << "\n";
+#endif
+
+  // free renderers, shaders programs & textures, then offscreen framebuffer & context
+  level.free();
+  shaders_factory.free();
+  textures_factory.free();
+  context.destroy();
+
+  return 0;
+}
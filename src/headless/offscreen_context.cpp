@@ -0,0 +1,125 @@
+#include <cstdlib>
+#include <iostream>
+
+#include "headless/offscreen_context.hpp"
+#include <EGL/eglext.h>
+
+/**
+ * Create OpenGL 4.6 core context (GLSL 4.6 needed by shaders) & make it current without any surface
+ * @param w Width of offscreen framebuffer
+ * @param h Height of offscreen framebuffer
+ */
+OffscreenContext::OffscreenContext(unsigned int w, unsigned int h):
+  width(w),
+  height(h),
+  m_display(EGL_NO_DISPLAY),
+  m_context(EGL_NO_CONTEXT),
+  m_fbo(0),
+  m_rbo_color(0),
+  m_rbo_depth_stencil(0)
+{
+  // llvmpipe supports all features used (e.g. SSBOs) but reports GL 4.5 before Mesa 23 (env vars already set aren't overwritten)
+  setenv("MESA_GL_VERSION_OVERRIDE", "4.6", 0);
+  setenv("MESA_GLSL_VERSION_OVERRIDE", "460", 0);
+
+  m_display = get_display();
+  if (m_display == EGL_NO_DISPLAY || !eglInitialize(m_display, NULL, NULL)) {
+    std::cout << "Failed to initialize EGL display" << '\n';
+    m_display = EGL_NO_DISPLAY;
+    return;
+  }
+
+  if (!eglBindAPI(EGL_OPENGL_API)) {
+    std::cout << "Failed to bind OpenGL API to EGL" << '\n';
+    return;
+  }
+
+  // no window surface on surfaceless platform (default surface type), any pbuffer config supporting desktop opengl will do
+  const EGLint attributes_config[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+  EGLConfig config;
+  EGLint n_configs;
+  if (!eglChooseConfig(m_display, attributes_config, &config, 1, &n_configs) || n_configs == 0) {
+    std::cout << "No EGL config supporting OpenGL" << '\n';
+    return;
+  }
+
+  const EGLint attributes_context[] = {
+    EGL_CONTEXT_MAJOR_VERSION, 4,
+    EGL_CONTEXT_MINOR_VERSION, 6,
+    EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+    EGL_NONE,
+  };
+  m_context = eglCreateContext(m_display, config, EGL_NO_CONTEXT, attributes_context);
+  if (m_context == EGL_NO_CONTEXT) {
+    std::cout << "Failed to create OpenGL 4.6 context with EGL" << '\n';
+    return;
+  }
+
+  if (!eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_context)) {
+    std::cout << "Failed to make EGL context current without surface" << '\n';
+    eglDestroyContext(m_display, m_context);
+    m_context = EGL_NO_CONTEXT;
+  }
+}
+
+/* Surfaceless platform (no X11/Wayland needed) with fallback on default display */
+EGLDisplay OffscreenContext::get_display() const {
+  auto get_platform_display = (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+  if (get_platform_display) {
+    EGLDisplay display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    if (display != EGL_NO_DISPLAY)
+      return display;
+  }
+
+  return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+bool OffscreenContext::is_null() const {
+  return m_context == EGL_NO_CONTEXT;
+}
+
+/**
+ * Load opengl functions with glad (like `gladLoadGL()` after `Window::make_context()`)
+ * then bind offscreen framebuffer that replaces window's default one
+ */
+bool OffscreenContext::load_gl() {
+  if (!gladLoadGLLoader((GLADloadproc) eglGetProcAddress))
+    return false;
+
+  create_framebuffer();
+  return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+/* Color & depth/stencil (needed for outlines) attachments as renderbuffers (never sampled) */
+void OffscreenContext::create_framebuffer() {
+  glGenFramebuffers(1, &m_fbo);
+  glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+
+  glGenRenderbuffers(1, &m_rbo_color);
+  glBindRenderbuffer(GL_RENDERBUFFER, m_rbo_color);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_rbo_color);
+
+  glGenRenderbuffers(1, &m_rbo_depth_stencil);
+  glBindRenderbuffer(GL_RENDERBUFFER, m_rbo_depth_stencil);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_rbo_depth_stencil);
+
+  glViewport(0, 0, width, height);
+}
+
+/* Free framebuffer & its attachments then release context */
+void OffscreenContext::destroy() {
+  if (m_fbo != 0) {
+    glDeleteRenderbuffers(1, &m_rbo_color);
+    glDeleteRenderbuffers(1, &m_rbo_depth_stencil);
+    glDeleteFramebuffers(1, &m_fbo);
+  }
+
+  if (m_display != EGL_NO_DISPLAY) {
+    eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (m_context != EGL_NO_CONTEXT)
+      eglDestroyContext(m_display, m_context);
+    eglTerminate(m_display);
+  }
+}
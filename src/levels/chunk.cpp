@@ -0,0 +1,204 @@
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <array>
+
+#include "levels/chunk.hpp"
+#include "profiling/profiler.hpp"
+
+namespace {
+  /* Entries vector each tile is added to (walls also saved for collision with camera) */
+  enum class TileClass : unsigned char { NONE, WALL, DOOR, WINDOW, TREE, N_CLASSES };
+
+  /* Class of each tile indexed by tile's char (instead of searching a list of walls tiles for each tile) */
+  constexpr std::array<TileClass, 256> get_tiles_classes() {
+    std::array<TileClass, 256> tiles_classes = {};
+    for (Tilemap::Tiles tile : { Tilemap::Tiles::WALL_H, Tilemap::Tiles::WALL_V, Tilemap::Tiles::WALL_L, Tilemap::Tiles::WALL_GAMMA })
+      tiles_classes[(unsigned char) tile] = TileClass::WALL;
+    tiles_classes[(unsigned char) Tilemap::Tiles::DOOR_H] = TileClass::DOOR;
+    tiles_classes[(unsigned char) Tilemap::Tiles::WINDOW] = TileClass::WINDOW;
+    tiles_classes[(unsigned char) Tilemap::Tiles::TREE] = TileClass::TREE;
+
+    return tiles_classes;
+  }
+
+  constexpr std::array<TileClass, 256> TILES_CLASSES = get_tiles_classes();
+
+  /* rows parsed by each job of `TilesEntries::compile()` */
+  const unsigned int N_ROWS_BAND = 64;
+}
+
+/**
+ * # of entries in block of tiles (enemies excluded as targets stay loaded for whole level)
+ * @param tile_min Column & row of block's first tile
+ * @param tile_max Column & row past block's last tile (tiles past the end of a shorter row are empty)
+ */
+TilesEntries::Counts TilesEntries::count(const Tilemap& tilemap, const glm::uvec2& tile_min, const glm::uvec2& tile_max) {
+  std::array<size_t, (size_t) TileClass::N_CLASSES> n_tiles_classes = {};
+  for (unsigned int i_row = tile_min.y; i_row < std::min(tile_max.y, tilemap.n_rows); ++i_row) {
+    std::string_view row = tilemap.get_row(i_row);
+    for (size_t i_col = tile_min.x; i_col < std::min<size_t>(tile_max.x, row.size()); ++i_col)
+      n_tiles_classes[(size_t) TILES_CLASSES[(unsigned char) row[i_col]]]++;
+  }
+
+  Counts counts;
+  counts.n_walls = n_tiles_classes[(size_t) TileClass::WALL];
+  counts.n_doors = n_tiles_classes[(size_t) TileClass::DOOR];
+  counts.n_trees = n_tiles_classes[(size_t) TileClass::TREE];
+  counts.n_windows = n_tiles_classes[(size_t) TileClass::WINDOW];
+
+  return counts;
+}
+
+void TilesEntries::resize(const Counts& counts) {
+  walls.resize(counts.n_walls);
+  positions_walls.resize(counts.n_walls);
+  positions_doors.resize(counts.n_doors);
+  positions_trees.resize(counts.n_trees);
+  positions_windows.resize(counts.n_windows);
+}
+
+/**
+ * Parse block of tiles into entries already allocated (see `count()`), no reallocation so blocks can be filled in parallel
+ * @param offsets Index of block's first entry of each kind
+ * @param position_level Offset added to tiles positions
+ * @param height_walls Used to place walls centers at mid-height
+ */
+void TilesEntries::fill(const Tilemap& tilemap, const glm::uvec2& tile_min, const glm::uvec2& tile_max, Counts offsets, const glm::vec3& position_level, float height_walls) {
+  for (unsigned int i_row = tile_min.y; i_row < std::min(tile_max.y, tilemap.n_rows); ++i_row) {
+    std::string_view row = tilemap.get_row(i_row);
+
+    for (size_t i_col = tile_min.x; i_col < std::min<size_t>(tile_max.x, row.size()); ++i_col) {
+      Tilemap::Tiles tile = (Tilemap::Tiles) row[i_col];
+      if (TILES_CLASSES[(unsigned char) tile] == TileClass::NONE)
+        continue;
+
+      glm::vec3 position_tile = {i_col, 0, i_row};
+      position_tile += position_level;
+
+      float angle = 0.0f;
+      switch (tile) {
+        case Tilemap::Tiles::WALL_H:
+          walls[offsets.n_walls] = { position_tile, WallOrientation::HORIZONTAL };
+          break;
+        case Tilemap::Tiles::WALL_V:
+          walls[offsets.n_walls] = { position_tile, WallOrientation::VERTICAL };
+          angle = glm::radians(90.0f);
+          break;
+        case Tilemap::Tiles::WALL_L:
+          walls[offsets.n_walls] = { position_tile, WallOrientation::L_SHAPED };
+          angle = glm::radians(90.0f);
+          break;
+        case Tilemap::Tiles::WALL_GAMMA:
+          walls[offsets.n_walls] = { position_tile, WallOrientation::GAMMA_SHAPED };
+          angle = glm::radians(-90.0f);
+          break;
+        case Tilemap::Tiles::DOOR_H:
+          positions_doors[offsets.n_doors++] = position_tile;
+          break;
+        case Tilemap::Tiles::WINDOW:
+          positions_windows[offsets.n_windows++] = position_tile;
+          break;
+        case Tilemap::Tiles::TREE:
+          positions_trees[offsets.n_trees++] = position_tile;
+          break;
+        default:
+          break;
+      } // END CASE
+
+      // save world position for walls (for collision with camera)
+      if (TILES_CLASSES[(unsigned char) tile] == TileClass::WALL) {
+        glm::vec3 center_local = {0.5f, 0.5f, 0.0f};
+        glm::mat4 model = glm::scale(
+          glm::rotate(
+            glm::translate(glm::mat4(1.0f), position_tile),
+            angle,
+            glm::vec3(0.0f, 1.0f, 0.0f)
+          ),
+          glm::vec3(1.0f, height_walls, 1.0f)
+        );
+        glm::vec3 center_world = glm::vec3(model * glm::vec4(center_local, 1.0f));
+        positions_walls[offsets.n_walls++] = center_world;
+      }
+    } // END BLOCK COL
+  } // END BLOCK ROW
+}
+
+/**
+ * Whole map parsed by bands of rows on workers (e.g. maps small enough not to be streamed, or benchmarks)
+ * Bands counted first, so each one fills its slice of a single output (no per-band vectors merged after)
+ * Entries in same order as a serial parse (row by row), PVS not baked
+ */
+TilesEntries TilesEntries::compile(const Tilemap& tilemap, const glm::vec3& position_level, float height_walls, JobSystem& jobs) {
+  PROFILE_ZONE("TilesEntries::compile");
+  const size_t N_BANDS = (tilemap.n_rows + N_ROWS_BAND - 1) / N_ROWS_BAND;
+  std::vector<Counts> offsets(N_BANDS);
+  auto get_tile_min = [](size_t i_band) { return glm::uvec2(0, i_band * N_ROWS_BAND); };
+  auto get_tile_max = [&tilemap](size_t i_band) { return glm::uvec2(tilemap.n_cols, (i_band + 1) * N_ROWS_BAND); };
+
+  auto count_bands = [&](size_t first, size_t last) {
+    for (size_t i_band = first; i_band < last; ++i_band)
+      offsets[i_band] = count(tilemap, get_tile_min(i_band), get_tile_max(i_band));
+  };
+  JobSystem::Counter counter(0);
+  jobs.parallel_for(N_BANDS, 1, count_bands, counter);
+  jobs.wait(counter);
+
+  // counts of each band replaced by offset of its entries
+  Counts total;
+  for (Counts& offsets_band : offsets) {
+    Counts counts_band = offsets_band;
+    offsets_band = total;
+    total.n_walls += counts_band.n_walls;
+    total.n_doors += counts_band.n_doors;
+    total.n_trees += counts_band.n_trees;
+    total.n_windows += counts_band.n_windows;
+  }
+
+  TilesEntries entries;
+  entries.resize(total);
+  auto fill_bands = [&](size_t first, size_t last) {
+    for (size_t i_band = first; i_band < last; ++i_band)
+      entries.fill(tilemap, get_tile_min(i_band), get_tile_max(i_band), offsets[i_band], position_level, height_walls);
+  };
+  jobs.parallel_for(N_BANDS, 1, fill_bands, counter);
+  jobs.wait(counter);
+
+  return entries;
+}
+
+/**
+ * Parse tiles covered by chunk (into vectors allocated once) & bake PVS of its cells
+ * @param position_level Offset added to tiles positions
+ * @param height_walls Used to place walls centers at mid-height
+ */
+Chunk::Chunk(const Tilemap& tilemap, const glm::ivec2& coords, const glm::vec3& position_level, float height_walls):
+  coords(coords)
+{
+  glm::uvec2 tile_min(coords.x * SIZE, coords.y * SIZE);
+  glm::uvec2 tile_max(tile_min.x + SIZE, tile_min.y + SIZE);
+  resize(count(tilemap, tile_min, tile_max));
+  fill(tilemap, tile_min, tile_max, Counts(), position_level, height_walls);
+
+  // cells past the map's end are never reached by camera
+  for (size_t i_cell = 0; i_cell < pvs.size(); ++i_cell) {
+    glm::ivec2 cell = coords * (int) N_CELLS + glm::ivec2(i_cell % N_CELLS, i_cell / N_CELLS);
+    if (cell.x * Pvs::SIZE_CELL < tilemap.n_cols && cell.y * Pvs::SIZE_CELL < tilemap.n_rows)
+      pvs[i_cell] = Pvs::bake(tilemap, cell);
+  }
+}
+
+/* Bytes allocated by chunk (counted against streamer's memory budget) */
+size_t Chunk::get_size() const {
+  return sizeof(Chunk) +
+    walls.capacity() * sizeof(WallEntry) +
+    (positions_doors.capacity() + positions_trees.capacity() + positions_windows.capacity() + positions_walls.capacity()) * sizeof(glm::vec3);
+}
+
+/**
+ * PVS of camera's cell
+ * @param cell Column & row of cell in tilemap (in cells not tiles), must be inside chunk
+ */
+Pvs Chunk::get_pvs(const glm::ivec2& cell, const glm::vec3& position_level) const {
+  glm::ivec2 cell_chunk = cell - coords * (int) N_CELLS;
+  return Pvs(cell, pvs[cell_chunk.y * N_CELLS + cell_chunk.x], position_level);
+}
@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+
+#include "levels/chunks_streamer.hpp"
+#include "profiling/profiler.hpp"
+
+/**
+ * Streaming threads started right away, chunks only queued on first `update()`
+ * @param radius Max. distance (in chunks) from camera's chunk of built chunks
+ * @param budget Max. bytes used by resident chunks & renderers data calculated from them
+ * @param n_threads Chunks built in parallel (at least one thread)
+ */
+ChunksStreamer::ChunksStreamer(const Tilemap& tilemap, const glm::vec3& position_level, float height_walls, unsigned int radius, size_t budget, unsigned int n_threads):
+  m_tilemap(tilemap),
+  m_position_level(position_level),
+  m_height_walls(height_walls),
+  m_radius(radius),
+  m_budget(budget),
+  m_size(0),
+  m_ratio_renderers(0.0),
+  m_n_building(0),
+  m_is_stopped(false)
+{
+  n_threads = std::max(n_threads, 1u);
+  for (size_t i_thread = 0; i_thread < n_threads; ++i_thread)
+    m_threads.push_back(std::thread(&ChunksStreamer::run, this));
+}
+
+/* Chunks still being built are finished before threads exit */
+ChunksStreamer::~ChunksStreamer() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_is_stopped = true;
+  }
+
+  m_condition_queue.notify_all();
+  for (std::thread& thread : m_threads)
+    thread.join();
+}
+
+/* Worker: build queued chunks one at a time (nearest to camera first) */
+void ChunksStreamer::run() {
+  while (true) {
+    glm::ivec2 coords;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition_queue.wait(lock, [this] { return m_is_stopped || !m_queue.empty(); });
+      if (m_is_stopped)
+        return;
+
+      coords = m_queue.front();
+      m_queue.pop_front();
+      m_n_building++;
+    }
+
+    std::shared_ptr<const Chunk> chunk = std::make_shared<const Chunk>(m_tilemap, coords, m_position_level, m_height_walls);
+
+    // `update()` only waits for all queued chunks, so it's woken up once (not after every chunk)
+    bool is_done;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_chunks_built.push_back(chunk);
+      m_n_building--;
+      is_done = m_queue.empty() && m_n_building == 0;
+    }
+
+    if (is_done)
+      m_condition_built.notify_all();
+  }
+}
+
+/**
+ * Called each frame from main thread: queue missing chunks around camera, make built ones resident & evict far ones
+ * Chunks one ring beyond radius are kept to avoid evicting/rebuilding them when camera moves back & forth along a chunk border
+ * @param position Camera position
+ * @param wait Block until all chunks in range are built (e.g. before first frame)
+ * @return Whether resident chunks changed (level renderers need to be updated)
+ */
+bool ChunksStreamer::update(const glm::vec3& position, bool wait) {
+  PROFILE_ZONE("ChunksStreamer::update");
+  const int SIZE = Chunk::SIZE;
+  glm::ivec2 center(std::floor((position.x - m_position_level.x) / SIZE), std::floor((position.z - m_position_level.z) / SIZE));
+  glm::ivec2 n_chunks((m_tilemap.n_cols + SIZE - 1) / SIZE, (m_tilemap.n_rows + SIZE - 1) / SIZE);
+  int radius = get_radius();
+
+  // chunks in range neither resident nor already queued
+  std::vector<glm::ivec2> coords_missing;
+  for (int y = std::max(center.y - radius, 0); y <= std::min(center.y + radius, n_chunks.y - 1); ++y) {
+    for (int x = std::max(center.x - radius, 0); x <= std::min(center.x + radius, n_chunks.x - 1); ++x) {
+      glm::ivec2 coords(x, y);
+      uint64_t key = get_key(coords);
+      if (m_chunks.count(key) == 0 && m_keys_queued.insert(key).second)
+        coords_missing.push_back(coords);
+    }
+  }
+
+  std::vector<std::shared_ptr<const Chunk>> chunks_built;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // chunks camera moved away from before they were built are dropped, others rebuilt nearest first
+    m_queue.erase(std::remove_if(m_queue.begin(), m_queue.end(), [&](const glm::ivec2& coords) {
+      bool is_far = get_distance(coords, center) > (unsigned int) radius;
+      if (is_far)
+        m_keys_queued.erase(get_key(coords));
+      return is_far;
+    }), m_queue.end());
+
+    m_queue.insert(m_queue.end(), coords_missing.begin(), coords_missing.end());
+    std::sort(m_queue.begin(), m_queue.end(), [&](const glm::ivec2& coords1, const glm::ivec2& coords2) {
+      return get_distance(coords1, center) < get_distance(coords2, center);
+    });
+
+    if (!coords_missing.empty())
+      m_condition_queue.notify_all();
+    if (wait)
+      m_condition_built.wait(lock, [this] { return m_queue.empty() && m_n_building == 0; });
+
+    chunks_built.swap(m_chunks_built);
+  }
+
+  bool has_changed = false;
+  for (const std::shared_ptr<const Chunk>& chunk : chunks_built) {
+    uint64_t key = get_key(chunk->coords);
+    m_keys_queued.erase(key);
+    if (get_distance(chunk->coords, center) > (unsigned int) radius + 1)
+      continue;
+
+    m_chunks[key] = chunk;
+    m_size += chunk->get_size();
+    has_changed = true;
+  }
+
+  // evict chunks out of range, then farthest ones if still over budget (camera's chunk always kept)
+  std::vector<std::pair<unsigned int, uint64_t>> distances_keys;
+  for (auto it = m_chunks.begin(); it != m_chunks.end();) {
+    unsigned int distance = get_distance(it->second->coords, center);
+    if (distance > (unsigned int) radius + 1) {
+      m_size -= it->second->get_size();
+      it = m_chunks.erase(it);
+      has_changed = true;
+    } else {
+      distances_keys.push_back({ distance, it->first });
+      ++it;
+    }
+  }
+
+  if (get_size() > m_budget) {
+    std::sort(distances_keys.begin(), distances_keys.end(), std::greater<std::pair<unsigned int, uint64_t>>());
+    for (size_t i_chunk = 0; i_chunk < distances_keys.size() && get_size() > m_budget && distances_keys[i_chunk].first > 0; ++i_chunk) {
+      auto it = m_chunks.find(distances_keys[i_chunk].second);
+      m_size -= it->second->get_size();
+      m_chunks.erase(it);
+      has_changed = true;
+    }
+  }
+
+  return has_changed;
+}
+
+/**
+ * Radius shrunk until chunks in range (& ring kept around them) fit in budget, given average size of resident chunks
+ * Avoids evicting chunks for budget that would be queued again on next update
+ */
+unsigned int ChunksStreamer::get_radius() const {
+  if (m_chunks.empty())
+    return m_radius;
+
+  size_t size_chunk = get_size() / m_chunks.size();
+  unsigned int radius = m_radius;
+  while (radius > 0 && (2 * radius + 3) * (2 * radius + 3) * size_chunk > m_budget)
+    radius--;
+
+  return radius;
+}
+
+/**
+ * Resident chunks (kept alive by returned pointers even if evicted meanwhile)
+ * Sorted by row then column so merged entries don't depend on which thread built each chunk first
+ */
+std::vector<std::shared_ptr<const Chunk>> ChunksStreamer::get_chunks() const {
+  std::vector<std::shared_ptr<const Chunk>> chunks;
+  chunks.reserve(m_chunks.size());
+  for (const auto& [key, chunk] : m_chunks)
+    chunks.push_back(chunk);
+
+  std::sort(chunks.begin(), chunks.end(), [](const std::shared_ptr<const Chunk>& chunk1, const std::shared_ptr<const Chunk>& chunk2) {
+    return std::make_pair(chunk1->coords.y, chunk1->coords.x) < std::make_pair(chunk2->coords.y, chunk2->coords.x);
+  });
+
+  return chunks;
+}
+
+/**
+ * Bytes used by renderers data calculated from given chunks (matrices, bboxes, BVHs & portals)
+ * Counted against budget in proportion to the size of each resident chunk
+ */
+void ChunksStreamer::set_size_renderers(size_t size_renderers, size_t size_chunks) {
+  if (size_chunks > 0)
+    m_ratio_renderers = (double) size_renderers / size_chunks;
+}
+
+/* Bytes used by resident chunks & by renderers data calculated from them */
+size_t ChunksStreamer::get_size() const {
+  return m_size * (1.0 + m_ratio_renderers);
+}
+
+uint64_t ChunksStreamer::get_key(const glm::ivec2& coords) {
+  return (uint64_t) (uint32_t) coords.x << 32 | (uint32_t) coords.y;
+}
+
+/* Chebyshev distance (resident chunks form a square around camera's chunk) */
+unsigned int ChunksStreamer::get_distance(const glm::ivec2& coords1, const glm::ivec2& coords2) {
+  return std::max(std::abs(coords1.x - coords2.x), std::abs(coords1.y - coords2.y));
+}
@@ -12,61 +12,93 @@ DoorsRenderer::DoorsRenderer(const ShadersFactory& shaders_factory, const Textur
 
   // textures
   m_tex_diffuse(textures_factory.get<Texture2D>("door_diffuse")),
-  m_tex_normal(textures_factory.get<Texture2D>("door_normal"))
+  m_tex_normal(textures_factory.get<Texture2D>("door_normal")),
+  m_textures_diffuse({ m_tex_diffuse }),
+  m_textures_normal({ m_tex_normal })
 {
 }
 
-/* Called in LevelRenderer's ctor to avoid inverting matrix every frame */
-void DoorsRenderer::calculate_uniforms(const std::vector<glm::vec3>& positions_tiles) {
+/**
+ * Matrices (normal matrix inverted once instead of every frame) & bboxes needed for frustum culling
+ * Only reads renderer's constants, so it can run on another thread than the one drawing
+ */
+DoorsRenderer::Instances DoorsRenderer::calculate_instances(const std::vector<glm::vec3>& positions_tiles) const {
   const size_t N_DOORS = positions_tiles.size();
-  m_models.resize(N_DOORS);
-  m_normals_mats.resize(N_DOORS);
-  m_textures_diffuse.resize(N_DOORS);
-  m_textures_normal.resize(N_DOORS);
+  Instances instances;
+  instances.models.resize(N_DOORS);
+  instances.normals_mats.resize(N_DOORS);
+  instances.textures_indices.resize(N_DOORS, 0);
+  instances.bboxes.resize(N_DOORS);
 
   for (size_t i_door = 0; i_door < N_DOORS; ++i_door) {
     glm::vec3 position_tile = positions_tiles[i_door];
     glm::mat4 model = glm::translate(glm::mat4(1.0f), position_tile);
-    glm::mat4 normal_mat = glm::inverseTranspose(model);
-    m_models[i_door] = model;
-    m_normals_mats[i_door] = normal_mat;
+    instances.models[i_door] = model;
+    instances.normals_mats[i_door] = glm::inverseTranspose(model);
 
-    m_textures_diffuse[i_door] = m_tex_diffuse;
-    m_textures_normal[i_door] = m_tex_normal;
+    // surface origin at lower-left corner
+    glm::vec3 position_center(position_tile.x + m_size.x/2.0, position_tile.y + m_size.y/2.0, position_tile.z);
+    instances.bboxes[i_door] = BoundingBox(position_center, m_size / 2.0f);
   }
+
+  instances.bvh = math::BVH(instances.bboxes);
+  return instances;
 }
 
-/* Bboxes needed for frustum culling (calculate in level ctor) */
-void DoorsRenderer::calculate_bboxes(const std::vector<glm::vec3>& positions_tiles) {
-  const unsigned int N_DOORS = positions_tiles.size();
-  m_bboxes.resize(N_DOORS);
+/* Instances calculated by `calculate_instances()` moved in (on gl thread, between frames) */
+void DoorsRenderer::set_instances(Instances& instances) {
+  m_models = std::move(instances.models);
+  m_normals_mats = std::move(instances.normals_mats);
+  m_textures_indices = std::move(instances.textures_indices);
+  m_bboxes = std::move(instances.bboxes);
+  m_bvh = std::move(instances.bvh);
+  m_cache_frustum.invalidate();
+}
 
-  for (size_t i_door = 0; i_door < N_DOORS; ++i_door) {
-    // surface origin at lower-left corner
-    glm::vec3 position_tile = positions_tiles[i_door];
-    glm::vec3 position_center(position_tile.x + m_size.x/2.0, position_tile.y + m_size.y/2.0, position_tile.z);
-    m_bboxes[i_door] = BoundingBox(position_center, m_size / 2.0f);
-  }
+size_t DoorsRenderer::Instances::get_size() const {
+  return (models.capacity() + normals_mats.capacity()) * sizeof(glm::mat4) + textures_indices.capacity() * sizeof(unsigned int) +
+    bboxes.capacity() * sizeof(BoundingBox) + bvh.get_size();
+}
+
+/* Instances culled by frustum then PVS, portals & occlusion (no gl calls, so it can run as a job) */
+void DoorsRenderer::cull(const Frustum& frustum, const Visibility& visibility, JobSystem& jobs) {
+  visibility.cull(frustum.cull(m_bvh, m_cache_frustum), m_bboxes, m_indices, jobs);
+}
+
+/* Per-instance data of instances left by `cull()` gathered into instances buffers (on gl thread) */
+void DoorsRenderer::set_transform(const Transformation& t) {
+  m_renderer.set_transform(t, m_models, m_indices);
+  m_renderer.set_instance_arr("normals_mats", m_normals_mats, m_indices);
+  m_renderer.set_instance_arr("textures_indices", m_textures_indices, m_indices);
+}
+
+/* Doors rectangles (portals between rooms, see `Portals`) */
+const std::vector<BoundingBox>& DoorsRenderer::get_bboxes() const {
+  return m_bboxes;
 }
 
 /**
- * Note: textures not filtered out as all doors have the same textures
+ * Packet drawn by render queue with face culling disabled (otherwise one face (back) of doors surfaces not rendered)
+ * Textures arrays set when drawn as floors share the same program
  */
-void DoorsRenderer::set_transform(const Transformation& t, const Frustum& frustum) {
-  std::vector<glm::mat4> models = frustum.cull(m_models, m_bboxes);
-  std::vector<glm::mat4> normals_mats = frustum.cull(m_normals_mats, m_bboxes);
+void DoorsRenderer::submit(RenderQueue& queue, const Uniforms& u, const glm::vec3& position_camera) {
+  if (m_indices.empty())
+    return;
 
-  m_renderer.set_transform({ models, t.view, t.projection });
-  m_renderer.set_uniform_arr("normals_mats", normals_mats);
-}
+  DrawState state;
+  state.is_two_sided = true;
+  state.program = m_renderer.get_program();
+  state.texture = m_tex_diffuse.id;
+  state.vao = queue.get_vao(&m_renderer);
+  state.depth = RenderQueue::get_depth(position_camera, m_bboxes, m_indices);
 
-void DoorsRenderer::draw(const Uniforms& u) {
-  // with face culling enabled, one face (back) of doors surfaces not rendered
-  m_renderer.set_uniform_arr("textures_diffuse", m_textures_diffuse);
-  m_renderer.set_uniform_arr("textures_normal", m_textures_normal);
-  glDisable(GL_CULL_FACE);
-  m_renderer.draw(u);
-  glEnable(GL_CULL_FACE);
+  auto draw = [](void* context, const void* data, size_t) {
+    DoorsRenderer& renderer = *static_cast<DoorsRenderer*>(context);
+    renderer.m_renderer.set_uniform_arr("textures_diffuse", renderer.m_textures_diffuse);
+    renderer.m_renderer.set_uniform_arr("textures_normal", renderer.m_textures_normal);
+    renderer.m_renderer.draw(*static_cast<const Uniforms*>(data));
+  };
+  queue.submit(state, { draw, this, &u, 0 });
 }
 
 void DoorsRenderer::free() {
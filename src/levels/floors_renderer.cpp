@@ -21,20 +21,30 @@ FloorsRenderer::FloorsRenderer(const ShadersFactory& shaders_factory, const Text
   calculate_uniforms();
 }
 
-/* Called each frame before draw() */
+/* Called each frame before submit() */
 void FloorsRenderer::set_transform(const Transformation& t) {
   m_renderer.set_transform({ m_models_floors, t.view, t.projection });
+  m_renderer.set_instance_arr("normals_mats", m_normals_mats_floors);
+  m_renderer.set_instance_arr("textures_indices", m_textures_indices);
 }
 
 /**
  * Draw two horizontal surfaces for floor & ceiling
- * Supports instancing
+ * Supports instancing (camera always between them, so their depth is zero)
  */
-void FloorsRenderer::draw(const Uniforms& uniforms) {
-  m_renderer.set_uniform_arr("normals_mats", m_normals_mats_floors);
-  m_renderer.set_uniform_arr("textures_diffuse", m_textures_diffuse);
-  m_renderer.set_uniform_arr("textures_normal", m_textures_normal);
-  m_renderer.draw(uniforms);
+void FloorsRenderer::submit(RenderQueue& queue, const Uniforms& uniforms) {
+  DrawState state;
+  state.program = m_renderer.get_program();
+  state.texture = m_tex_floor_diffuse.id;
+  state.vao = queue.get_vao(&m_renderer);
+
+  auto draw = [](void* context, const void* data, size_t) {
+    FloorsRenderer& renderer = *static_cast<FloorsRenderer*>(context);
+    renderer.m_renderer.set_uniform_arr("textures_diffuse", renderer.m_textures_diffuse);
+    renderer.m_renderer.set_uniform_arr("textures_normal", renderer.m_textures_normal);
+    renderer.m_renderer.draw(*static_cast<const Uniforms*>(data));
+  };
+  queue.submit(state, { draw, this, &uniforms, 0 });
 }
 
 /**
@@ -45,8 +55,9 @@ void FloorsRenderer::calculate_uniforms() {
   bool are_floor[] = { true, false };
   m_models_floors.resize(m_n_floors);
   m_normals_mats_floors.resize(m_n_floors);
-  m_textures_diffuse.resize(m_n_floors);
-  m_textures_normal.resize(m_n_floors);
+  m_textures_indices.resize(m_n_floors);
+  m_textures_diffuse = { m_tex_floor_diffuse, m_tex_ceiling_diffuse };
+  m_textures_normal = { m_tex_floor_normal, m_tex_ceiling_normal };
 
   for (size_t i_floor = 0; i_floor < m_n_floors; ++i_floor) {
     bool is_floor = are_floor[i_floor];
@@ -70,8 +81,7 @@ void FloorsRenderer::calculate_uniforms() {
 
     m_models_floors[i_floor] = model;
     m_normals_mats_floors[i_floor] = normal_mat;
-    m_textures_diffuse[i_floor] = is_floor ? m_tex_floor_diffuse : m_tex_ceiling_diffuse;
-    m_textures_normal[i_floor] = is_floor ? m_tex_floor_normal : m_tex_ceiling_normal;
+    m_textures_indices[i_floor] = is_floor ? 0 : 1;
   }
 }
 
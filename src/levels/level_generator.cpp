@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <glm/glm.hpp>
+
+#include "levels/level_generator.hpp"
+#include "levels/tilemap.hpp"
+
+// min. # of tiles between two walls lines, & width of doors (in horiz. walls) & openings (in vert. walls)
+const unsigned int SIZE_ROOM_MIN = 6;
+const unsigned int SIZE_DOOR = 3;
+const unsigned int SIZE_OPENING = 2;
+
+// camera flies at the same height as in `assets/paths/flythrough.txt`
+const float HEIGHT_CAMERA = 2.0f;
+
+/* Map generated in ctor (too small sizes raised so that at least one room fits) */
+LevelGenerator::LevelGenerator(const Parameters& parameters):
+  m_parameters(parameters),
+  m_random(parameters.seed)
+{
+  m_parameters.n_rows = std::max(m_parameters.n_rows, SIZE_ROOM_MIN + 1);
+  m_parameters.n_cols = std::max(m_parameters.n_cols, SIZE_ROOM_MIN + 1);
+  m_rows.assign(m_parameters.n_rows, std::string(m_parameters.n_cols, (char) Tilemap::Tiles::SPACE));
+
+  generate_walls();
+  generate_passages();
+  generate_tiles();
+  generate_props();
+}
+
+/**
+ * Grid of rooms with same aspect ratio as map, cells of last grid row without a room are merged with last room
+ * Rooms are closed at this point
+ */
+void LevelGenerator::generate_walls() {
+  const unsigned int n_rows = m_parameters.n_rows, n_cols = m_parameters.n_cols;
+  unsigned int n_grid_rows_max = (n_rows - 1) / SIZE_ROOM_MIN, n_grid_cols_max = (n_cols - 1) / SIZE_ROOM_MIN;
+  unsigned int n_rooms = std::clamp(m_parameters.n_rooms, 1u, n_grid_rows_max * n_grid_cols_max);
+
+  unsigned int n_grid_cols = std::lround(std::sqrt((double) n_rooms * (n_cols - 1) / (n_rows - 1)));
+  n_grid_cols = std::clamp(n_grid_cols, 1u, n_grid_cols_max);
+  unsigned int n_grid_rows = std::min((n_rooms + n_grid_cols - 1) / n_grid_cols, n_grid_rows_max);
+  n_grid_cols = std::min((n_rooms + n_grid_rows - 1) / n_grid_rows, n_grid_cols_max);
+  m_n_rooms = std::min(n_rooms, n_grid_rows * n_grid_cols);
+
+  for (size_t i_line = 0; i_line <= n_grid_rows; ++i_line)
+    m_rows_walls.push_back(i_line * (n_rows - 1) / n_grid_rows);
+  for (size_t i_line = 0; i_line <= n_grid_cols; ++i_line)
+    m_cols_walls.push_back(i_line * (n_cols - 1) / n_grid_cols);
+
+  m_walls_h.assign(n_rows, std::vector<bool>(n_cols, false));
+  m_walls_v.assign(n_rows, std::vector<bool>(n_cols, false));
+
+  for (unsigned int i_row : m_rows_walls) {
+    for (size_t i_col = 0; i_col + 1 < n_cols; ++i_col)
+      m_walls_h[i_row][i_col] = true;
+  }
+
+  for (unsigned int i_col : m_cols_walls) {
+    for (size_t i_row = 1; i_row < n_rows; ++i_row)
+      m_walls_v[i_row][i_col] = true;
+  }
+
+  for (size_t i_cell = m_n_rooms; i_cell < n_grid_rows * n_grid_cols; ++i_cell) {
+    unsigned int i_grid_row = i_cell / n_grid_cols, i_grid_col = i_cell % n_grid_cols;
+    for (size_t i_row = m_rows_walls[i_grid_row] + 1; i_row <= m_rows_walls[i_grid_row + 1]; ++i_row)
+      m_walls_v[i_row][m_cols_walls[i_grid_col]] = false;
+  }
+}
+
+/**
+ * Each room connected to its left or top neighbour (spanning tree rooted at first room, so all rooms are reachable),
+ * then other neighbours connected accord. to corridors density (loops in level)
+ */
+void LevelGenerator::generate_passages() {
+  const unsigned int n_grid_cols = m_cols_walls.size() - 1;
+
+  for (unsigned int i_room = 1; i_room < m_n_rooms; ++i_room) {
+    bool has_left = i_room % n_grid_cols > 0, has_top = i_room >= n_grid_cols;
+    if (has_left && (!has_top || get_random(2) == 0))
+      connect(i_room, true);
+    else
+      connect(i_room, false);
+  }
+
+  for (unsigned int i_room = 0; i_room < m_n_rooms; ++i_room) {
+    if (i_room % n_grid_cols > 0 && get_random_float() < m_parameters.density_corridors)
+      connect(i_room, true);
+    if (i_room >= n_grid_cols && get_random_float() < m_parameters.density_corridors)
+      connect(i_room, false);
+  }
+}
+
+/**
+ * Opening in vert. wall with left neighbour (vert. doors aren't rendered), or door in horiz. wall with top neighbour
+ * Passages kept away from walls corners
+ * @param is_left Connect room to its left neighbour, otherwise to its top one
+ */
+void LevelGenerator::connect(unsigned int i_room, bool is_left) {
+  const unsigned int n_grid_cols = m_cols_walls.size() - 1;
+  unsigned int i_grid_row = i_room / n_grid_cols, i_grid_col = i_room % n_grid_cols;
+  unsigned int row_top = m_rows_walls[i_grid_row], row_bottom = m_rows_walls[i_grid_row + 1];
+  unsigned int col_left = m_cols_walls[i_grid_col], col_right = m_cols_walls[i_grid_col + 1];
+
+  if (is_left) {
+    unsigned int i_row_start = row_top + 2 + get_random(row_bottom - row_top - SIZE_OPENING - 1);
+    for (size_t i_row = i_row_start; i_row < i_row_start + SIZE_OPENING; ++i_row)
+      m_walls_v[i_row][col_left] = false;
+  } else {
+    unsigned int i_col_start = col_left + 2 + get_random(col_right - col_left - SIZE_DOOR - 2);
+    for (size_t i_col = i_col_start; i_col < i_col_start + SIZE_DOOR; ++i_col) {
+      m_walls_h[row_top][i_col] = false;
+      m_rows[row_top][i_col] = (char) Tilemap::Tiles::DOOR_H;
+    }
+  }
+}
+
+/* Walls tiles from walls flags (doors already placed) */
+void LevelGenerator::generate_tiles() {
+  for (size_t i_row = 0; i_row < m_parameters.n_rows; ++i_row) {
+    for (size_t i_col = 0; i_col < m_parameters.n_cols; ++i_col) {
+      bool has_wall_h = m_walls_h[i_row][i_col], has_wall_v = m_walls_v[i_row][i_col];
+      if (has_wall_h && has_wall_v)
+        m_rows[i_row][i_col] = (char) Tilemap::Tiles::WALL_L;
+      else if (has_wall_h)
+        m_rows[i_row][i_col] = (char) Tilemap::Tiles::WALL_H;
+      else if (has_wall_v)
+        m_rows[i_row][i_col] = (char) Tilemap::Tiles::WALL_V;
+    }
+  }
+}
+
+/* Windows in outer horiz. walls, trees on free tiles & enemies at random free tiles (fewer if map is too crowded) */
+void LevelGenerator::generate_props() {
+  const unsigned int n_rows = m_parameters.n_rows, n_cols = m_parameters.n_cols;
+
+  for (unsigned int i_row : { 0u, n_rows - 1 }) {
+    for (size_t i_col = 0; i_col < n_cols; ++i_col) {
+      if (m_rows[i_row][i_col] == (char) Tilemap::Tiles::WALL_H && get_random_float() < m_parameters.density_props)
+        m_rows[i_row][i_col] = (char) Tilemap::Tiles::WINDOW;
+    }
+  }
+
+  for (size_t i_row = 0; i_row < n_rows; ++i_row) {
+    for (size_t i_col = 0; i_col < n_cols; ++i_col) {
+      if (is_free(i_row, i_col) && get_random_float() < m_parameters.density_props)
+        m_rows[i_row][i_col] = (char) Tilemap::Tiles::TREE;
+    }
+  }
+
+  unsigned int n_enemies = 0;
+  for (size_t i_attempt = 0; i_attempt < 100 * m_parameters.n_enemies && n_enemies < m_parameters.n_enemies; ++i_attempt) {
+    unsigned int i_row = get_random(n_rows), i_col = get_random(n_cols);
+    if (is_free(i_row, i_col)) {
+      m_rows[i_row][i_col] = (char) Tilemap::Tiles::ENEMMY;
+      n_enemies++;
+    }
+  }
+}
+
+/* Empty tile with no wall, door or prop around it (vert. wall on next row also borders tile) */
+bool LevelGenerator::is_free(unsigned int i_row, unsigned int i_col) const {
+  for (int i_row_neighbour = (int) i_row - 1; i_row_neighbour <= (int) i_row + 2; ++i_row_neighbour) {
+    for (int i_col_neighbour = (int) i_col - 1; i_col_neighbour <= (int) i_col + 1; ++i_col_neighbour) {
+      if (i_row_neighbour < 0 || i_col_neighbour < 0 || i_row_neighbour >= (int) m_parameters.n_rows || i_col_neighbour >= (int) m_parameters.n_cols)
+        return false;
+      if (m_rows[i_row_neighbour][i_col_neighbour] != (char) Tilemap::Tiles::SPACE)
+        return false;
+    }
+  }
+
+  return true;
+}
+
+/* Uniform integer in [0, n) from raw generator's output (distributions' algorithms differ between standard libraries) */
+unsigned int LevelGenerator::get_random(unsigned int n) {
+  return m_random() % n;
+}
+
+/* Uniform float in [0, 1) */
+float LevelGenerator::get_random_float() {
+  return m_random() / 4294967296.0;
+}
+
+const std::vector<std::string>& LevelGenerator::get_rows() const {
+  return m_rows;
+}
+
+unsigned int LevelGenerator::get_n_rooms() const {
+  return m_n_rooms;
+}
+
+/* Tilemap text file (one line per row) */
+bool LevelGenerator::save(const std::string& path) const {
+  std::ofstream file(path);
+  for (const std::string& row : m_rows)
+    file << row << '\n';
+
+  return file.good();
+}
+
+/**
+ * Camera keyframes at rooms centers, visited row by row in alternate directions (see `CameraPath`)
+ * Camera flies through walls between rooms, as path only serves to render level from many viewpoints
+ */
+bool LevelGenerator::save_camera_path(const std::string& path) const {
+  const unsigned int n_grid_cols = m_cols_walls.size() - 1;
+  std::vector<glm::vec3> positions;
+
+  for (size_t i_grid_row = 0; i_grid_row + 1 < m_rows_walls.size(); ++i_grid_row) {
+    for (size_t i = 0; i < n_grid_cols; ++i) {
+      size_t i_grid_col = (i_grid_row % 2 == 0) ? i : n_grid_cols - 1 - i;
+      if (i_grid_row * n_grid_cols + i_grid_col >= m_n_rooms)
+        continue;
+
+      float x = (m_cols_walls[i_grid_col] + m_cols_walls[i_grid_col + 1]) / 2.0f;
+      float z = (m_rows_walls[i_grid_row] + m_rows_walls[i_grid_row + 1]) / 2.0f;
+      positions.push_back(glm::vec3(x, HEIGHT_CAMERA, z));
+    }
+  }
+
+  std::ofstream file(path);
+  file << "# camera keyframes generated with level (seed " << m_parameters.seed << ")" << '\n';
+  file << "# position (x y z)  look direction (x y z)" << '\n';
+
+  for (size_t i_position = 0; i_position < positions.size(); ++i_position) {
+    // look towards next keyframe (last one looks like previous one)
+    glm::vec3 direction(1.0f, 0.0f, 0.0f);
+    if (i_position + 1 < positions.size())
+      direction = positions[i_position + 1] - positions[i_position];
+    else if (i_position > 0)
+      direction = positions[i_position] - positions[i_position - 1];
+
+    const glm::vec3& position = positions[i_position];
+    file << position.x << ' ' << position.y << ' ' << position.z << "   "
+         << direction.x << ' ' << direction.y << ' ' << direction.z << '\n';
+  }
+
+  return file.good();
+}
@@ -8,118 +8,214 @@
 #include "geometries/surface.hpp"
 #include "geometries/cube.hpp"
 #include "globals/targets.hpp"
+#include "globals/draw_stats.hpp"
+#include "profiling/profiler.hpp"
 
 /**
- * Sets positions of object tiles only once in constructor (origin at tilemap's upper-left corner)
- * Needed for collision with camera
+ * Targets parsed only once in constructor (origin at tilemap's upper-left corner),
+ * other tiles streamed by chunks around camera in `update()`
+ * @param path_tilemap Level's tilemap (e.g. generated with `generate_level` for benchmarks)
  */
-LevelRenderer::LevelRenderer(Assimp::Importer& importer, const ShadersFactory& shaders_factory, const TexturesFactory& textures_factory):
-  m_tilemap("assets/levels/map.txt"),
+LevelRenderer::LevelRenderer(AssetsLoader& assets_loader, const ShadersFactory& shaders_factory, const TexturesFactory& textures_factory, const std::string& path_tilemap):
+  m_position(0, 0, 0),
+  m_tilemap(path_tilemap),
+  m_streamer(m_tilemap, m_position, m_height),
 
   // renderers for props
   m_renderer_doors(shaders_factory, textures_factory),
   m_renderer_floors(shaders_factory, textures_factory, { m_tilemap.n_cols - 1, m_tilemap.n_rows - 1 }),
   m_renderer_walls(shaders_factory, textures_factory),
   m_renderer_windows(shaders_factory, textures_factory),
-  m_renderer_trees(shaders_factory, textures_factory, importer),
-  m_renderer_targets(shaders_factory, importer),
+  m_renderer_trees(shaders_factory, textures_factory, assets_loader),
+  m_renderer_targets(shaders_factory, assets_loader),
 
-  m_position(0, 0, 0)
+  m_has_chunks_pending(false),
+  m_is_calculating(false),
+  m_is_stopped(false)
 {
-  parse_tilemap();
-  calculate_uniforms();
-  calculate_bboxes();
+  parse_targets();
+  m_renderer_targets.calculate_uniforms();
+  m_renderer_targets.calculate_bboxes();
+
+  // started once renderers are constructed (their constants are read by background thread)
+  m_thread = std::thread(&LevelRenderer::run, this);
 }
 
-/* Only calculate world positions & angles in constructor (not in `draw()`) */
-void LevelRenderer::parse_tilemap() {
+/* Instances being calculated are finished before thread exits */
+LevelRenderer::~LevelRenderer() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_is_stopped = true;
+  }
+
+  m_condition_pending.notify_all();
+  m_thread.join();
+}
+
+/* Enemies aren't streamed as they can be shot from any distance & their state is kept in global `targets` */
+void LevelRenderer::parse_targets() {
   std::cout << "Tilemap: " << m_tilemap.n_rows << " rows x " << m_tilemap.n_cols << " cols" << '\n';
 
-  std::vector<Tilemap::Tiles> tiles_walls = {
-    Tilemap::Tiles::WALL_H, Tilemap::Tiles::WALL_V, Tilemap::Tiles::WALL_L, Tilemap::Tiles::WALL_GAMMA,
-  };
-
-  // save position of tile objects (used in `draw()`)
-  for (size_t i_row = 0; i_row < m_tilemap.n_rows; ++i_row) {
-    for (size_t i_col = 0; i_col < m_tilemap.n_cols; ++i_col) {
-      Tilemap::Tiles tile = (Tilemap::Tiles) m_tilemap.map[i_row][i_col];
-      glm::vec3 position_tile = {i_col, 0, i_row};
-      position_tile += m_position;
-
-      float angle = 0.0f;
-      TargetEntry target_entry;
-      switch (tile) {
-        case Tilemap::Tiles::WALL_H:
-          m_walls.push_back({ position_tile, WallOrientation::HORIZONTAL });
-          break;
-        case Tilemap::Tiles::WALL_V:
-          m_walls.push_back({ position_tile, WallOrientation::VERTICAL });
-          angle = glm::radians(90.0f);
-          break;
-        case Tilemap::Tiles::WALL_L:
-          m_walls.push_back({ position_tile, WallOrientation::L_SHAPED });
-          angle = glm::radians(90.0f);
-          break;
-        case Tilemap::Tiles::WALL_GAMMA:
-          m_walls.push_back({ position_tile, WallOrientation::GAMMA_SHAPED });
-          angle = glm::radians(-90.0f);
-          break;
-        case Tilemap::Tiles::ENEMMY: // non-mobile enemies
-          // world-space bbox calculated from `m_targets` local-space bbox in `set_transform()`
-          target_entry = { false, position_tile };
-          targets.push_back(target_entry);
-          continue;
-        case Tilemap::Tiles::DOOR_H:
-          m_positions_doors.push_back(position_tile);
-          break;
-        case Tilemap::Tiles::WINDOW:
-          m_positions_windows.push_back(position_tile);
-          break;
-        case Tilemap::Tiles::TREE:
-          m_positions_trees.push_back(position_tile);
-          break;
-        default:
-          break;
-      } // END CASE
-
-      // save world position for walls (for collision with camera)
-      if (std::find(tiles_walls.begin(), tiles_walls.end(), tile) != tiles_walls.end()) {
-        glm::vec3 center_local = {0.5f, 0.5f, 0.0f};
-        glm::mat4 model = glm::scale(
-          glm::rotate(
-            glm::translate(glm::mat4(1.0f), position_tile),
-            angle,
-            glm::vec3(0.0f, 1.0f, 0.0f)
-          ),
-          glm::vec3(1.0f, m_height, 1.0f)
-        );
-        glm::vec3 center_world = glm::vec3(model * glm::vec4(center_local, 1.0f));
-        positions_walls.push_back(center_world);
-      }
-    } // END TILEMAP COL
-  } // END TILEMAP ROW
+  // world-space bbox calculated from `m_targets` local-space bbox in `set_transform()`
+  for (const glm::uvec2& position : m_tilemap.find(Tilemap::Tiles::ENEMMY, m_jobs)) {
+    glm::vec3 position_tile = {position.x, 0, position.y};
+    TargetEntry target_entry = { false, position_tile + m_position };
+    targets.push_back(target_entry);
+  }
 }
 
 /**
- * Pass positions parsed from tilemap to renderers classes
- * Called from ctor (after parsing tilemap) to avoid inverting matrices in each frame
+ * Stream chunks around camera & pass instances calculated from resident ones to renderers once ready
+ * Instances are calculated on background thread (main thread keeps drawing previous ones meanwhile)
+ * @param position Camera position
+ * @param wait Block until chunks around camera are built & their instances calculated (e.g. before first frame)
+ * @return Whether renderers instances changed (`positions_walls` updated)
  */
-void LevelRenderer::calculate_uniforms() {
-  // set uniforms matrixes
-  m_renderer_targets.calculate_uniforms();
-  m_renderer_doors.calculate_uniforms(m_positions_doors);
-  m_renderer_walls.calculate_uniforms(m_walls, m_positions_windows);
-  m_renderer_trees.calculate_uniforms(m_positions_trees);
-  m_renderer_windows.calculate_uniforms(m_positions_windows);
+bool LevelRenderer::update(const glm::vec3& position, bool wait) {
+  PROFILE_ZONE("LevelRenderer::update");
+  bool has_changed = m_streamer.update(position, wait);
+
+  std::unique_ptr<Instances> instances;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // chunks not picked up yet by background thread replaced by latest ones (only last set calculated)
+    if (has_changed) {
+      m_chunks_pending = m_streamer.get_chunks();
+      m_has_chunks_pending = true;
+      m_condition_pending.notify_one();
+    }
+
+    if (wait)
+      m_condition_calculated.wait(lock, [this] { return !m_has_chunks_pending && !m_is_calculating; });
+
+    instances.swap(m_instances_calculated);
+  }
+
+  if (!instances)
+    return false;
+
+  set_instances(*instances);
+  return true;
 }
 
-/* Bboxes needed for frustum culling (calculate in ctor) */
-void LevelRenderer::calculate_bboxes() {
-  m_renderer_targets.calculate_bboxes();
-  m_renderer_walls.calculate_bboxes();
-  m_renderer_trees.calculate_bboxes(m_positions_trees);
-  m_renderer_windows.calculate_bboxes(m_positions_windows);
-  m_renderer_doors.calculate_bboxes(m_positions_doors);
+/* Background thread: calculate instances of latest resident chunks passed by `update()` */
+void LevelRenderer::run() {
+  while (true) {
+    std::vector<std::shared_ptr<const Chunk>> chunks;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition_pending.wait(lock, [this] { return m_is_stopped || m_has_chunks_pending; });
+      if (m_is_stopped)
+        return;
+
+      chunks.swap(m_chunks_pending);
+      m_has_chunks_pending = false;
+      m_is_calculating = true;
+    }
+
+    std::unique_ptr<Instances> instances = calculate_instances(chunks);
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_instances_calculated = std::move(instances);
+      m_is_calculating = false;
+    }
+
+    m_condition_calculated.notify_all();
+  }
+}
+
+/**
+ * Entries of resident chunks gathered (allocated once), then matrices, bboxes & BVHs of renderers,
+ * & rooms & portals labeled over tiles of resident chunks (doors & windows bboxes calculated before)
+ * Only reads renderers constants, tilemap & chunks (all immutable), so it runs off main thread
+ */
+std::unique_ptr<LevelRenderer::Instances> LevelRenderer::calculate_instances(const std::vector<std::shared_ptr<const Chunk>>& chunks) const {
+  PROFILE_ZONE("LevelRenderer::calculate_instances");
+  std::unique_ptr<Instances> instances = std::make_unique<Instances>();
+  instances->chunks = chunks;
+  instances->size_chunks = 0;
+
+  TilesEntries::Counts counts;
+  for (const std::shared_ptr<const Chunk>& chunk : chunks) {
+    counts.n_walls += chunk->walls.size();
+    counts.n_doors += chunk->positions_doors.size();
+    counts.n_trees += chunk->positions_trees.size();
+    counts.n_windows += chunk->positions_windows.size();
+    instances->size_chunks += chunk->get_size();
+  }
+
+  TilesEntries entries;
+  entries.walls.reserve(counts.n_walls);
+  entries.positions_doors.reserve(counts.n_doors);
+  entries.positions_trees.reserve(counts.n_trees);
+  entries.positions_windows.reserve(counts.n_windows);
+  entries.positions_walls.reserve(counts.n_walls);
+  for (const std::shared_ptr<const Chunk>& chunk : chunks) {
+    entries.walls.insert(entries.walls.end(), chunk->walls.begin(), chunk->walls.end());
+    entries.positions_doors.insert(entries.positions_doors.end(), chunk->positions_doors.begin(), chunk->positions_doors.end());
+    entries.positions_trees.insert(entries.positions_trees.end(), chunk->positions_trees.begin(), chunk->positions_trees.end());
+    entries.positions_windows.insert(entries.positions_windows.end(), chunk->positions_windows.begin(), chunk->positions_windows.end());
+    entries.positions_walls.insert(entries.positions_walls.end(), chunk->positions_walls.begin(), chunk->positions_walls.end());
+  }
+
+  instances->positions_walls = std::move(entries.positions_walls);
+  instances->doors = m_renderer_doors.calculate_instances(entries.positions_doors);
+  instances->walls = m_renderer_walls.calculate_instances(entries.walls, entries.positions_windows);
+  instances->trees = m_renderer_trees.calculate_instances(entries.positions_trees);
+  instances->windows = m_renderer_windows.calculate_instances(entries.positions_windows);
+
+  if (!chunks.empty()) {
+    glm::ivec2 coords_min = chunks.front()->coords, coords_max = chunks.front()->coords;
+    for (const std::shared_ptr<const Chunk>& chunk : chunks) {
+      coords_min = glm::min(coords_min, chunk->coords);
+      coords_max = glm::max(coords_max, chunk->coords);
+    }
+
+    glm::ivec2 tile_min = coords_min * (int) Chunk::SIZE;
+    glm::ivec2 tile_max = glm::min((coords_max + 1) * (int) Chunk::SIZE, glm::ivec2(m_tilemap.n_cols, m_tilemap.n_rows));
+    instances->portals.build(m_tilemap, tile_min, tile_max, m_position, instances->doors.bboxes, instances->windows.bboxes);
+  }
+
+  instances->size = instances->positions_walls.capacity() * sizeof(glm::vec3) +
+    instances->doors.get_size() + instances->walls.get_size() + instances->trees.get_size() + instances->windows.get_size() +
+    instances->portals.get_size();
+
+  return instances;
+}
+
+/**
+ * Instances moved into renderers on main thread (between frames), no matrix inverted or BVH built here
+ * Their size is counted against streamer's budget along with chunks
+ */
+void LevelRenderer::set_instances(Instances& instances) {
+  PROFILE_ZONE("LevelRenderer::set_instances");
+  m_chunks = std::move(instances.chunks);
+  positions_walls = std::move(instances.positions_walls);
+  m_renderer_doors.set_instances(instances.doors);
+  m_renderer_walls.set_instances(instances.walls);
+  m_renderer_trees.set_instances(instances.trees);
+  m_renderer_windows.set_instances(instances.windows);
+  m_portals = std::move(instances.portals);
+  m_streamer.set_size_renderers(instances.size, instances.size_chunks);
+}
+
+/**
+ * PVS baked in resident chunk containing camera
+ * Everything visible if camera is outside of level or its chunk isn't streamed yet
+ */
+Pvs LevelRenderer::get_pvs(const glm::vec3& position) const {
+  glm::vec3 position_tilemap = position - m_position;
+  if (position_tilemap.x < 0 || position_tilemap.z < 0)
+    return Pvs();
+
+  glm::ivec2 cell(position_tilemap.x / Pvs::SIZE_CELL, position_tilemap.z / Pvs::SIZE_CELL);
+  glm::ivec2 coords = cell / (int) Chunk::N_CELLS;
+  auto it_chunk = std::find_if(m_chunks.begin(), m_chunks.end(), [&coords](const std::shared_ptr<const Chunk>& chunk) {
+    return chunk->coords == coords;
+  });
+
+  return (it_chunk != m_chunks.end()) ? (*it_chunk)->get_pvs(cell, m_position) : Pvs();
 }
 
 /**
@@ -128,14 +224,52 @@ void LevelRenderer::calculate_bboxes() {
  * @param frustum Used to avoid drawing objects outside frustum (optimize fps)
  */
 void LevelRenderer::set_transform(const Transformation& t, const Frustum& frustum) {
-  // set positions of props in appropriate classes
-  // Support frustum culling (by filtering out models mats outside frustum)
-  m_renderer_targets.set_transform(t, frustum);
+  PROFILE_ZONE("LevelRenderer::set_transform");
+
+  // camera position in world space (translation of inverse of view matrix), also used for depth of draw packets
+  m_position_camera = glm::inverse(t.view)[3];
+  Pvs pvs = get_pvs(m_position_camera);
+  m_portals.traverse(t.view, t.projection, frustum);
+  m_occlusion.clear(t.view, t.projection);
+  Visibility visibility = { pvs, m_portals, m_occlusion };
+
+  // Support frustum, PVS, portal & occlusion culling (by filtering out models mats outside frustum or hidden by walls)
+  // walls first as they fill occlusion buffer, then other renderers (independent) culled in parallel jobs
+  {
+    PROFILE_ZONE("LevelRenderer::cull");
+    m_renderer_walls.cull(frustum, visibility, m_jobs);
+
+    auto cull_targets = [&]() { m_renderer_targets.cull(t, frustum, visibility); };
+    auto cull_doors = [&]() { m_renderer_doors.cull(frustum, visibility, m_jobs); };
+    auto cull_trees = [&]() { m_renderer_trees.cull(t, frustum, visibility, m_jobs); };
+    auto cull_windows = [&]() { m_renderer_windows.cull(frustum, visibility, m_jobs); };
+
+    JobSystem::Counter counter(0);
+    m_jobs.run(cull_targets, counter);
+    m_jobs.run(cull_doors, counter);
+    m_jobs.run(cull_trees, counter);
+    m_jobs.run(cull_windows, counter);
+    m_jobs.wait(counter);
+  }
+
+  // set positions of props in appropriate classes (instances buffers filled on gl thread)
+  m_renderer_walls.set_transform(t);
+  m_renderer_targets.set_transform(t);
   m_renderer_floors.set_transform(t);
-  m_renderer_walls.set_transform(t, frustum);
-  m_renderer_doors.set_transform(t, frustum);
-  m_renderer_trees.set_transform(t, frustum);
-  m_renderer_windows.set_transform(t, frustum);
+  m_renderer_doors.set_transform(t);
+  m_renderer_trees.set_transform(t);
+  m_renderer_windows.set_transform(t);
+
+  OcclusionBuffer::Stats stats = m_occlusion.get_stats();
+  draw_stats.add_occlusion(stats.n_tests, stats.n_occluded);
+}
+
+/**
+ * Debug dump of occlusion buffer rasterized on last frame
+ * @param path Binary PGM image
+ */
+bool LevelRenderer::save_occlusion_buffer(const std::string& path) const {
+  return m_occlusion.save(path);
 }
 
 /**
@@ -143,17 +277,34 @@ void LevelRenderer::set_transform(const Transformation& t, const Frustum& frustu
  * @param uniforms Uniforms passed to shader (i.e. lights & camera pos.)
  */
 void LevelRenderer::draw(const Uniforms& u) {
-  m_renderer_targets.draw(u);
-  m_renderer_doors.draw(u);
-  m_renderer_floors.draw(u);
-  m_renderer_trees.draw(u);
+  PROFILE_ZONE("LevelRenderer::draw");
+
+  // packets sorted by state (program, texture, vao) by render queue, whatever the order they're submitted in
+  m_renderer_targets.submit(m_queue, u, m_position_camera);
+  m_renderer_doors.submit(m_queue, u, m_position_camera);
+  m_renderer_floors.submit(m_queue, u);
+  m_renderer_trees.submit(m_queue, u, m_position_camera);
 
-  // draw full walls & two walls below/above them
-  m_renderer_walls.draw();
-  m_renderer_walls.draw_walls_around_window();
+  // full walls & two walls below/above windows
+  m_renderer_walls.submit(m_queue, m_position_camera);
+
+  // translucent: drawn last (from back to front) for blending transparent window with objects in bg
+  m_renderer_windows.submit(m_queue, m_position_camera);
+
+  m_queue.flush();
+}
+
+/**
+ * Closest alive target hit by ray, unless a wall stands in front of it
+ * @return index of target in global `targets` or -1 if none
+ */
+int LevelRenderer::raycast_targets(const Ray& ray) const {
+  float distance_target;
+  int i_target = m_renderer_targets.raycast(ray, distance_target);
+  if (i_target == BoundingBox::NO_COLLISION || m_renderer_walls.raycast(ray) < distance_target)
+    return BoundingBox::NO_COLLISION;
 
-  // called last for blending transparent window with objects in bg
-  m_renderer_windows.draw();
+  return i_target;
 }
 
 /* Renderers lifecycle managed by other classes */
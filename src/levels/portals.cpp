@@ -0,0 +1,285 @@
+#include <algorithm>
+#include <cmath>
+
+#include "levels/portals.hpp"
+#include "profiling/profiler.hpp"
+
+namespace {
+  // rectangle of hidden rooms (min > max) & of whole screen in NDC
+  const glm::vec4 RECT_EMPTY(1.0f, 1.0f, -1.0f, -1.0f);
+  const glm::vec4 RECT_SCREEN(-1.0f, -1.0f, 1.0f, 1.0f);
+
+  // room of tiles outside resident ones
+  const unsigned int NO_ROOM = -1;
+
+  /**
+   * Room/portal pair not traversed yet, traversed with room's rectangle at the time (narrowed),
+   * or with portal's whole rectangle once room's one grew after that (conservative, never traversed again)
+   */
+  enum Traversal : unsigned char { NOT_TRAVERSED, TRAVERSED_NARROWED, TRAVERSED_WHOLE };
+
+  bool is_empty(const glm::vec4& rect) {
+    return rect.x >= rect.z || rect.y >= rect.w;
+  }
+
+  /* Whether doors or windows tile is an edge along z = i_row (like horiz. walls) */
+  bool has_portal(const Tilemap& tilemap, int i_row, int i_col) {
+    Tilemap::Tiles tile = tilemap.get_tile(i_row, i_col);
+    return tile == Tilemap::Tiles::DOOR_H || tile == Tilemap::Tiles::WINDOW;
+  }
+
+  /**
+   * Screen rectangle of bbox in NDC, whole screen if it crosses camera's plane, empty if it's behind camera
+   * @param view_projection Projection matrix times view matrix
+   */
+  glm::vec4 project(const BoundingBox& bbox, const glm::mat4& view_projection) {
+    glm::vec4 rect = RECT_EMPTY;
+    unsigned int n_corners_behind = 0;
+
+    for (size_t i_corner = 0; i_corner < 8; ++i_corner) {
+      glm::vec3 corner((i_corner & 1) ? bbox.max.x : bbox.min.x, (i_corner & 2) ? bbox.max.y : bbox.min.y, (i_corner & 4) ? bbox.max.z : bbox.min.z);
+      glm::vec4 clip = view_projection * glm::vec4(corner, 1.0f);
+      if (clip.w <= 1e-4f) {
+        n_corners_behind++;
+        continue;
+      }
+
+      glm::vec2 ndc(clip.x / clip.w, clip.y / clip.w);
+      rect = glm::vec4(std::min(rect.x, ndc.x), std::min(rect.y, ndc.y), std::max(rect.z, ndc.x), std::max(rect.w, ndc.y));
+    }
+
+    if (n_corners_behind == 8)
+      return RECT_EMPTY;
+    if (n_corners_behind > 0)
+      return RECT_SCREEN;
+
+    return rect;
+  }
+}
+
+/* Inactive until built (everything visible) */
+Portals::Portals():
+  m_tile_min(0, 0),
+  m_size(0, 0),
+  m_position_level(0.0f),
+  m_n_rooms(0),
+  m_is_active(false),
+  m_n_rooms_visible(0)
+{
+}
+
+/**
+ * Label rooms by flood fill (tiles connected without crossing a wall, door, or window) & link them with portals
+ * Called when resident chunks change
+ * @param tile_min Upper-left resident tile (column & row)
+ * @param tile_max Past lower-right resident tile
+ * @param bboxes_doors Rectangles of doors in world space (see `DoorsRenderer`)
+ * @param bboxes_windows Rectangles of windows in world space (see `WindowsRenderer`)
+ */
+void Portals::build(const Tilemap& tilemap, const glm::ivec2& tile_min, const glm::ivec2& tile_max, const glm::vec3& position_level,
+                    const std::vector<BoundingBox>& bboxes_doors, const std::vector<BoundingBox>& bboxes_windows) {
+  PROFILE_ZONE("Portals::build");
+  m_tile_min = tile_min;
+  m_size = tile_max - tile_min;
+  m_position_level = position_level;
+  m_is_active = false;
+  m_rooms.assign(m_size.x * m_size.y, NO_ROOM);
+  m_n_rooms = 0;
+
+  // edges between tile & its four neighbours blocked by walls or portals (right, left, down, up)
+  auto is_blocked = [&tilemap](int i_row, int i_col, unsigned int i_neighbour) {
+    switch (i_neighbour) {
+      case 0: return tilemap.has_wall_v(i_row, i_col + 1);
+      case 1: return tilemap.has_wall_v(i_row, i_col);
+      case 2: return tilemap.has_wall_h(i_row + 1, i_col) || has_portal(tilemap, i_row + 1, i_col);
+      default: return tilemap.has_wall_h(i_row, i_col) || has_portal(tilemap, i_row, i_col);
+    }
+  };
+  const glm::ivec2 OFFSETS[4] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+
+  std::vector<glm::ivec2> stack;
+  for (int i_tile = 0; i_tile < m_size.x * m_size.y; ++i_tile) {
+    if (m_rooms[i_tile] != NO_ROOM)
+      continue;
+
+    m_rooms[i_tile] = m_n_rooms;
+    stack.push_back(glm::ivec2(i_tile % m_size.x, i_tile / m_size.x));
+
+    while (!stack.empty()) {
+      glm::ivec2 tile = stack.back();
+      stack.pop_back();
+
+      for (unsigned int i_neighbour = 0; i_neighbour < 4; ++i_neighbour) {
+        glm::ivec2 neighbour = tile + OFFSETS[i_neighbour];
+        if (neighbour.x < 0 || neighbour.y < 0 || neighbour.x >= m_size.x || neighbour.y >= m_size.y ||
+            m_rooms[neighbour.y * m_size.x + neighbour.x] != NO_ROOM ||
+            is_blocked(tile.y + m_tile_min.y, tile.x + m_tile_min.x, i_neighbour))
+          continue;
+
+        m_rooms[neighbour.y * m_size.x + neighbour.x] = m_n_rooms;
+        stack.push_back(neighbour);
+      }
+    }
+
+    m_n_rooms++;
+  }
+
+  // portals between rooms in tiles above & below them (doors & windows lie on their tile's upper edge)
+  m_portals.clear();
+  for (const std::vector<BoundingBox>* bboxes : { &bboxes_doors, &bboxes_windows }) {
+    for (const BoundingBox& bbox : *bboxes) {
+      int i_col = std::floor(bbox.center.x - m_position_level.x);
+      int i_row = std::round(bbox.center.z - m_position_level.z);
+      unsigned int room_above = get_room(i_row - 1, i_col), room_below = get_room(i_row, i_col);
+      if (room_above != NO_ROOM && room_below != NO_ROOM && room_above != room_below)
+        m_portals.push_back({ bbox, { room_above, room_below } });
+    }
+  }
+
+  // portals of each room
+  m_offsets_rooms.assign(m_n_rooms + 1, 0);
+  for (const Portal& portal : m_portals) {
+    m_offsets_rooms[portal.rooms[0] + 1]++;
+    m_offsets_rooms[portal.rooms[1] + 1]++;
+  }
+  for (size_t i_room = 0; i_room < m_n_rooms; ++i_room)
+    m_offsets_rooms[i_room + 1] += m_offsets_rooms[i_room];
+
+  m_portals_rooms.resize(2 * m_portals.size());
+  std::vector<unsigned int> n_portals_rooms(m_n_rooms, 0);
+  for (size_t i_portal = 0; i_portal < m_portals.size(); ++i_portal) {
+    for (unsigned int room : m_portals[i_portal].rooms)
+      m_portals_rooms[m_offsets_rooms[room] + n_portals_rooms[room]++] = i_portal;
+  }
+}
+
+/* Room of tile (`NO_ROOM` if not resident) */
+unsigned int Portals::get_room(int i_row, int i_col) const {
+  int x = i_col - m_tile_min.x, z = i_row - m_tile_min.y;
+  if (x < 0 || z < 0 || x >= m_size.x || z >= m_size.y)
+    return NO_ROOM;
+
+  return m_rooms[z * m_size.x + x];
+}
+
+/**
+ * Traverse rooms from camera's one through portals, each room seen through union of rectangles of portals reaching it
+ * (intersected with rectangle of room they're seen from), called each frame before `is_visible()`
+ * Each room/portal pair traversed at most twice (see `Traversal`), so traversal ends without dropping rooms reached
+ * @param frustum Camera's frustum, narrowed for each visible room
+ */
+void Portals::traverse(const glm::mat4& view, const glm::mat4& projection, const Frustum& frustum) {
+  PROFILE_ZONE("Portals::traverse");
+  glm::vec3 position_camera = glm::inverse(view)[3];
+  glm::vec3 position_tilemap = position_camera - m_position_level;
+  unsigned int room_camera = get_room(std::floor(position_tilemap.z), std::floor(position_tilemap.x));
+  m_is_active = room_camera != NO_ROOM;
+  m_n_rooms_visible = 0;
+  if (!m_is_active)
+    return;
+
+  glm::mat4 view_projection = projection * view;
+  m_rects.assign(m_n_rooms, RECT_EMPTY);
+  m_rects[room_camera] = RECT_SCREEN;
+
+  // room queued once at a time, so it's only dequeued again after its rectangle grew
+  m_traversals.assign(m_portals_rooms.size(), NOT_TRAVERSED);
+  m_is_queued.assign(m_n_rooms, false);
+  std::vector<unsigned int> queue = { room_camera };
+  m_is_queued[room_camera] = true;
+
+  for (size_t i_queue = 0; i_queue < queue.size(); ++i_queue) {
+    unsigned int room = queue[i_queue];
+    glm::vec4 rect_room = m_rects[room];
+    m_is_queued[room] = false;
+
+    for (size_t i_pair = m_offsets_rooms[room]; i_pair < m_offsets_rooms[room + 1]; ++i_pair) {
+      if (m_traversals[i_pair] == TRAVERSED_WHOLE)
+        continue;
+
+      const Portal& portal = m_portals[m_portals_rooms[i_pair]];
+      unsigned int room_other = (portal.rooms[0] == room) ? portal.rooms[1] : portal.rooms[0];
+
+      // portal's part seen from room (whole portal if pair was traversed before room's rectangle grew)
+      glm::vec4 rect_portal = project(portal.bbox, view_projection);
+      if (m_traversals[i_pair] == NOT_TRAVERSED) {
+        rect_portal = glm::vec4(std::max(rect_portal.x, rect_room.x), std::max(rect_portal.y, rect_room.y),
+                                std::min(rect_portal.z, rect_room.z), std::min(rect_portal.w, rect_room.w));
+      }
+      if (is_empty(rect_portal))
+        continue;
+
+      m_traversals[i_pair] = (m_traversals[i_pair] == NOT_TRAVERSED) ? TRAVERSED_NARROWED : TRAVERSED_WHOLE;
+
+      // room traversed again only if it's seen through a larger rectangle
+      glm::vec4 rect_other = m_rects[room_other];
+      glm::vec4 rect_union = is_empty(rect_other) ? rect_portal :
+        glm::vec4(std::min(rect_portal.x, rect_other.x), std::min(rect_portal.y, rect_other.y),
+                  std::max(rect_portal.z, rect_other.z), std::max(rect_portal.w, rect_other.w));
+      if (rect_union == rect_other)
+        continue;
+
+      m_rects[room_other] = rect_union;
+      if (!m_is_queued[room_other]) {
+        queue.push_back(room_other);
+        m_is_queued[room_other] = true;
+      }
+    }
+  }
+
+  m_frustums.assign(m_n_rooms, frustum);
+  for (size_t i_room = 0; i_room < m_n_rooms; ++i_room) {
+    if (is_empty(m_rects[i_room]))
+      continue;
+
+    m_frustums[i_room] = frustum.narrow(view_projection, m_rects[i_room]);
+    m_n_rooms_visible++;
+  }
+}
+
+/**
+ * Whether bbox is inside narrowed frustum of a visible room it touches
+ * Rooms touched are those of tiles under bbox grown by half a tile (walls, doors & windows lie between two rooms)
+ * Visible if camera or bbox isn't within resident tiles (not enough information)
+ */
+bool Portals::is_visible(const BoundingBox& bbox) const {
+  if (!m_is_active)
+    return true;
+
+  int x_min = std::floor(bbox.min.x - m_position_level.x - 0.5f), x_max = std::floor(bbox.max.x - m_position_level.x + 0.5f);
+  int z_min = std::floor(bbox.min.z - m_position_level.z - 0.5f), z_max = std::floor(bbox.max.z - m_position_level.z + 0.5f);
+  if (x_min < m_tile_min.x || z_min < m_tile_min.y || x_max >= m_tile_min.x + m_size.x || z_max >= m_tile_min.y + m_size.y)
+    return true;
+
+  unsigned int room_previous = NO_ROOM;
+  for (int z = z_min; z <= z_max; ++z) {
+    for (int x = x_min; x <= x_max; ++x) {
+      unsigned int room = m_rooms[(z - m_tile_min.y) * m_size.x + (x - m_tile_min.x)];
+      if (room == room_previous)
+        continue;
+
+      room_previous = room;
+      if (!is_empty(m_rects[room]) && m_frustums[room].intersect(bbox) != Intersection::OUTSIDE)
+        return true;
+    }
+  }
+
+  return false;
+}
+
+unsigned int Portals::get_n_rooms() const {
+  return m_n_rooms;
+}
+
+/* Bytes allocated by rooms labels & portals (counted against chunks streamer's memory budget) */
+size_t Portals::get_size() const {
+  return m_rooms.capacity() * sizeof(unsigned int) + m_portals.capacity() * sizeof(Portal) +
+    (m_offsets_rooms.capacity() + m_portals_rooms.capacity()) * sizeof(unsigned int) +
+    m_rects.capacity() * sizeof(glm::vec4) + m_frustums.capacity() * sizeof(Frustum) +
+    m_traversals.capacity() + m_is_queued.capacity() / 8;
+}
+
+/* Rooms reached from camera's room on last traversal */
+unsigned int Portals::get_n_rooms_visible() const {
+  return m_n_rooms_visible;
+}
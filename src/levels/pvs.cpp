@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cmath>
+
+#include "levels/pvs.hpp"
+
+namespace {
+  // # of rays origins along each side of a cell (more origins barely change result as it's dilated)
+  const unsigned int N_SAMPLES = 2;
+
+  /**
+   * March ray from `start` to `end` on xz-plane across tiles (Amanatides & Woo) until it crosses an edge with a wall
+   * Walls are considered infinitely thin & as high as the ceiling (camera assumed to stay below it)
+   * @param visit Called with each tile reached by ray (column & row)
+   */
+  template <typename Visit>
+  void march(const Tilemap& tilemap, const glm::vec2& start, const glm::vec2& end, Visit visit) {
+    glm::vec2 direction = end - start;
+    glm::ivec2 tile(std::floor(start.x), std::floor(start.y));
+    glm::ivec2 tile_end(std::floor(end.x), std::floor(end.y));
+    glm::ivec2 step(direction.x > 0 ? 1 : -1, direction.y > 0 ? 1 : -1);
+
+    // ray's parameter at next vert. (x) & horiz. (z) edges & between two consecutive ones
+    float t_delta_x = (direction.x != 0) ? std::abs(1.0f / direction.x) : INFINITY;
+    float t_delta_z = (direction.y != 0) ? std::abs(1.0f / direction.y) : INFINITY;
+    float t_max_x = (direction.x != 0) ? ((step.x > 0 ? tile.x + 1 : tile.x) - start.x) / direction.x : INFINITY;
+    float t_max_z = (direction.y != 0) ? ((step.y > 0 ? tile.y + 1 : tile.y) - start.y) / direction.y : INFINITY;
+
+    visit(tile);
+    unsigned int n_steps = std::abs(tile_end.x - tile.x) + std::abs(tile_end.y - tile.y);
+
+    for (size_t i_step = 0; i_step < n_steps; ++i_step) {
+      if (t_max_x < t_max_z) {
+        if (tilemap.has_wall_v(tile.y, step.x > 0 ? tile.x + 1 : tile.x))
+          return;
+
+        tile.x += step.x;
+        t_max_x += t_delta_x;
+      } else {
+        if (tilemap.has_wall_h(step.y > 0 ? tile.y + 1 : tile.y, tile.x))
+          return;
+
+        tile.y += step.y;
+        t_max_z += t_delta_z;
+      }
+
+      visit(tile);
+    }
+  }
+}
+
+/**
+ * Cells visible from `cell`: rays cast from samples in cell towards each tile on border of window of cells around it,
+ * cells crossed by rays before they hit a wall are visible
+ * Result is dilated by one cell, so views through openings narrower than rays spacing aren't missed (conservative)
+ * @param cell Column & row of cell in tilemap (in cells not tiles)
+ */
+Pvs::Cells Pvs::bake(const Tilemap& tilemap, const glm::ivec2& cell) {
+  const int SIDE = 2 * RADIUS + 1;
+  const int SIZE = SIZE_CELL;
+  glm::ivec2 n_cells((tilemap.n_cols + SIZE - 1) / SIZE, (tilemap.n_rows + SIZE - 1) / SIZE);
+
+  // window's tiles (origin at its upper-left corner)
+  glm::ivec2 origin_window = (cell - RADIUS) * SIZE;
+  const int SIDE_TILES = SIDE * SIZE;
+
+  Cells cells;
+  auto visit = [&](const glm::ivec2& tile) {
+    glm::ivec2 tile_window = tile - origin_window;
+    cells[(tile_window.y / SIZE) * SIDE + tile_window.x / SIZE] = true;
+  };
+
+  // rays targets at centers of tiles on window's border
+  std::vector<glm::vec2> targets;
+  for (int i_tile = 0; i_tile < SIDE_TILES; ++i_tile) {
+    targets.insert(targets.end(), {
+      glm::vec2(i_tile, 0), glm::vec2(i_tile, SIDE_TILES - 1),
+      glm::vec2(0, i_tile), glm::vec2(SIDE_TILES - 1, i_tile)
+    });
+  }
+
+  for (size_t i_sample = 0; i_sample < N_SAMPLES * N_SAMPLES; ++i_sample) {
+    glm::ivec2 tile_sample = cell * SIZE + glm::ivec2(i_sample % N_SAMPLES, i_sample / N_SAMPLES) * (SIZE / (int) N_SAMPLES) + SIZE / (2 * (int) N_SAMPLES);
+    glm::vec2 start = glm::vec2(tile_sample) + 0.5f;
+
+    for (const glm::vec2& target : targets)
+      march(tilemap, start, glm::vec2(origin_window) + target + 0.5f, visit);
+  }
+
+  // cell & its neighbours always visible (camera can be anywhere inside cell)
+  for (int dz = -1; dz <= 1; ++dz) {
+    for (int dx = -1; dx <= 1; ++dx)
+      cells[(dz + RADIUS) * SIDE + (dx + RADIUS)] = true;
+  }
+
+  // dilated by one cell (window's cells beyond map never visible)
+  Cells cells_dilated;
+  for (int z = 0; z < SIDE; ++z) {
+    for (int x = 0; x < SIDE; ++x) {
+      glm::ivec2 cell_other = cell + glm::ivec2(x, z) - RADIUS;
+      if (cell_other.x < 0 || cell_other.y < 0 || cell_other.x >= n_cells.x || cell_other.y >= n_cells.y)
+        continue;
+
+      for (int z_neighbour = std::max(z - 1, 0); z_neighbour <= std::min(z + 1, SIDE - 1) && !cells_dilated[z * SIDE + x]; ++z_neighbour) {
+        for (int x_neighbour = std::max(x - 1, 0); x_neighbour <= std::min(x + 1, SIDE - 1); ++x_neighbour)
+          cells_dilated[z * SIDE + x] = cells_dilated[z * SIDE + x] || cells[z_neighbour * SIDE + x_neighbour];
+      }
+    }
+  }
+
+  return cells_dilated;
+}
+
+/* Everything visible (no culling) */
+Pvs::Pvs():
+  m_is_baked(false),
+  m_cell(0, 0),
+  m_position_level(0.0f)
+{
+}
+
+/**
+ * @param cell Camera's cell
+ * @param cells Cells visible from camera's cell
+ * @param position_level Offset of tilemap's origin in world space
+ */
+Pvs::Pvs(const glm::ivec2& cell, const Cells& cells, const glm::vec3& position_level):
+  m_is_baked(true),
+  m_cell(cell),
+  m_cells(cells),
+  m_position_level(position_level)
+{
+}
+
+/* Whether bbox overlaps a visible cell on xz-plane (cells beyond `RADIUS` are never visible) */
+bool Pvs::is_visible(const BoundingBox& bbox) const {
+  if (!m_is_baked)
+    return true;
+
+  const int SIDE = 2 * RADIUS + 1;
+  int x_min = std::max((int) std::floor((bbox.min.x - m_position_level.x) / SIZE_CELL) - m_cell.x, -RADIUS);
+  int x_max = std::min((int) std::floor((bbox.max.x - m_position_level.x) / SIZE_CELL) - m_cell.x, RADIUS);
+  int z_min = std::max((int) std::floor((bbox.min.z - m_position_level.z) / SIZE_CELL) - m_cell.y, -RADIUS);
+  int z_max = std::min((int) std::floor((bbox.max.z - m_position_level.z) / SIZE_CELL) - m_cell.y, RADIUS);
+
+  for (int dz = z_min; dz <= z_max; ++dz) {
+    for (int dx = x_min; dx <= x_max; ++dx) {
+      if (m_cells[(dz + RADIUS) * SIDE + (dx + RADIUS)])
+        return true;
+    }
+  }
+
+  return false;
+}
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <algorithm>
+#include <limits>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/matrix_inverse.hpp>
 
@@ -12,9 +13,8 @@
  * Targets are generated inside level accord. to tilemap
  * @param position Position extracted from tilemap
  */
-TargetsRenderer::TargetsRenderer(const ShadersFactory& shaders_factory, Assimp::Importer& importer):
-  m_model3d("assets/models/samurai/samurai.obj", importer),
-  m_renderer(shaders_factory["texture"], m_model3d, Attributes::get({"position", "normal", "texture_coord", "tangent"})),
+TargetsRenderer::TargetsRenderer(const ShadersFactory& shaders_factory, AssetsLoader& assets_loader):
+  m_renderer(shaders_factory["texture"], assets_loader, "assets/models/samurai/samurai.obj", Attributes::get({"position", "normal", "texture_coord", "tangent"})),
   m_bounding_box(m_renderer.get_positions())
 {
 }
@@ -38,6 +38,8 @@ void TargetsRenderer::calculate_uniforms() {
 
 /* Must be called after calculate_uniforms() */
 void TargetsRenderer::calculate_bboxes() {
+  std::vector<BoundingBox> bboxes(m_models.size());
+
   for (size_t i_target = 0; i_target < m_models.size(); ++i_target) {
     TargetEntry& target_entry = targets[i_target];
     glm::mat4 model_target = m_models[i_target];
@@ -46,56 +48,57 @@ void TargetsRenderer::calculate_bboxes() {
     // needed for mouse intersection in MouseHandler
     target_entry.bounding_box = m_bounding_box;
     target_entry.bounding_box.transform(model_target);
+    bboxes[i_target] = target_entry.bounding_box;
   }
-}
 
-/* Keeps in uniform matrices only alive targets to avoid drawing dead ones */
-std::vector<glm::mat4> TargetsRenderer::cull_dead(const std::vector<glm::mat4>& matrices, const std::vector<TargetEntry> targets) {
-  std::vector<glm::mat4> matrices_out;
+  m_bvh = math::BVH(bboxes);
+  m_cache_frustum.invalidate();
+}
 
-  for (size_t i_target = 0; i_target < targets.size(); ++i_target) {
-    TargetEntry target_entry = targets[i_target];
+/* Alive & visible targets, with their LOD (no gl calls, so it can run as a job) */
+void TargetsRenderer::cull(const Transformation& t, const Frustum& frustum, const Visibility& visibility) {
+  // frustum culling first (with bbox radius - more accurate than with its center), copied into reused buffer
+  m_indices = frustum.cull(m_bvh, m_cache_frustum);
 
-    // check if not dead
-    if (!target_entry.is_dead) {
-      glm::mat4 mat = matrices[i_target];
-      matrices_out.push_back(mat);
-    }
-  }
+  // ignore dead targets (to avoid drawing them) & those hidden by walls (see `Visibility`)
+  m_indices.erase(std::remove_if(m_indices.begin(), m_indices.end(), [&visibility](unsigned int i_target) {
+    return targets[i_target].is_dead || !visibility.is_visible(targets[i_target].bounding_box);
+  }), m_indices.end());
 
-  return matrices_out;
+  // LOD of each target selected from its distance to camera
+  m_renderer.select_lods(t, m_models, m_indices);
 }
 
 /**
- * Delegate transform to renderer
+ * Delegate transform to renderer (on gl thread)
  * Translate target to position from tilemap
  */
-void TargetsRenderer::set_transform(const Transformation& t, const Frustum& frustum) {
-  // frustum culling first (with bbox radius - more accurate than with its center)
-  std::vector<BoundingBox> bboxes;
-  auto get_bbox = [](const auto& target) { return target.bounding_box; };
-  std::transform(targets.begin(), targets.end(), std::back_inserter(bboxes), get_bbox);
-
-  std::vector<glm::mat4> models_frustum = frustum.cull(m_models, bboxes);
-  std::vector<glm::mat4> normals_mats_frustum = frustum.cull(m_normals_mats, bboxes);
-  std::vector<TargetEntry> targets_frustum = frustum.cull(targets, bboxes);
-
-  // ignore dead targets (to avoid drawing them)
-  std::vector<glm::mat4> models = cull_dead(models_frustum, targets_frustum);
-  std::vector<glm::mat4> normals_mats = cull_dead(normals_mats_frustum, targets_frustum);
-
-  m_renderer.set_transform({ models, t.view, t.projection });
-  m_renderer.set_uniform_arr("normals_mats", normals_mats);
+void TargetsRenderer::set_transform(const Transformation& t) {
+  m_renderer.set_transform(t, m_models, m_normals_mats);
 }
 
-/* delegate drawing with OpenGL (buffers & shaders) to renderer */
-void TargetsRenderer::draw(const Uniforms& uniforms) {
-  // ignore dead targets (to avoid drawing them)
-  m_renderer.draw(uniforms);
+/* delegate drawing with OpenGL (buffers & shaders) to renderer, through render queue (dead targets already left out by `cull()`) */
+void TargetsRenderer::submit(RenderQueue& queue, const Uniforms& uniforms, const glm::vec3& position_camera) {
+  if (m_indices.empty())
+    return;
+
+  DrawState state;
+  state.depth = std::numeric_limits<float>::max();
+  for (unsigned int i_target : m_indices)
+    state.depth = std::min(state.depth, glm::length(targets[i_target].bounding_box.center - position_camera));
+
+  m_renderer.submit(queue, state, uniforms);
+}
+
+/**
+ * Closest alive target hit by ray (BVH built from all targets as they're static)
+ * @return index of target in global `targets` or -1 if none
+ */
+int TargetsRenderer::raycast(const Ray& ray, float& distance) const {
+  return m_bvh.raycast(ray, distance, [](unsigned int i_target) { return targets[i_target].is_dead; });
 }
 
 /* Free renderer (vao/vbo buffers) */
 void TargetsRenderer::free() {
-  m_model3d.free();
   m_renderer.free();
 }
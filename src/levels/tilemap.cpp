@@ -1,8 +1,116 @@
+#include <algorithm>
+#include <cstring>
+
 #include "levels/tilemap.hpp"
-#include "shader/file.hpp"
 
-Tilemap::Tilemap(const std::string& path) {
-  map = File::get_chars(path);
-  n_rows = map.size();
-  n_cols = map[0].size();
+namespace {
+  /* rows scanned by each job of `find()` */
+  const size_t N_ROWS_BAND = 256;
+}
+
+/* Rows delimited once (`n_cols` from first row like the whole map was loaded before) */
+Tilemap::Tilemap(const std::string& path):
+  m_file(path)
+{
+  size_t offset = 0;
+  while (offset < m_file.size) {
+    const char* end = static_cast<const char*>(std::memchr(m_file.data + offset, '\n', m_file.size - offset));
+    size_t offset_end = (end != nullptr) ? end - m_file.data : m_file.size;
+    size_t length = offset_end - offset;
+    if (length > 0 && m_file.data[offset_end - 1] == '\r')
+      length--;
+
+    m_offsets_rows.push_back(offset);
+    m_lengths_rows.push_back(length);
+    offset = offset_end + 1;
+  }
+
+  n_rows = m_offsets_rows.size();
+  n_cols = m_lengths_rows.empty() ? 0 : m_lengths_rows[0];
+}
+
+/* Tiles past the end of a row or outside map are empty */
+Tilemap::Tiles Tilemap::get_tile(unsigned int i_row, unsigned int i_col) const {
+  if (i_row >= n_rows || i_col >= m_lengths_rows[i_row])
+    return Tiles::SPACE;
+
+  return (Tiles) m_file.data[m_offsets_rows[i_row] + i_col];
+}
+
+/**
+ * Whether a wall lies along z = i_row from x = i_col to i_col + 1 (doors & windows excluded)
+ * Edges between tiles used for visibility (see `Pvs` & `Portals`)
+ */
+bool Tilemap::has_wall_h(int i_row, int i_col) const {
+  if (i_row < 0 || i_col < 0)
+    return false;
+
+  Tiles tile = get_tile(i_row, i_col);
+  return tile == Tiles::WALL_H || tile == Tiles::WALL_L || tile == Tiles::WALL_GAMMA;
+}
+
+/* Whether a wall lies along x = i_col from z = i_row to i_row + 1 (vert. walls extend towards -z from their tile, except for `G` ones) */
+bool Tilemap::has_wall_v(int i_row, int i_col) const {
+  if (i_row < 0 || i_col < 0)
+    return false;
+
+  Tiles tile_below = get_tile(i_row + 1, i_col);
+  return tile_below == Tiles::WALL_V || tile_below == Tiles::WALL_L || get_tile(i_row, i_col) == Tiles::WALL_GAMMA;
+}
+
+/* Tiles of row without line ending, contiguous in mapped file (avoids bounds checks on each tile) */
+std::string_view Tilemap::get_row(unsigned int i_row) const {
+  if (i_row >= n_rows)
+    return std::string_view();
+
+  return std::string_view(m_file.data + m_offsets_rows[i_row], m_lengths_rows[i_row]);
+}
+
+/**
+ * Scan whole map for a tile (e.g. enemies which aren't streamed with chunks) by bands of rows on workers
+ * Matches counted first, so each band fills its slice of output: positions sorted by row then column whatever the # of threads
+ * @return Column & row of each matching tile
+ */
+std::vector<glm::uvec2> Tilemap::find(Tiles tile, JobSystem& jobs) const {
+  const size_t N_BANDS = (n_rows + N_ROWS_BAND - 1) / N_ROWS_BAND;
+  std::vector<size_t> offsets(N_BANDS);
+  auto get_rows = [this](size_t i_band) { return std::make_pair(i_band * N_ROWS_BAND, std::min<size_t>((i_band + 1) * N_ROWS_BAND, n_rows)); };
+
+  auto count_bands = [&](size_t first, size_t last) {
+    for (size_t i_band = first; i_band < last; ++i_band) {
+      auto [i_row_start, i_row_end] = get_rows(i_band);
+      for (size_t i_row = i_row_start; i_row < i_row_end; ++i_row) {
+        std::string_view row = get_row(i_row);
+        offsets[i_band] += std::count(row.begin(), row.end(), (char) tile);
+      }
+    }
+  };
+  JobSystem::Counter counter(0);
+  jobs.parallel_for(N_BANDS, 1, count_bands, counter);
+  jobs.wait(counter);
+
+  // counts of each band replaced by offset of its positions
+  size_t n_positions = 0;
+  for (size_t& offset : offsets) {
+    size_t count = offset;
+    offset = n_positions;
+    n_positions += count;
+  }
+
+  std::vector<glm::uvec2> positions(n_positions);
+  auto fill_bands = [&](size_t first, size_t last) {
+    for (size_t i_band = first; i_band < last; ++i_band) {
+      auto [i_row_start, i_row_end] = get_rows(i_band);
+      size_t i_position = offsets[i_band];
+      for (size_t i_row = i_row_start; i_row < i_row_end; ++i_row) {
+        std::string_view row = get_row(i_row);
+        for (size_t i_col = row.find((char) tile); i_col != std::string_view::npos; i_col = row.find((char) tile, i_col + 1))
+          positions[i_position++] = glm::uvec2(i_col, i_row);
+      }
+    }
+  };
+  jobs.parallel_for(N_BANDS, 1, fill_bands, counter);
+  jobs.wait(counter);
+
+  return positions;
 }
@@ -4,52 +4,70 @@
 
 #include "levels/trees_renderer.hpp"
 
-TreesRenderer::TreesRenderer(const ShadersFactory& shaders_factory, const TexturesFactory& textures_factory, Assimp::Importer& importer):
-  m_renderer(shaders_factory["texture"], assimp_utils::Model("assets/models/tree/tree.obj", importer), Attributes::get({"position", "normal", "texture_coord", "tangent"})),
+TreesRenderer::TreesRenderer(const ShadersFactory& shaders_factory, const TexturesFactory& textures_factory, AssetsLoader& assets_loader):
+  m_renderer(shaders_factory["texture"], assets_loader, "assets/models/tree/tree.obj", Attributes::get({"position", "normal", "texture_coord", "tangent"})),
   m_bounding_box(m_renderer.get_positions())
 {
 }
 
-/* Called in LevelRenderer's ctor to avoid inverting matrix every frame */
-void TreesRenderer::calculate_uniforms(const std::vector<glm::vec3>& positions) {
+/**
+ * Matrices (normal matrix inverted once instead of every frame) & bboxes in world space needed for frustum culling
+ * Only reads renderer's constants (& bbox of model in local space), so it can run on another thread than the one drawing
+ */
+TreesRenderer::Instances TreesRenderer::calculate_instances(const std::vector<glm::vec3>& positions) const {
   const unsigned int N_TREES = positions.size();
-  m_positions = std::move(positions);
-  m_models.resize(N_TREES);
-  m_normals_mats.resize(N_TREES);
+  Instances instances;
+  instances.models.resize(N_TREES);
+  instances.normals_mats.resize(N_TREES);
+  instances.bboxes.resize(N_TREES);
 
   for (size_t i_tree = 0; i_tree < N_TREES; ++i_tree) {
-    glm::vec3 position = m_positions[i_tree];
-    glm::mat4 model_tree = glm::translate(glm::mat4(1.0f), position);
-    m_models[i_tree] = model_tree;
-    m_normals_mats[i_tree] = glm::inverseTranspose(model_tree);
-  }
-}
-
-/* Must be called after calculate_uniforms() */
-void TreesRenderer::calculate_bboxes(const std::vector<glm::vec3>& positions) {
-  const unsigned int N_TREES = positions.size();
-  m_bboxes.resize(N_TREES);
-
-  for (size_t i_tree = 0; i_tree < m_models.size(); ++i_tree) {
-    glm::mat4 model_tree = m_models[i_tree];
+    glm::mat4 model_tree = glm::translate(glm::mat4(1.0f), positions[i_tree]);
+    instances.models[i_tree] = model_tree;
+    instances.normals_mats[i_tree] = glm::inverseTranspose(model_tree);
 
     // update bbox to world coords using model matrix
-    BoundingBox& bbox = m_bboxes[i_tree];
+    BoundingBox& bbox = instances.bboxes[i_tree];
     bbox = m_bounding_box;
     bbox.transform(model_tree);
   }
+
+  instances.bvh = math::BVH(instances.bboxes);
+  return instances;
 }
 
-void TreesRenderer::set_transform(const Transformation& t, const Frustum& frustum) {
-  std::vector<glm::mat4> models = frustum.cull(m_models, m_bboxes);
-  std::vector<glm::mat4> normals_mats = frustum.cull(m_normals_mats, m_bboxes);
+/* Instances calculated by `calculate_instances()` moved in (on gl thread, between frames) */
+void TreesRenderer::set_instances(Instances& instances) {
+  m_models = std::move(instances.models);
+  m_normals_mats = std::move(instances.normals_mats);
+  m_bboxes = std::move(instances.bboxes);
+  m_bvh = std::move(instances.bvh);
+  m_cache_frustum.invalidate();
+}
+
+size_t TreesRenderer::Instances::get_size() const {
+  return (models.capacity() + normals_mats.capacity()) * sizeof(glm::mat4) + bboxes.capacity() * sizeof(BoundingBox) + bvh.get_size();
+}
 
-  m_renderer.set_transform({ models, t.view, t.projection });
-  m_renderer.set_uniform_arr("normals_mats", normals_mats);
+/* Visible trees drawn with LOD selected from their distance to camera (no gl calls, so it can run as a job) */
+void TreesRenderer::cull(const Transformation& t, const Frustum& frustum, const Visibility& visibility, JobSystem& jobs) {
+  visibility.cull(frustum.cull(m_bvh, m_cache_frustum), m_bboxes, m_indices, jobs);
+  m_renderer.select_lods(t, m_models, m_indices);
 }
 
-void TreesRenderer::draw(const Uniforms& uniforms) {
-  m_renderer.draw(uniforms);
+/* Matrices of trees left by `cull()` gathered into instances buffers (on gl thread) */
+void TreesRenderer::set_transform(const Transformation& t) {
+  m_renderer.set_transform(t, m_models, m_normals_mats);
+}
+
+/* One packet per mesh of each LOD used */
+void TreesRenderer::submit(RenderQueue& queue, const Uniforms& uniforms, const glm::vec3& position_camera) {
+  if (m_indices.empty())
+    return;
+
+  DrawState state;
+  state.depth = RenderQueue::get_depth(position_camera, m_bboxes, m_indices);
+  m_renderer.submit(queue, state, uniforms);
 }
 
 void TreesRenderer::free() {
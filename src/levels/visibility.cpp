@@ -0,0 +1,41 @@
+#include <algorithm>
+#include <climits>
+
+#include "levels/visibility.hpp"
+
+namespace {
+  /* # of instances tested by a culling job (lists above it split into chunks tested in parallel) */
+  const size_t SIZE_CHUNK = 512;
+
+  /* written in place of hidden instances before compaction */
+  const unsigned int INDEX_HIDDEN = UINT_MAX;
+}
+
+bool Visibility::is_visible(const BoundingBox& bbox) const {
+  return pvs.is_visible(bbox) && portals.is_visible(bbox) && occlusion.is_visible(bbox);
+}
+
+/**
+ * Filter out hidden instances (e.g. after frustum culling)
+ * @param indices Instances to filter
+ * @param bboxes Bboxes of all instances
+ * @param indices_out Visible instances, in caller's buffer reused between frames (no allocation once it's grown)
+ * @param jobs Large lists split into chunks tested in parallel, each writing at positions of its instances (compacted after)
+ */
+void Visibility::cull(const std::vector<unsigned int>& indices, const std::vector<BoundingBox>& bboxes, std::vector<unsigned int>& indices_out, JobSystem& jobs) const {
+  indices_out.resize(indices.size());
+  auto cull_chunk = [&](size_t first, size_t last) {
+    for (size_t i_index = first; i_index < last; ++i_index)
+      indices_out[i_index] = is_visible(bboxes[indices[i_index]]) ? indices[i_index] : INDEX_HIDDEN;
+  };
+
+  if (indices.size() > SIZE_CHUNK) {
+    JobSystem::Counter counter(0);
+    jobs.parallel_for(indices.size(), SIZE_CHUNK, cull_chunk, counter);
+    jobs.wait(counter);
+  } else {
+    cull_chunk(0, indices.size());
+  }
+
+  indices_out.erase(std::remove(indices_out.begin(), indices_out.end(), INDEX_HIDDEN), indices_out.end());
+}
@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+#include "levels/walls_merger.hpp"
+
+namespace {
+  /* Wall box along x-axis (horiz.) or z-axis (vert.), on line `line` of the other horizontal axis */
+  struct Piece {
+    bool is_vertical;
+    float y;
+    float line;
+    float position;
+    unsigned int index;
+
+    bool operator<(const Piece& piece) const {
+      return std::tie(is_vertical, y, line, position) < std::tie(piece.is_vertical, piece.y, piece.line, piece.position);
+    }
+  };
+}
+
+/**
+ * Pieces sorted by line, then consecutive ones (one `length` apart) merged into a run
+ * Run's matrix is its first piece's one with box centered on run & stretched along its local x-axis (walls length)
+ * @param models Unscaled model matrices of walls rotated around y-axis by a multiple of 90deg (duplicates drawn once)
+ * @param length Length of walls along their local x-axis (i.e. one tile)
+ */
+std::vector<glm::mat4> WallsMerger::merge(const std::vector<glm::mat4>& models, float length) {
+  std::vector<Piece> pieces(models.size());
+  for (size_t i_model = 0; i_model < models.size(); ++i_model) {
+    glm::vec3 center = models[i_model][3];
+    bool is_vertical = std::abs(models[i_model][0].x) < 0.5f;
+    pieces[i_model] = {
+      is_vertical, center.y,
+      is_vertical ? center.x : center.z,
+      is_vertical ? center.z : center.x,
+      (unsigned int) i_model
+    };
+  }
+
+  std::sort(pieces.begin(), pieces.end());
+
+  std::vector<glm::mat4> models_runs;
+  for (size_t i_start = 0; i_start < pieces.size();) {
+    const Piece& start = pieces[i_start];
+    size_t i_end = i_start + 1;
+    unsigned int n_pieces = 1;
+
+    // extend run while next piece is on same line & follows last one (or overlaps it)
+    for (; i_end < pieces.size(); ++i_end) {
+      const Piece& piece = pieces[i_end];
+      if (piece.is_vertical != start.is_vertical || piece.y != start.y || piece.line != start.line)
+        break;
+
+      float distance = piece.position - pieces[i_end - 1].position;
+      if (distance > length)
+        break;
+      if (distance > 0.0f)
+        n_pieces++;
+    }
+
+    glm::vec3 center_start = models[start.index][3];
+    glm::vec3 center_end = models[pieces[i_end - 1].index][3];
+    glm::mat4 model = models[start.index];
+    model[0] *= (float) n_pieces;
+    model[3] = glm::vec4((center_start + center_end) / 2.0f, 1.0f);
+    models_runs.push_back(model);
+
+    i_start = i_end;
+  }
+
+  return models_runs;
+}
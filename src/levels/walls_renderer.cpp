@@ -1,9 +1,11 @@
 #include <iostream>
+#include <algorithm>
 #include <array>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/matrix_inverse.hpp>
 
 #include "levels/walls_renderer.hpp"
+#include "levels/walls_merger.hpp"
 #include "geometries/cube.hpp"
 
 using namespace geometry;
@@ -24,12 +26,13 @@ WallsRenderer::WallsRenderer(const ShadersFactory& shaders_factory, const Textur
     Attributes::get({"position", "normal", "texture_coord"})
   ),
 
-  m_texture(textures_factory.get<Texture2D>("wall_diffuse"))
+  m_texture(textures_factory.get<Texture2D>("wall_diffuse")),
+  m_uniforms({ {"texture2d", m_texture} })
 {
 }
 
 /* Calculate offset rel. to tile map position in entry (unit cube geometry centered around origin) */
-std::array<glm::vec3, 2> WallsRenderer::calculate_offsets(const WallEntry& entry) {
+std::array<glm::vec3, 2> WallsRenderer::calculate_offsets(const WallEntry& entry) const {
   std::array<glm::vec3, 2> offsets;
 
   switch (entry.orientation) {
@@ -52,7 +55,7 @@ std::array<glm::vec3, 2> WallsRenderer::calculate_offsets(const WallEntry& entry
 }
 
 /* Calculate rotation angle in degrees around y-axis */
-std::array<float, 2> WallsRenderer::calculate_angles(const WallEntry& entry) {
+std::array<float, 2> WallsRenderer::calculate_angles(const WallEntry& entry) const {
   std::array<float, 2> angles;
 
   switch (entry.orientation) {
@@ -74,9 +77,9 @@ std::array<float, 2> WallsRenderer::calculate_angles(const WallEntry& entry) {
   return angles;
 }
 
-/* Calculate model matrices for full walls */
-void WallsRenderer::calculate_uniforms_full(const std::vector<WallEntry>& entries) {
-  const size_t N_WALLS = entries.size();
+/* Calculate model matrices for full walls (one per tile, then merged into runs) */
+std::vector<glm::mat4> WallsRenderer::calculate_uniforms_full(const std::vector<WallEntry>& entries) const {
+  std::vector<glm::mat4> models;
 
   // Draw wall rotated by `angle` (in deg) around y-axis at entry's position
   // Actual position & angle calculated accord. to wall's orientation
@@ -98,14 +101,17 @@ void WallsRenderer::calculate_uniforms_full(const std::vector<WallEntry>& entrie
         glm::vec3(0.0f, 1.0f, 0.0f)
       );
 
-      m_models.push_back(model);
+      models.push_back(model);
     } // END WALLS PIECES
   } // END WALLS
+
+  return WallsMerger::merge(models, m_wall_length);
 }
 
-/* Calculate model matrices for two walls above & above each window */
-void WallsRenderer::calculate_uniforms_around_window(const std::vector<glm::vec3>& positions_windows) {
+/* Calculate model matrices for two walls below & above each window (merged for adjacent windows) */
+std::vector<glm::mat4> WallsRenderer::calculate_uniforms_around_window(const std::vector<glm::vec3>& positions_windows) const {
   const unsigned int N_WINDOWS = positions_windows.size();
+  std::vector<glm::mat4> models;
 
   for (size_t i_window = 0; i_window < N_WINDOWS; ++i_window) {
     glm::vec3 position_tile = positions_windows[i_window];
@@ -114,66 +120,125 @@ void WallsRenderer::calculate_uniforms_around_window(const std::vector<glm::vec3
     glm::mat4 model_bottom = glm::translate(glm::mat4(1.0f), position_bottom);
     glm::mat4 model_top = glm::translate(glm::mat4(1.0f), position_top);
 
-    m_models_around_windows.insert(m_models_around_windows.end(), { model_bottom, model_top });
+    models.insert(models.end(), { model_bottom, model_top });
   }
+
+  return WallsMerger::merge(models, m_wall_length);
 }
 
 /**
- * Called in LevelRenderer's ctor to avoid inverting matrix every frame
+ * Called by LevelRenderer when streamed chunks change (off main thread, only renderer's constants are read)
  * @param entries Define positions/angles & # of walls for full walls
  * @param positions_windows Used to draw two walls below & above windows
  */
-void WallsRenderer::calculate_uniforms(const std::vector<WallEntry>& entries, const std::vector<glm::vec3>& positions_windows) {
-  calculate_uniforms_full(entries);
-  calculate_uniforms_around_window(positions_windows);
+WallsRenderer::Instances WallsRenderer::calculate_instances(const std::vector<WallEntry>& entries, const std::vector<glm::vec3>& positions_windows) const {
+  Instances instances;
+  instances.models = calculate_uniforms_full(entries);
+  instances.models_around_windows = calculate_uniforms_around_window(positions_windows);
+
+  instances.bboxes = calculate_bboxes_for(instances.models, m_bbox);
+  instances.bboxes_around_windows = calculate_bboxes_for(instances.models_around_windows, m_bbox_around_windows);
+  instances.bvh = math::BVH(instances.bboxes);
+  instances.bvh_around_windows = math::BVH(instances.bboxes_around_windows);
+
+  return instances;
 }
 
-/* Calculate bboxes for full walls OR for walls around windows (accod. to is_around_window) */
-std::vector<BoundingBox> WallsRenderer::calculate_bboxes_for(bool is_around_window) {
-  const unsigned int N_WALLS = (is_around_window ? m_models_around_windows.size() : m_models.size());
+/* Instances calculated by `calculate_instances()` moved in (on gl thread, between frames) */
+void WallsRenderer::set_instances(Instances& instances) {
+  m_models = std::move(instances.models);
+  m_models_around_windows = std::move(instances.models_around_windows);
+  m_bboxes = std::move(instances.bboxes);
+  m_bboxes_around_windows = std::move(instances.bboxes_around_windows);
+  m_bvh = std::move(instances.bvh);
+  m_bvh_around_windows = std::move(instances.bvh_around_windows);
+  m_cache_frustum.invalidate();
+  m_cache_frustum_around_windows.invalidate();
+}
+
+size_t WallsRenderer::Instances::get_size() const {
+  return (models.capacity() + models_around_windows.capacity()) * sizeof(glm::mat4) +
+    (bboxes.capacity() + bboxes_around_windows.capacity()) * sizeof(BoundingBox) + bvh.get_size() + bvh_around_windows.get_size();
+}
+
+/* Bboxes of full walls OR of walls around windows (cube centered around origin transformed to world coords by their models) */
+std::vector<BoundingBox> WallsRenderer::calculate_bboxes_for(const std::vector<glm::mat4>& models, const BoundingBox& bbox_local) {
+  const unsigned int N_WALLS = models.size();
   std::vector<BoundingBox> bboxes(N_WALLS);
 
-  // update cube (centered around origin) to world coords using model matrix
   for (size_t i_wall = 0; i_wall < N_WALLS; ++i_wall) {
-    glm::mat4 model = (is_around_window ? m_models_around_windows[i_wall] : m_models[i_wall]);
-    BoundingBox bbox = (is_around_window ? m_bbox_around_windows : m_bbox);
-    bbox.transform(model);
+    BoundingBox bbox = bbox_local;
+    bbox.transform(models[i_wall]);
     bboxes[i_wall] = bbox;
   }
 
   return bboxes;
 }
 
-/* Must be called after calculate_uniforms() */
-void WallsRenderer::calculate_bboxes() {
-  m_bboxes = calculate_bboxes_for(false);
-  m_bboxes_around_windows = calculate_bboxes_for(true);
-}
+/**
+ * Walls runs kept if they overlap any visible cell or room (no gl calls)
+ * Must be called first among level renderers, as walls passing other culling stages are rasterized as occluders
+ * (occlusion buffer still empty when they're culled), then tested against each other
+ */
+void WallsRenderer::cull(const Frustum& frustum, const Visibility& visibility, JobSystem& jobs) {
+  visibility.cull(frustum.cull(m_bvh, m_cache_frustum), m_bboxes, m_indices, jobs);
+  visibility.cull(frustum.cull(m_bvh_around_windows, m_cache_frustum_around_windows), m_bboxes_around_windows, m_indices_around_windows, jobs);
 
-/* Called each frame before draw() to set matrices uniforms */
-void WallsRenderer::set_transform(const Transformation& t, const Frustum& frustum) {
-  std::vector<glm::mat4> models = frustum.cull(m_models, m_bboxes);
-  std::vector<glm::mat4> models_around_windows = frustum.cull(m_models_around_windows, m_bboxes_around_windows);
+  for (unsigned int index : m_indices)
+    visibility.occlusion.rasterize(m_bboxes[index]);
+  for (unsigned int index : m_indices_around_windows)
+    visibility.occlusion.rasterize(m_bboxes_around_windows[index]);
 
-  m_renderer.set_transform({ models, t.view, t.projection });
-  m_renderer_subwall.set_transform({ models_around_windows, t.view, t.projection });
+  visibility.occlusion.cull(m_indices, m_bboxes);
+  visibility.occlusion.cull(m_indices_around_windows, m_bboxes_around_windows);
+}
+
+/* Called each frame before submit() on gl thread (after `cull()`) */
+void WallsRenderer::set_transform(const Transformation& t) {
+  // models of visible walls gathered straight into instances buffers
+  m_renderer.set_transform(t, m_models, m_indices);
+  m_renderer_subwall.set_transform(t, m_models_around_windows, m_indices_around_windows);
 }
 
 /**
- * Draw all walls at positions parsed from tilemap in LevelRenderer's ctor
+ * Draw all walls at positions parsed from tilemap in LevelRenderer's ctor & two walls below/above windows
+ * One packet per renderer (same program & texture, so sorted next to each other)
  * Supports instancing
  */
-void WallsRenderer::draw() {
-  m_renderer.draw({ {"texture2d", m_texture} });
+void WallsRenderer::submit(RenderQueue& queue, const glm::vec3& position_camera) {
+  DrawState state;
+  state.program = m_renderer.get_program();
+  state.texture = m_texture.id;
+  auto draw = [](void* context, const void* data, size_t) {
+    static_cast<InstancedRenderer*>(context)->draw(*static_cast<const Uniforms*>(data));
+  };
+
+  if (!m_indices.empty()) {
+    state.vao = queue.get_vao(&m_renderer);
+    state.depth = RenderQueue::get_depth(position_camera, m_bboxes, m_indices);
+    queue.submit(state, { draw, &m_renderer, &m_uniforms, 0 });
+  }
+
+  if (!m_indices_around_windows.empty()) {
+    state.vao = queue.get_vao(&m_renderer_subwall);
+    state.depth = RenderQueue::get_depth(position_camera, m_bboxes_around_windows, m_indices_around_windows);
+    queue.submit(state, { draw, &m_renderer_subwall, &m_uniforms, 0 });
+  }
 }
 
 /**
- * Supports instancing
+ * Distance to closest full wall or wall below/above window hit by ray (infinity if none)
+ * Used to prevent shooting targets through walls
  */
-void WallsRenderer::draw_walls_around_window() {
-  m_renderer_subwall.draw({ {"texture2d", m_texture} });
+float WallsRenderer::raycast(const Ray& ray) const {
+  float distance, distance_around_windows;
+  m_bvh.raycast(ray, distance);
+  m_bvh_around_windows.raycast(ray, distance_around_windows);
+
+  return std::min(distance, distance_around_windows);
 }
 
 void WallsRenderer::free() {
   m_renderer.free();
+  m_renderer_subwall.free();
 }
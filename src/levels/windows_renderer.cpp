@@ -13,54 +13,87 @@ using namespace geometry;
  */
 WindowsRenderer::WindowsRenderer(const ShadersFactory& shaders_factory, const TexturesFactory& textures_factory):
   m_texture(textures_factory.get<Texture2D>("window")),
-  m_renderer(shaders_factory["texture_surface"], Surface(), Attributes::get({"position", "normal", "texture_coord"}, 7, true))
+  m_renderer(shaders_factory["texture_surface"], Surface(), Attributes::get({"position", "normal", "texture_coord"}, 7, true)),
+  m_uniforms({ {"texture2d", m_texture} })
 {
 }
 
 /**
- * Called in LevelRenderer's ctor to avoid inverting matrix every frame
- * Draw windows at mid y-coord of `position_tile`
+ * Matrices drawing windows at mid y-coord of `position_tile` & bboxes needed for frustum culling
+ * Only reads renderer's constants, so it can run on another thread than the one drawing
  */
-void WindowsRenderer::calculate_uniforms(const std::vector<glm::vec3>& positions_tiles) {
+WindowsRenderer::Instances WindowsRenderer::calculate_instances(const std::vector<glm::vec3>& positions_tiles) const {
   const unsigned int N_WINDOWS = positions_tiles.size();
-  m_models.resize(N_WINDOWS);
+  Instances instances;
+  instances.models.resize(N_WINDOWS);
+  instances.bboxes.resize(N_WINDOWS);
 
   for (size_t i_window = 0; i_window < N_WINDOWS; ++i_window) {
     glm::vec3 position_tile = positions_tiles[i_window];
     float y_window_bottom = m_height/2.0f - m_size.y/2.0f;
     glm::vec3 position_window(position_tile.x, y_window_bottom, position_tile.z);
-    m_models[i_window] = glm::translate(glm::mat4(1.0f), position_window);
-  }
-}
+    instances.models[i_window] = glm::translate(glm::mat4(1.0f), position_window);
 
-/* Bboxes needed for frustum culling (calculate in level ctor) */
-void WindowsRenderer::calculate_bboxes(const std::vector<glm::vec3>& positions_tiles) {
-  const unsigned int N_WINDOWS = positions_tiles.size();
-  m_bboxes.resize(N_WINDOWS);
-
-  for (size_t i_window = 0; i_window < N_WINDOWS; ++i_window) {
     // surface origin at lower-left corner
-    glm::vec3 position_tile = positions_tiles[i_window];
     glm::vec3 position_center(position_tile.x + m_size.x/2, m_height/2.0f, position_tile.z);
-    m_bboxes[i_window] = BoundingBox(position_center, m_size / 2.0f);
+    instances.bboxes[i_window] = BoundingBox(position_center, m_size / 2.0f);
   }
+
+  instances.bvh = math::BVH(instances.bboxes);
+  return instances;
+}
+
+/* Instances calculated by `calculate_instances()` moved in (on gl thread, between frames) */
+void WindowsRenderer::set_instances(Instances& instances) {
+  m_models = std::move(instances.models);
+  m_bboxes = std::move(instances.bboxes);
+  m_bvh = std::move(instances.bvh);
+  m_cache_frustum.invalidate();
+}
+
+size_t WindowsRenderer::Instances::get_size() const {
+  return models.capacity() * sizeof(glm::mat4) + bboxes.capacity() * sizeof(BoundingBox) + bvh.get_size();
+}
+
+/* Instances culled by frustum then PVS, portals & occlusion (no gl calls, so it can run as a job) */
+void WindowsRenderer::cull(const Frustum& frustum, const Visibility& visibility, JobSystem& jobs) {
+  visibility.cull(frustum.cull(m_bvh, m_cache_frustum), m_bboxes, m_indices, jobs);
 }
 
 /**
- * Delegate transform to renderer
+ * Delegate transform to renderer (on gl thread)
  * Supports instancing (multiple transparent windows)
  */
-void WindowsRenderer::set_transform(const Transformation& t, const Frustum& frustum) {
-  std::vector<glm::mat4> models = frustum.cull(m_models, m_bboxes);
-  m_renderer.set_transform({ models, t.view, t.projection });
+void WindowsRenderer::set_transform(const Transformation& t) {
+  m_renderer.set_transform(t, m_models, m_indices);
+}
+
+/* Windows rectangles (portals between rooms, see `Portals`) */
+const std::vector<BoundingBox>& WindowsRenderer::get_bboxes() const {
+  return m_bboxes;
 }
 
-/* delegate drawing with OpenGL (buffers & shaders) to renderer */
-void WindowsRenderer::draw() {
-  // with face culling enabled, one face (back) of windows surfaces not rendered
-  glDisable(GL_CULL_FACE);
-  m_renderer.draw({ {"texture2d", m_texture} });
-  glEnable(GL_CULL_FACE);
+/**
+ * Delegate drawing with OpenGL (buffers & shaders) to renderer, through render queue
+ * Translucent (drawn after opaque packets for blending with objects in bg) & two-sided
+ * (with face culling enabled, one face (back) of windows surfaces not rendered)
+ */
+void WindowsRenderer::submit(RenderQueue& queue, const glm::vec3& position_camera) {
+  if (m_indices.empty())
+    return;
+
+  DrawState state;
+  state.is_translucent = true;
+  state.is_two_sided = true;
+  state.program = m_renderer.get_program();
+  state.texture = m_texture.id;
+  state.vao = queue.get_vao(&m_renderer);
+  state.depth = RenderQueue::get_depth(position_camera, m_bboxes, m_indices);
+
+  auto draw = [](void* context, const void* data, size_t) {
+    static_cast<InstancedRenderer*>(context)->draw(*static_cast<const Uniforms*>(data));
+  };
+  queue.submit(state, { draw, &m_renderer, &m_uniforms, 0 });
 }
 
 /* Free texture, renderer (vao/vbo buffers) */
@@ -0,0 +1,315 @@
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <assimp/Importer.hpp>
+
+#include "loaders/assets_loader.hpp"
+#include "profiling/profiler.hpp"
+
+using namespace std::chrono;
+
+/* At least one worker (hardware concurrency unknown on some platforms) */
+AssetsLoader::AssetsLoader(unsigned int n_threads):
+  m_time_start(steady_clock::now()),
+  m_is_stopped(false)
+{
+  n_threads = std::max(n_threads, 1u);
+  for (size_t i_thread = 0; i_thread < n_threads; ++i_thread)
+    m_threads.push_back(std::thread(&AssetsLoader::run, this));
+}
+
+/* Assets still in the queue are loaded before workers are joined */
+AssetsLoader::~AssetsLoader() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_is_stopped = true;
+  }
+  m_condition.notify_all();
+
+  for (std::thread& thread : m_threads)
+    thread.join();
+}
+
+/* Worker: run jobs as they're queued until loader is destroyed */
+void AssetsLoader::run() {
+  while (true) {
+    std::function<void()> job;
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition.wait(lock, [this]() { return m_is_stopped || !m_jobs.empty(); });
+      if (m_jobs.empty())
+        return;
+
+      job = std::move(m_jobs.front());
+      m_jobs.pop_front();
+    }
+
+    job();
+  }
+}
+
+double AssetsLoader::get_time() const {
+  duration<double, std::milli> interval = steady_clock::now() - m_time_start;
+  return interval.count();
+}
+
+/**
+ * Queue loading of asset on worker thread & record its timing
+ * Exceptions (e.g. `ModelException`) rethrown on gl thread by `get_*()`
+ */
+template <typename T>
+std::shared_future<T> AssetsLoader::submit(const std::string& path, std::function<T()> load) {
+  auto task = std::make_shared<std::packaged_task<T()>>([this, path, load]() {
+    double start = get_time();
+    T asset = load();
+    double end = get_time();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_timings.push_back({ path, start, end });
+    return asset;
+  });
+  std::shared_future<T> future = task->get_future().share();
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_jobs.push_back([task]() { (*task)(); });
+  }
+  m_condition.notify_one();
+
+  return future;
+}
+
+/**
+ * Queue decoding of image (ignored if already queued)
+ * All images decoded with same vertical flip, as stb_image's flip flag is global to all threads
+ */
+void AssetsLoader::load_image(const std::string& path) {
+  if (m_images.find(path) != m_images.end())
+    return;
+
+  m_images[path] = submit<Image>(path, [path]() {
+    PROFILE_ZONE("Image::Image");
+    return Image(path);
+  });
+}
+
+/* Queue import of 3d model incl. its textures images (one Assimp importer per model as they're not thread-safe) */
+void AssetsLoader::load_model(const std::string& path) {
+  if (m_models.find(path) != m_models.end() || m_models_uploaded.find(path) != m_models_uploaded.end())
+    return;
+
+  m_models[path] = submit<std::shared_ptr<assimp_utils::Model>>(path, [this, path]() {
+    Assimp::Importer importer;
+    std::shared_ptr<assimp_utils::Model> model = std::make_shared<assimp_utils::Model>(path, importer);
+    add_stats(*model);
+    return model;
+  });
+}
+
+/**
+ * Queue simplification of model's LODs (model queued for import before them if it wasn't)
+ * Each LOD simplified on its own worker once model is imported: import job is ahead in queue, so it's already
+ * running (or done) when a worker waits for it
+ * @param ratios Fraction of triangles kept in each LOD after full model (i.e. from LOD 1)
+ */
+void AssetsLoader::load_lods(const std::string& path, const std::vector<float>& ratios) {
+  load_model(path);
+  std::function<assimp_utils::ModelHandle()> get_source;
+  if (m_models.find(path) != m_models.end()) {
+    std::shared_future<std::shared_ptr<assimp_utils::Model>> future = m_models[path];
+    get_source = [future]() { return assimp_utils::ModelHandle(future.get()); };
+  } else {
+    assimp_utils::ModelHandle model = find_model(path);
+    get_source = [model]() { return model; };
+  }
+
+  for (size_t i_ratio = 0; i_ratio < ratios.size(); ++i_ratio) {
+    std::string key = get_key_lod(path, i_ratio + 1);
+    if (m_models.find(key) != m_models.end() || m_models_uploaded.find(key) != m_models_uploaded.end())
+      continue;
+
+    float ratio = ratios[i_ratio];
+    m_lods[key] = path;
+    m_models[key] = submit<std::shared_ptr<assimp_utils::Model>>(key, [this, get_source, ratio]() {
+      PROFILE_ZONE("Model::get_lod");
+      assimp_utils::ModelHandle model = get_source();
+      std::shared_ptr<assimp_utils::Model> lod = std::make_shared<assimp_utils::Model>(model->get_lod(ratio));
+      add_stats_lod(*model, *lod);
+      return lod;
+    });
+  }
+}
+
+/* Key of model's LOD in registry (LOD 0 being model itself) */
+std::string AssetsLoader::get_key_lod(const std::string& path, unsigned int lod) {
+  return (lod == 0) ? path : path + "#lod" + std::to_string(lod);
+}
+
+/* Accumulate optimization stats of model's meshes (from worker thread, reported by `print_stats()`) */
+void AssetsLoader::add_stats(const assimp_utils::Model& model) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  for (const assimp_utils::Mesh& mesh : model.meshes) {
+    const assimp_utils::MeshOptimizer::Stats& stats = mesh.stats_optimizer;
+    if (stats.n_vertexes_before == 0)
+      continue;
+
+    size_t n_triangles = mesh.indices.size() / 3;
+    m_stats_meshes.n_meshes++;
+    m_stats_meshes.n_vertexes_before += stats.n_vertexes_before;
+    m_stats_meshes.n_vertexes_after += stats.n_vertexes_after;
+    m_stats_meshes.n_triangles += n_triangles;
+    m_stats_meshes.n_misses_before += stats.acmr_before * n_triangles;
+    m_stats_meshes.n_misses_after += stats.acmr_after * n_triangles;
+  }
+}
+
+/* Accumulate triangles of LOD & of model simplified into it (from worker thread, reported by `print_stats()`) */
+void AssetsLoader::add_stats_lod(const assimp_utils::Model& model, const assimp_utils::Model& lod) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_stats_lods.n_lods++;
+
+  for (const assimp_utils::Mesh& mesh : model.meshes)
+    m_stats_lods.n_triangles_before += mesh.indices.size() / 3;
+  for (const assimp_utils::Mesh& mesh : lod.meshes)
+    m_stats_lods.n_triangles_after += mesh.indices.size() / 3;
+}
+
+/* Wait for decoded image (queued now if it wasn't before) to upload it as a texture */
+Image AssetsLoader::get_image(const std::string& path) {
+  load_image(path);
+  return m_images[path].get();
+}
+
+/**
+ * Wait for imported model (queued now if it wasn't before) & upload its textures (only once)
+ * LODs reuse textures of model they were simplified from instead
+ * @param path Path to model or key of its LOD (see `get_key_lod()`)
+ * @return Handle shared by all callers with same path (model not copied), only materials left once vertexes are released
+ */
+assimp_utils::ModelHandle AssetsLoader::get_model(const std::string& path) {
+  assimp_utils::ModelHandle model_registered = find_model(path);
+  if (model_registered)
+    return model_registered;
+
+  load_model(path);
+  std::shared_ptr<assimp_utils::Model> model = m_models[path].get();
+  m_models.erase(path);
+
+  auto it_lod = m_lods.find(path);
+  bool is_lod = it_lod != m_lods.end();
+  if (is_lod) {
+    model->share_textures(*get_model(it_lod->second));
+    m_lods.erase(it_lod);
+  } else {
+    model->upload_textures();
+  }
+
+  EntryModel& entry = m_models_uploaded[path];
+  entry.model = model;
+  entry.is_owner_textures = !is_lod;
+
+  return model;
+}
+
+/* Model already in registry (only materials once vertexes are released), null otherwise */
+assimp_utils::ModelHandle AssetsLoader::find_model(const std::string& key) const {
+  auto it_entry = m_models_uploaded.find(key);
+  if (it_entry == m_models_uploaded.end())
+    return nullptr;
+
+  return it_entry->second.model ? it_entry->second.model : it_entry->second.meshes.model;
+}
+
+/**
+ * Meshes of model on gpu, uploaded by first renderer (from full model) & only referenced by the next ones
+ * @param key Path to model (imported if needed) or key of its LOD queued with `load_lods()`
+ */
+const AssetsLoader::ModelMeshes& AssetsLoader::acquire_meshes(const std::string& key, const Upload& upload) {
+  if (m_models_uploaded.find(key) == m_models_uploaded.end())
+    get_model(key);
+
+  EntryModel& entry = m_models_uploaded[key];
+  if (entry.n_renderers == 0) {
+    entry.meshes.renderers = upload(*entry.model);
+    entry.meshes.model = std::make_shared<const assimp_utils::Model>(entry.model->get_materials());
+  }
+
+  entry.n_renderers++;
+  return entry.meshes;
+}
+
+/**
+ * Free meshes vbo/vao & textures of model once its last renderer releases them (LODs only free their vbo/vao)
+ * Model then removed from registry (re-imported, from its mesh cache, if requested again)
+ */
+void AssetsLoader::release_meshes(const std::string& key) {
+  auto it_entry = m_models_uploaded.find(key);
+  if (it_entry == m_models_uploaded.end() || it_entry->second.n_renderers == 0)
+    return;
+
+  EntryModel& entry = it_entry->second;
+  if (--entry.n_renderers > 0)
+    return;
+
+  for (StorageRenderer& renderer : entry.meshes.renderers)
+    renderer.free();
+  if (entry.is_owner_textures)
+    entry.meshes.model->free();
+  m_models_uploaded.erase(it_entry);
+}
+
+/**
+ * Drop registry's handles to full models already uploaded to gpu (once per model), so their meshes vertexes are freed on cpu
+ * Models stay registered with their materials & gpu meshes (not imported again for new renderers)
+ */
+void AssetsLoader::release_vertexes() {
+  for (auto& pair : m_models_uploaded) {
+    if (pair.second.n_renderers > 0)
+      pair.second.model.reset();
+  }
+}
+
+/**
+ * Compare wall-clock time spent loading assets with the sum of their loading times
+ * Overlap close to number of threads when loading time isn't dominated by a single asset
+ * Followed by vertexes welded & ACMR of meshes optimized on import (instead of a line per mesh from workers),
+ * & triangles kept in LODs simplified (their time is in assets timings above, under `#lod` keys)
+ */
+void AssetsLoader::print_stats() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_timings.empty())
+    return;
+
+  double start = m_timings[0].start, end = m_timings[0].end;
+  double sum = 0.0, slowest = 0.0;
+  std::string path_slowest;
+
+  for (const Timing& timing : m_timings) {
+    double duration = timing.end - timing.start;
+    start = std::min(start, timing.start);
+    end = std::max(end, timing.end);
+    sum += duration;
+
+    if (duration > slowest) {
+      slowest = duration;
+      path_slowest = timing.path;
+    }
+  }
+
+  std::cout << "Assets: " << m_timings.size() << " loaded on " << m_threads.size() << " threads in " << end - start << "ms"
+            << " (sum: " << sum << "ms, slowest: " << path_slowest << " " << slowest << "ms, overlap: "
+            << sum / (end - start) << "x)" << '\n';
+
+  if (m_stats_meshes.n_triangles > 0) {
+    std::cout << "Meshes: " << m_stats_meshes.n_meshes << " optimized, " << m_stats_meshes.n_vertexes_before << " -> "
+              << m_stats_meshes.n_vertexes_after << " vertexes, ACMR: " << m_stats_meshes.n_misses_before / m_stats_meshes.n_triangles
+              << " -> " << m_stats_meshes.n_misses_after / m_stats_meshes.n_triangles << '\n';
+  }
+
+  if (m_stats_lods.n_lods > 0) {
+    std::cout << "LODs: " << m_stats_lods.n_lods << " simplified, " << m_stats_lods.n_triangles_before << " -> "
+              << m_stats_lods.n_triangles_after << " triangles" << '\n';
+  }
+}
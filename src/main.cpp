@@ -21,9 +21,11 @@
 #include "geometries/grid_lines.hpp"
 
 #include "render/renderer.hpp"
+#include "render/instanced_renderer.hpp"
 #include "render/text_renderer.hpp"
 #include "levels/level_renderer.hpp"
 #include "render/model_renderer.hpp"
+#include "render/lod_renderer.hpp"
 
 #include "text/glyphs.hpp"
 #include "text/font.hpp"
@@ -32,6 +34,7 @@
 
 #include "profiling/time_profiler.hpp"
 #include "profiling/memory_profiler.hpp"
+#include "profiling/profiler.hpp"
 
 #include "levels/tilemap.hpp"
 #include "audio/audio.hpp"
@@ -45,6 +48,7 @@
 
 #include "factories/shaders_factory.hpp"
 #include "factories/textures_factory.hpp"
+#include "loaders/assets_loader.hpp"
 
 using namespace geometry;
 
@@ -92,6 +96,13 @@ int main() {
   // Renderers
   ////////////////////////////////////////////////
 
+  // import 3d models (& simplify LODs of trees & enemies) on worker threads while shaders are compiled & textures images decoded
+  AssetsLoader assets_loader;
+  assets_loader.load_model("assets/models/sniper/sniper.obj");
+  assets_loader.load_model("assets/models/suzanne/suzanne.obj");
+  LodRenderer::load(assets_loader, "assets/models/tree/tree.obj");
+  LodRenderer::load(assets_loader, "assets/models/samurai/samurai.obj");
+
   // create & install vertex & fragment shaders on GPU
   ShadersFactory shaders_factory;
   if (shaders_factory.has_failed()) {
@@ -100,7 +111,7 @@ int main() {
   }
 
   // load textures
-  TexturesFactory textures_factory;
+  TexturesFactory textures_factory(assets_loader);
 
   // empty texture to fill when drawing to framebuffer
   Image image_framebuffer(window.width, window.height, GL_RGB, NULL);
@@ -115,11 +126,11 @@ int main() {
 
   // renderer (encapsulates VAO & VBO) for each shape to render
   // 08-01-23: ~ total of 40K vertexes coords (float/uint) for geometries => peanuts (not the place to optimize)
-  Renderer cubes(shaders_factory["basic"], Cube(), Attributes::get({"position"}, 8));
-  Renderer surface(shaders_factory["texture_surface"], Surface(), Attributes::get({"position", "normal", "texture_coord"}, 7, true));
-  Renderer cylinders(shaders_factory["phong"], Cylinder(32, 0.25f, 3.5f), Attributes::get({"position", "normal", "texture_coord", "tangent"}));
-  Renderer gizmo(shaders_factory["basic"], Gizmo(), Attributes::get({"position"}));
-  Renderer grid(shaders_factory["basic"], GridLines(32), Attributes::get({"position"}));
+  InstancedRenderer cubes(shaders_factory["basic"], Cube(), Attributes::get({"position"}, 8));
+  InstancedRenderer surface(shaders_factory["texture_surface"], Surface(), Attributes::get({"position", "normal", "texture_coord"}, 7, true));
+  InstancedRenderer cylinders(shaders_factory["phong"], Cylinder(32, 0.25f, 3.5f), Attributes::get({"position", "normal", "texture_coord", "tangent"}));
+  InstancedRenderer gizmo(shaders_factory["basic"], Gizmo(), Attributes::get({"position"}));
+  InstancedRenderer grid(shaders_factory["basic"], GridLines(32), Attributes::get({"position"}));
 
   time_profiler.stop("* Shaders & buffers");
 
@@ -127,27 +138,28 @@ int main() {
   const unsigned int N_LIGHTS = lights.size(),
                      N_CYLINDERS = 2;
 
-  // accord. to doc: better to reuse importer, & destroys scene (3d model) once out of scope
-  Assimp::Importer importer;
-
   // load font & assign its bitmap glyphs to textures
   Font font("assets/fonts/Vera.ttf");
   TextRenderer surface_glyph(shaders_factory["text"], {{0, "position", 2, 7, 0}, {2, "texture_coord", 2, 7, 5}}, font);
 
   // load 3d model from .obj file & its renderer
   time_profiler.start();
-  assimp_utils::Model model3d_gun("assets/models/sniper/sniper.obj", importer),
-                    model3d_suzanne("assets/models/suzanne/suzanne.obj", importer);
-
-  ModelRenderer gun(shaders_factory["texture"], model3d_gun, Attributes::get({"position", "normal", "texture_coord", "tangent"}));
-  ModelRenderer suzanne(shaders_factory["texture"], model3d_suzanne, Attributes::get({"position", "normal", "texture_coord", "tangent"}));
+  ModelRenderer gun(shaders_factory["texture"], assets_loader, "assets/models/sniper/sniper.obj", Attributes::get({"position", "normal", "texture_coord", "tangent"}));
+  ModelRenderer suzanne(shaders_factory["texture"], assets_loader, "assets/models/suzanne/suzanne.obj", Attributes::get({"position", "normal", "texture_coord", "tangent"}));
   time_profiler.stop("* Loading gun & suzanne 3D models");
 
   // load tilemap by parsing text file
   time_profiler.start();
-  LevelRenderer level(importer, shaders_factory, textures_factory);
+  LevelRenderer level(assets_loader, shaders_factory, textures_factory);
   time_profiler.stop("* Loading tilemap, tree & enemy 3D models");
-  camera.boundaries = level.positions_walls;
+  assets_loader.print_stats();
+
+  // meshes vertexes freed on cpu (all uploaded to gpu by renderers above)
+  assets_loader.release_vertexes();
+
+  // chunks around spawn built before first frame
+  level.update(camera.position, true);
+  camera.set_boundaries(level.positions_walls);
 
   ////////////////////////////////////////////////
   // Uniforms for cylinders
@@ -241,7 +253,7 @@ int main() {
   }
 
   // callback for processing mouse click (after init static members)
-  MouseHandler::init(&window, &camera, &audio);
+  MouseHandler::init(&window, &camera, &audio, &level);
   window.attach_mouse_listeners(MouseHandler::on_mouse_move, MouseHandler::on_mouse_click, MouseHandler::on_mouse_scroll);
 
   // handler for keyboard inputs
@@ -266,6 +278,8 @@ int main() {
   ////////////////////////////////////////////////
 
   while (!window.is_closed()) {
+    PROFILE_ZONE("frame");
+
     // update transformation matrices (camera fov changes on zoom)
     glm::mat4 view = camera.get_view();
     projection3d = glm::perspective(glm::radians(camera.fov), aspect_ratio, near, far);
@@ -289,7 +303,8 @@ int main() {
         view,
         projection2d
       });
-      cubes.draw({ {"colors[0]", glm::vec3(1.0f, 0.0f, 0.0f) } });
+      cubes.set_instance_arr<glm::vec3>("colors", { glm::vec3(1.0f, 0.0f, 0.0f) });
+      cubes.draw();
       framebuffer.unbind();
     }
 
@@ -299,7 +314,8 @@ int main() {
     // cube with outline using two-passes rendering & stencil buffer
     glm::mat4 model_cube_outline(glm::translate(glm::mat4(1.0f), glm::vec3(10.0f, 1.0f, 5.0f)));
     cubes.set_transform({ {model_cube_outline}, view, projection3d });
-    cubes.draw_with_outlines({ {"colors[0]", glm::vec3(0.0f, 0.0f, 1.0f)} });
+    cubes.set_instance_arr<glm::vec3>("colors", { glm::vec3(0.0f, 0.0f, 1.0f) });
+    cubes.draw_with_outlines({});
 
     // draw level tiles surfaces on right view
     level.set_transform({ {glm::mat4(1.0f)}, view, projection3d }, frustum);
@@ -357,13 +373,13 @@ int main() {
     // light cubes
     Transformation transform_cube(models_lights, view, projection3d);
     cubes.set_transform(transform_cube);
-    cubes.set_uniform_arr("colors", colors_lights);
+    cubes.set_instance_arr("colors", colors_lights);
     cubes.draw({});
 
     // uses instancing to draw 2 cylinders pillars (affected by same light source)
     Transformation transform_cylinder(models_cylinder, view, projection3d);
     cylinders.set_transform(transform_cylinder);
-    cylinders.set_uniform_arr<glm::mat4>("normals_mats", normals_mats_cylinders);
+    cylinders.set_instance_arr<glm::mat4>("normals_mats", normals_mats_cylinders);
     cylinders.set_uniform_arr<glm::vec3>("lights.position", { lights[1].position, lights[1].position });
     cylinders.set_uniform_arr<glm::vec3>("lights.ambiant", { lights[1].ambiant, lights[1].ambiant });
     cylinders.set_uniform_arr<glm::vec3>("lights.diffuse", { lights[1].diffuse, lights[1].diffuse });
@@ -380,17 +396,21 @@ int main() {
 
     // draw xyz gizmo at origin using GL_LINES
     gizmo.set_transform({ { glm::mat4(1.0) }, view, projection3d });
-    gizmo.draw_lines({ {"colors[0]", glm::vec3(1.0f, 0.0f, 0.0f)} }, 2, 0);
-    gizmo.draw_lines({ {"colors[0]", glm::vec3(0.0f, 1.0f, 0.0f)} }, 2, 2);
-    gizmo.draw_lines({ {"colors[0]", glm::vec3(0.0f, 0.0f, 1.0f)} }, 2, 4);
+    gizmo.set_instance_arr<glm::vec3>("colors", { glm::vec3(1.0f, 0.0f, 0.0f) });
+    gizmo.draw_lines({}, 2, 0);
+    gizmo.set_instance_arr<glm::vec3>("colors", { glm::vec3(0.0f, 1.0f, 0.0f) });
+    gizmo.draw_lines({}, 2, 2);
+    gizmo.set_instance_arr<glm::vec3>("colors", { glm::vec3(0.0f, 0.0f, 1.0f) });
+    gizmo.draw_lines({}, 2, 4);
 
     // draw horizontal 2d grid using GL_LINES
     grid.set_transform({ { glm::mat4(1.0) }, view, projection3d });
-    grid.draw_lines({ {"colors[0]", glm::vec3(1.0f, 1.0f, 1.0f)} });
+    grid.set_instance_arr<glm::vec3>("colors", { glm::vec3(1.0f, 1.0f, 1.0f) });
+    grid.draw_lines({});
 
     // gun sticked to lower-right corner
     gun.set_transform({ {model_gun}, glm::mat4(1.0f), projection3d });
-    gun.set_uniform_arr("normals_mats", { normal_mat_gun });
+    gun.set_instance_arr("normals_mats", { normal_mat_gun });
     gun.draw({
       {"position_camera", camera.position},
       {"positions_lights[0]", lights[0].position},
@@ -400,7 +420,7 @@ int main() {
 
     // render 3d model for suzanne with normal mapping
     suzanne.set_transform({ {model_suzanne}, view, projection3d });
-    suzanne.set_uniform_arr("normals_mats", { normal_mat_suzanne });
+    suzanne.set_instance_arr("normals_mats", { normal_mat_suzanne });
     suzanne.draw({
       {"position_camera", camera.position},
       {"positions_lights[0]", lights[0].position},
@@ -424,8 +444,11 @@ int main() {
     surface_glyph.draw_text("Score: " + std::to_string(score));
 
     // process events & show rendered buffer
-    window.process_events();
-    window.render();
+    {
+      PROFILE_ZONE("Window::render");
+      window.process_events();
+      window.render();
+    }
 
     // keyboard input (move camera, quit application)
     key_handler.on_keypress();
@@ -433,6 +456,10 @@ int main() {
     // continuous jumping/falling after press on <spacebar>
     camera.update();
 
+    // stream tilemap's chunks around new camera position (walls to collide with follow them)
+    if (level.update(camera.position))
+      camera.set_boundaries(level.positions_walls);
+
     // calculate fps
     window.show_fps();
 
@@ -442,6 +469,10 @@ int main() {
     audio.update();
   }
 
+#ifdef PROFILING
+  Profiler::export_chrome_trace("trace.json");
+#endif
+
   // destroy textures
   texture_framebuffer.free();
 
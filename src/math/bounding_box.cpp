@@ -1,12 +1,10 @@
 #include <algorithm>
-#include <iostream>
+#include <cmath>
+#include <limits>
 #include <glm/gtx/string_cast.hpp>
 
-#include "math/axis_aligned_plane.hpp"
 #include "math/bounding_box.hpp"
 
-using namespace math;
-
 /* Needed so bbox (class member) can be automatically init in Renderer constructor */
 BoundingBox::BoundingBox() {
 }
@@ -54,63 +52,85 @@ void BoundingBox::calculate_center_diagonal() {
 }
 
 /**
- * Check if 3D line crosses bounding box
- * Intersection point between 3D line & plane: https://www.youtube.com/watch?v=Td9CZGkqrSg
- * Line defined in 3d by parameteric equations: x = x0 + a*t, y = y0 + b*t, z = z0 + c*t
- * Two parameters below define 3D line corresp. to camera's line of sight
+ * Check if ray (half-line) crosses bounding box
  * @param ray Camera look direction
  */
-bool BoundingBox::intersects(const Ray& ray) {
-  // six AA-Planes tangent to bbox faces
-  AxisAlignedPlane plane_minx(min.x, AxisPlane::YZ);
-  AxisAlignedPlane plane_maxx(max.x, AxisPlane::YZ);
-  AxisAlignedPlane plane_miny(min.y, AxisPlane::XZ);
-  AxisAlignedPlane plane_maxy(max.y, AxisPlane::XZ);
-  AxisAlignedPlane plane_minz(min.z, AxisPlane::XY);
-  AxisAlignedPlane plane_maxz(max.z, AxisPlane::XY);
-  std::vector<AxisAlignedPlane> aa_planes = {plane_minx, plane_maxx, plane_miny, plane_maxy, plane_minz, plane_maxz};
-
-  for (const AxisAlignedPlane& aa_plane : aa_planes) {
-    // find intersection points between line and bounding box mathematical (unbounded) plane
-    glm::vec3 intersect;
-    bool is_plane_behind_ray = !aa_plane.intersect_line(ray, intersect);
-
-    // bbox plane behind the ray
-    if (is_plane_behind_ray) {
-      std::cout << " Plane behind ray" << '\n';
-      continue;
-    }
+bool BoundingBox::intersects(const Ray& ray) const {
+  float distance;
+  return intersects(ray, distance);
+}
 
-    // check if intersection point belongs to bounding box face rectangle
-    switch (aa_plane.axis) {
-      case AxisPlane::YZ: // planes x = minx and x = maxx
-        if ((intersect.y >= min.y && intersect.y <= max.y) &&
-            (intersect.z >= min.z && intersect.z <= max.z)) {
-          std::cout << " inside" << '\n';
-          return true;
+namespace {
+  /**
+   * Slab test: ray enters bbox after crossing the near planes of all 3 slabs & before leaving any of them
+   * Branch-free (min/max only), see: https://tavianator.com/2011/ray_box.html
+   * Kept in this file so it's inlined in batched raycast loop below
+   * @param HAS_PARALLEL_AXIS Whether ray's direction has a zero component (see `Ray`), chosen once per ray
+   */
+  template <bool HAS_PARALLEL_AXIS>
+  inline bool intersects_slabs(const glm::vec3& min, const glm::vec3& max, const Ray& ray, float& distance) {
+    glm::vec3 t1 = (min - ray.origin) * ray.inverse_direction;
+    glm::vec3 t2 = (max - ray.origin) * ray.inverse_direction;
+
+    // origin on plane of a slab parallel to ray gives 0 * inf = NaN: slab contains the whole ray
+    if (HAS_PARALLEL_AXIS) {
+      const float INF = std::numeric_limits<float>::infinity();
+      for (int axis = 0; axis < 3; ++axis) {
+        if (std::isnan(t1[axis]) || std::isnan(t2[axis])) {
+          t1[axis] = -INF;
+          t2[axis] = INF;
         }
-        break;
+      }
+    }
 
-      case AxisPlane::XZ: // planes y = miny and y = maxy
-        if ((intersect.x >= min.x && intersect.x <= max.x) &&
-            (intersect.z >= min.z && intersect.z <= max.z)) {
-          std::cout << " inside" << '\n';
-          return true;
-        }
-        break;
+    float t_near = std::max(std::max(std::min(t1.x, t2.x), std::min(t1.y, t2.y)), std::min(t1.z, t2.z));
+    float t_far = std::min(std::min(std::max(t1.x, t2.x), std::max(t1.y, t2.y)), std::max(t1.z, t2.z));
 
-      case AxisPlane::XY: // planes z = minz and z = maxz
-        if ((intersect.x >= min.x && intersect.x <= max.x) &&
-            (intersect.y >= min.y && intersect.y <= max.y)) {
-          std::cout << " inside" << '\n';
-          return true;
-        }
+    distance = std::max(t_near, 0.0f);
+    return t_far >= distance;
+  }
+
+  template <bool HAS_PARALLEL_AXIS>
+  int raycast_slabs(const Ray& ray, const BoundingBox* bboxes, size_t n_bboxes, float& distance) {
+    int index = BoundingBox::NO_COLLISION;
+    float distance_closest = std::numeric_limits<float>::infinity();
+
+    for (size_t i_bbox = 0; i_bbox < n_bboxes; ++i_bbox) {
+      // selects instead of branches (hits are unpredictable)
+      float distance_bbox;
+      bool is_closer = intersects_slabs<HAS_PARALLEL_AXIS>(bboxes[i_bbox].min, bboxes[i_bbox].max, ray, distance_bbox) & (distance_bbox < distance_closest);
+      distance_closest = is_closer ? distance_bbox : distance_closest;
+      index = is_closer ? i_bbox : index;
     }
 
-    std::cout << " outside" << '\n';
+    if (index != BoundingBox::NO_COLLISION)
+      distance = distance_closest;
+
+    return index;
   }
+}
+
+/**
+ * Closest-hit raycast on a single bbox
+ * @param distance Ray parameter of entry point (0 if ray starts inside bbox), in units of ray direction
+ */
+bool BoundingBox::intersects(const Ray& ray, float& distance) const {
+  if (ray.has_parallel_axis)
+    return intersects_slabs<true>(min, max, ray, distance);
+
+  return intersects_slabs<false>(min, max, ray, distance);
+}
+
+/**
+ * Closest bbox hit by ray among contiguous bboxes (e.g. a BVH leaf)
+ * @param distance Distance to closest hit (unchanged if no hit)
+ * @return index of closest bbox hit or -1 if none
+ */
+int BoundingBox::raycast(const Ray& ray, const BoundingBox* bboxes, size_t n_bboxes, float& distance) {
+  if (ray.has_parallel_axis)
+    return raycast_slabs<true>(ray, bboxes, n_bboxes, distance);
 
-  return false;
+  return raycast_slabs<false>(ray, bboxes, n_bboxes, distance);
 }
 
 /**
@@ -0,0 +1,30 @@
+#include "math/bounding_boxes_soa.hpp"
+
+BoundingBoxesSoA::BoundingBoxesSoA():
+  size(0)
+{
+}
+
+/* Only center & half diagonal are copied (min/max not needed for culling) */
+BoundingBoxesSoA::BoundingBoxesSoA(const std::vector<BoundingBox>& bboxes):
+  size(bboxes.size())
+{
+  // padding bboxes are zeros (discarded by kernels using `size`)
+  size_t size_padded = (size + WIDTH - 1) / WIDTH * WIDTH;
+  centers_x.resize(size_padded);
+  centers_y.resize(size_padded);
+  centers_z.resize(size_padded);
+  half_diagonals_x.resize(size_padded);
+  half_diagonals_y.resize(size_padded);
+  half_diagonals_z.resize(size_padded);
+
+  for (size_t i_bbox = 0; i_bbox < size; ++i_bbox) {
+    const BoundingBox& bbox = bboxes[i_bbox];
+    centers_x[i_bbox] = bbox.center.x;
+    centers_y[i_bbox] = bbox.center.y;
+    centers_z[i_bbox] = bbox.center.z;
+    half_diagonals_x[i_bbox] = bbox.half_diagonal.x;
+    half_diagonals_y[i_bbox] = bbox.half_diagonal.y;
+    half_diagonals_z[i_bbox] = bbox.half_diagonal.z;
+  }
+}
@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+
+#include "math/bvh.hpp"
+
+using namespace math;
+
+bool BVHNode::is_leaf() const {
+  return left == 0;
+}
+
+/**
+ * Build tree top-down by splitting items at the median of their centers along largest axis
+ * @param bboxes_items World-space bboxes (e.g. `m_bboxes` of level renderers)
+ */
+BVH::BVH(const std::vector<BoundingBox>& bboxes_items) {
+  const unsigned int N_ITEMS = bboxes_items.size();
+  if (N_ITEMS == 0)
+    return;
+
+  indices.resize(N_ITEMS);
+  std::iota(indices.begin(), indices.end(), 0);
+
+  // binary tree with leaves of at least MAX_LEAF_SIZE / 2 items
+  nodes.reserve(2 * (N_ITEMS / (MAX_LEAF_SIZE / 2)) + 1);
+  nodes.push_back({ calculate_bbox(0, N_ITEMS, bboxes_items), 0, N_ITEMS, 0 });
+  build(0, bboxes_items);
+
+  // copy bboxes in tree order (leaves items contiguous in memory when traversing)
+  bboxes.resize(N_ITEMS);
+  for (size_t i_item = 0; i_item < N_ITEMS; ++i_item)
+    bboxes[i_item] = bboxes_items[indices[i_item]];
+}
+
+/* Smallest bbox enclosing items in given range of `indices` */
+BoundingBox BVH::calculate_bbox(unsigned int first, unsigned int count, const std::vector<BoundingBox>& bboxes_items) const {
+  glm::vec3 min = bboxes_items[indices[first]].min;
+  glm::vec3 max = bboxes_items[indices[first]].max;
+
+  for (size_t i_item = first + 1; i_item < first + count; ++i_item) {
+    const BoundingBox& bbox = bboxes_items[indices[i_item]];
+    min = glm::min(min, bbox.min);
+    max = glm::max(max, bbox.max);
+  }
+
+  glm::vec3 center = (min + max) / 2.0f;
+  return BoundingBox(center, max - center);
+}
+
+/* Recursively split node (by index as `nodes` might be reallocated) in two halves */
+void BVH::build(unsigned int i_node, const std::vector<BoundingBox>& bboxes_items) {
+  unsigned int first = nodes[i_node].first;
+  unsigned int count = nodes[i_node].count;
+  if (count <= MAX_LEAF_SIZE)
+    return;
+
+  // split axis with largest spread of centers (not of bboxes, as walls overlap at corners)
+  glm::vec3 min_centers = bboxes_items[indices[first]].center;
+  glm::vec3 max_centers = min_centers;
+  for (size_t i_item = first + 1; i_item < first + count; ++i_item) {
+    min_centers = glm::min(min_centers, bboxes_items[indices[i_item]].center);
+    max_centers = glm::max(max_centers, bboxes_items[indices[i_item]].center);
+  }
+
+  glm::vec3 extent = max_centers - min_centers;
+  int axis = (extent.x > extent.y && extent.x > extent.z) ? 0 : (extent.y > extent.z ? 1 : 2);
+
+  // partial sort around median (only needs items on each side to be on the right half)
+  unsigned int count_left = count / 2;
+  auto it_first = indices.begin() + first;
+  std::nth_element(it_first, it_first + count_left, it_first + count,
+      [&bboxes_items, axis](unsigned int i1, unsigned int i2) { return bboxes_items[i1].center[axis] < bboxes_items[i2].center[axis]; });
+
+  unsigned int left = nodes.size();
+  nodes[i_node].left = left;
+  nodes.push_back({ calculate_bbox(first, count_left, bboxes_items), first, count_left, 0 });
+  nodes.push_back({ calculate_bbox(first + count_left, count - count_left, bboxes_items), first + count_left, count - count_left, 0 });
+
+  build(left, bboxes_items);
+  build(left + 1, bboxes_items);
+}
+
+/* Bytes allocated by tree (counted against chunks streamer's memory budget) */
+size_t BVH::get_size() const {
+  return nodes.capacity() * sizeof(BVHNode) + indices.capacity() * sizeof(unsigned int) + bboxes.capacity() * sizeof(BoundingBox);
+}
+
+/**
+ * Closest item hit by ray, subtrees farther than closest hit so far are skipped
+ * @param distance Distance to closest hit along ray (infinity if no hit)
+ * @param is_ignored Optional filter on items indices (e.g. dead targets)
+ * @return index of closest item in caller's vector or -1 if none
+ */
+int BVH::raycast(const Ray& ray, float& distance, const std::function<bool(unsigned int)>& is_ignored) const {
+  int index = BoundingBox::NO_COLLISION;
+  distance = std::numeric_limits<float>::infinity();
+  if (nodes.empty())
+    return index;
+
+  float distance_root;
+  if (!nodes[0].bbox.intersects(ray, distance_root))
+    return index;
+
+  // depth-first traversal (stack holds at most one sibling per level) with entry distance of nodes
+  std::array<std::pair<unsigned int, float>, MAX_DEPTH + 1> stack;
+  size_t size_stack = 0;
+  stack[size_stack++] = { 0, distance_root };
+
+  while (size_stack > 0) {
+    auto [i_node, distance_node] = stack[--size_stack];
+    const BVHNode& node = nodes[i_node];
+    if (distance_node >= distance)
+      continue;
+
+    if (node.is_leaf()) {
+      // leaf items are contiguous in tree order
+      if (!is_ignored) {
+        float distance_leaf;
+        int i_leaf = BoundingBox::raycast(ray, &bboxes[node.first], node.count, distance_leaf);
+        if (i_leaf != BoundingBox::NO_COLLISION && distance_leaf < distance) {
+          distance = distance_leaf;
+          index = indices[node.first + i_leaf];
+        }
+        continue;
+      }
+
+      for (size_t i_item = node.first; i_item < node.first + node.count; ++i_item) {
+        float distance_item;
+        if (!is_ignored(indices[i_item]) && bboxes[i_item].intersects(ray, distance_item) && distance_item < distance) {
+          distance = distance_item;
+          index = indices[i_item];
+        }
+      }
+    } else {
+      // children missed by ray not pushed, nearest one pushed last (visited first) so farther one is more likely skipped
+      float distance_left, distance_right;
+      bool is_hit_left = nodes[node.left].bbox.intersects(ray, distance_left);
+      bool is_hit_right = nodes[node.left + 1].bbox.intersects(ray, distance_right);
+
+      if (is_hit_left && is_hit_right && distance_left <= distance_right) {
+        stack[size_stack++] = { node.left + 1, distance_right };
+        stack[size_stack++] = { node.left, distance_left };
+      } else {
+        if (is_hit_left)
+          stack[size_stack++] = { node.left, distance_left };
+        if (is_hit_right)
+          stack[size_stack++] = { node.left + 1, distance_right };
+      }
+    }
+  }
+
+  return index;
+}
@@ -43,3 +43,10 @@ bool Plane::is_in_front_of_plane(const BoundingBox& bbox) const {
 
   return get_signed_distance(bbox.center) > -radius_bbox;
 }
+
+/* True if whole bbox is on plane's normal side (same radius as above) */
+bool Plane::is_fully_in_front_of_plane(const BoundingBox& bbox) const {
+  float radius_bbox = glm::dot(bbox.half_diagonal, glm::abs(normal));
+
+  return get_signed_distance(bbox.center) >= radius_bbox;
+}
@@ -7,5 +7,7 @@
  */
 Ray::Ray(const glm::vec3& orig, const glm::vec3& dir):
   origin(orig),
-  direction(dir)
+  direction(dir),
+  inverse_direction(1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z),
+  has_parallel_axis(dir.x == 0.0f || dir.y == 0.0f || dir.z == 0.0f)
 {}
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cmath>
+
+#include "math/spatial_grid.hpp"
+
+using namespace math;
+
+SpatialGrid::SpatialGrid():
+  m_cell_size(1.0f),
+  m_origin(0),
+  m_n_cols(0),
+  m_n_rows(0)
+{
+}
+
+/**
+ * Counting sort of points by cell (row-major)
+ * @param cell_size Side of a cell, must be >= distance passed to `is_close_to()`
+ */
+SpatialGrid::SpatialGrid(const std::vector<glm::vec3>& points, float cell_size):
+  m_cell_size(cell_size),
+  m_origin(0),
+  m_n_cols(0),
+  m_n_rows(0)
+{
+  if (points.empty())
+    return;
+
+  // grid covers cells from lowest to highest xz-coords of points
+  glm::ivec2 cell_min(get_cell(points[0])), cell_max(cell_min);
+  for (const glm::vec3& point : points) {
+    glm::ivec2 cell = get_cell(point);
+    cell_min = glm::min(cell_min, cell);
+    cell_max = glm::max(cell_max, cell);
+  }
+
+  m_origin = cell_min;
+  m_n_cols = cell_max.x - cell_min.x + 1;
+  m_n_rows = cell_max.y - cell_min.y + 1;
+
+  // count points in each cell then convert counts to offsets (prefix sum)
+  std::vector<unsigned int> indices_cells(points.size());
+  m_offsets.assign(m_n_cols * m_n_rows + 1, 0);
+
+  for (size_t i_point = 0; i_point < points.size(); ++i_point) {
+    glm::ivec2 cell = get_cell(points[i_point]) - m_origin;
+    indices_cells[i_point] = cell.y * m_n_cols + cell.x;
+    m_offsets[indices_cells[i_point] + 1]++;
+  }
+
+  for (size_t i_cell = 0; i_cell < m_n_cols * m_n_rows; ++i_cell)
+    m_offsets[i_cell + 1] += m_offsets[i_cell];
+
+  // place each point at next free slot of its cell
+  std::vector<unsigned int> slots(m_offsets.begin(), m_offsets.end() - 1);
+  m_points.resize(points.size());
+
+  for (size_t i_point = 0; i_point < points.size(); ++i_point)
+    m_points[slots[indices_cells[i_point]]++] = points[i_point];
+}
+
+/* Cell containing position (in absolute grid coords, i.e. not relative to `m_origin`) */
+glm::ivec2 SpatialGrid::get_cell(const glm::vec3& position) const {
+  return {
+    static_cast<int>(std::floor(position.x / m_cell_size)),
+    static_cast<int>(std::floor(position.z / m_cell_size)),
+  };
+}
+
+/**
+ * Check if any point is closer than `distance` to position (same result as testing every point)
+ * Only points in the 3x3 cells around position are tested, as `distance` <= cell size
+ */
+bool SpatialGrid::is_close_to(const glm::vec3& position, float distance) const {
+  if (m_points.empty())
+    return false;
+
+  glm::ivec2 cell = get_cell(position) - m_origin;
+  int col_start = std::max(cell.x - 1, 0), col_end = std::min(cell.x + 1, static_cast<int>(m_n_cols) - 1);
+  int row_start = std::max(cell.y - 1, 0), row_end = std::min(cell.y + 1, static_cast<int>(m_n_rows) - 1);
+  float distance_squared = distance * distance;
+
+  for (int row = row_start; row <= row_end; ++row) {
+    for (int col = col_start; col <= col_end; ++col) {
+      unsigned int i_cell = row * m_n_cols + col;
+
+      for (size_t i_point = m_offsets[i_cell]; i_point < m_offsets[i_cell + 1]; ++i_point) {
+        glm::vec3 difference = position - m_points[i_point];
+        if (glm::dot(difference, difference) < distance_squared)
+          return true;
+      }
+    }
+  }
+
+  return false;
+}
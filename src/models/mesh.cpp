@@ -1,15 +1,49 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
 #include "models/mesh.hpp"
+#include "models/vertex_quantized.hpp"
+#include "models/mesh_simplifier.hpp"
 
 using namespace assimp_utils;
 
-Mesh::Mesh(aiMesh* mesh):
+/**
+ * @param quantize Whether to pack vertexes in compact format (see `VertexQuantized`)
+ */
+Mesh::Mesh(aiMesh* mesh, bool quantize):
+  is_quantized(quantize),
   m_mesh(mesh)
 {
-  set_vertexes();
+  set_bounds();
+
+  if (is_quantized)
+    set_vertexes_quantized();
+  else
+    set_vertexes();
+
   set_indices();
+  optimize();
   material = m_mesh->mMaterialIndex;
 }
 
+/* Mesh's bbox (only its corners kept instead of a copy of all positions) */
+void Mesh::set_bounds() {
+  aiVector3D* xyz_coords = m_mesh->mVertices;
+  unsigned int n_vertexes = m_mesh->mNumVertices;
+  glm::vec3 position_max(0.0f);
+  position_min = glm::vec3(0.0f);
+
+  for (size_t i_vertex = 0; i_vertex < n_vertexes; ++i_vertex) {
+    glm::vec3 position(xyz_coords[i_vertex].x, xyz_coords[i_vertex].y, xyz_coords[i_vertex].z);
+    position_min = (i_vertex == 0) ? position : glm::min(position_min, position);
+    position_max = (i_vertex == 0) ? position : glm::max(position_max, position);
+  }
+
+  position_extent = position_max - position_min;
+  positions = { position_min, position_max };
+}
+
 /* Set mesh vertexes consisting of positions, normals, uv texture coord, and tangent (i.e. local x-axis) */
 void Mesh::set_vertexes() {
   aiVector3D* xyz_coords = m_mesh->mVertices;
@@ -29,22 +63,60 @@ void Mesh::set_vertexes() {
   n_coords_vertex += (texture_coords != NULL) ? n_coords_texture : 0;
   n_coords_vertex += (tangents_coords != NULL) ? n_coords_tangent : 0;
 
+  // coords written directly into final buffer (no temporary vector per vertex)
   vertexes.resize(n_vertexes * n_coords_vertex);
-  positions.resize(n_vertexes);
+  float* coords = vertexes.data();
+
+  for (size_t i_vertex = 0; i_vertex < n_vertexes; ++i_vertex) {
+    *coords++ = xyz_coords[i_vertex].x;
+    *coords++ = xyz_coords[i_vertex].y;
+    *coords++ = xyz_coords[i_vertex].z;
+
+    if (normals_coords != NULL) {
+      *coords++ = normals_coords[i_vertex].x;
+      *coords++ = normals_coords[i_vertex].y;
+      *coords++ = normals_coords[i_vertex].z;
+    }
+
+    if (texture_coords != NULL) {
+      *coords++ = texture_coords[i_vertex].x;
+      *coords++ = texture_coords[i_vertex].y;
+    }
+
+    if (tangents_coords != NULL) {
+      *coords++ = tangents_coords[i_vertex].x;
+      *coords++ = tangents_coords[i_vertex].y;
+      *coords++ = tangents_coords[i_vertex].z;
+    }
+  }
+}
+
+/* Same attributes as above packed in `VertexQuantized` (missing ones left to zero) */
+void Mesh::set_vertexes_quantized() {
+  aiVector3D* xyz_coords = m_mesh->mVertices;
+  aiVector3D* normals_coords = m_mesh->mNormals;
+  aiVector3D* texture_coords = m_mesh->mTextureCoords[0];
+  aiVector3D* tangents_coords = m_mesh->mTangents;
+
+  unsigned int n_vertexes = m_mesh->mNumVertices;
+  const unsigned int n_floats_vertex = sizeof(VertexQuantized) / sizeof(float);
+  vertexes.resize(n_vertexes * n_floats_vertex);
+  char* bytes = reinterpret_cast<char*>(vertexes.data());
 
   for (size_t i_vertex = 0; i_vertex < n_vertexes; ++i_vertex) {
-    std::vector<float> vertex = { xyz_coords[i_vertex].x, xyz_coords[i_vertex].y, xyz_coords[i_vertex].z };
+    glm::vec3 position(xyz_coords[i_vertex].x, xyz_coords[i_vertex].y, xyz_coords[i_vertex].z);
+    glm::vec3 normal(0.0f), tangent(0.0f);
+    glm::vec2 texture_coord(0.0f);
 
-    // not all meshes have normals (also tangents computing requires normals) & texture coordinates
     if (normals_coords != NULL)
-      vertex.insert(vertex.end(), { normals_coords[i_vertex].x, normals_coords[i_vertex].y, normals_coords[i_vertex].z });
+      normal = glm::vec3(normals_coords[i_vertex].x, normals_coords[i_vertex].y, normals_coords[i_vertex].z);
     if (texture_coords != NULL)
-      vertex.insert(vertex.end(), { texture_coords[i_vertex].x, texture_coords[i_vertex].y });
+      texture_coord = glm::vec2(texture_coords[i_vertex].x, texture_coords[i_vertex].y);
     if (tangents_coords != NULL)
-      vertex.insert(vertex.end(), { tangents_coords[i_vertex].x, tangents_coords[i_vertex].y, tangents_coords[i_vertex].z });
+      tangent = glm::vec3(tangents_coords[i_vertex].x, tangents_coords[i_vertex].y, tangents_coords[i_vertex].z);
 
-    std::copy(vertex.begin(), vertex.end(), vertexes.begin() + i_vertex*n_coords_vertex);
-    positions[i_vertex] = glm::vec3(xyz_coords[i_vertex].x, xyz_coords[i_vertex].y, xyz_coords[i_vertex].z);
+    VertexQuantized vertex(position, normal, texture_coord, tangent, position_min, position_extent);
+    std::memcpy(bytes + i_vertex * sizeof(VertexQuantized), &vertex, sizeof(VertexQuantized));
   }
 }
 
@@ -63,16 +135,108 @@ void Mesh::set_indices() {
   }
 }
 
+/* Weld & reorder vertexes/triangles for vertex cache & overdraw (see `MeshOptimizer`) */
+void Mesh::optimize() {
+  aiVector3D* xyz_coords = m_mesh->mVertices;
+  std::vector<glm::vec3> positions_vertexes(m_mesh->mNumVertices);
+  for (size_t i_vertex = 0; i_vertex < positions_vertexes.size(); ++i_vertex)
+    positions_vertexes[i_vertex] = glm::vec3(xyz_coords[i_vertex].x, xyz_coords[i_vertex].y, xyz_coords[i_vertex].z);
+
+  stats_optimizer = MeshOptimizer::optimize(vertexes, indices, positions_vertexes);
+}
+
+/**
+ * Level of detail with a fraction of mesh's triangles (see `MeshSimplifier`)
+ * Unused vertexes dropped & triangles reordered for vertex cache like the full mesh
+ * Textures not copied as they can be uploaded meanwhile on gl thread (set later, see `Model::share_textures()`)
+ * @param ratio Fraction of triangles to keep (fewer kept if vertexes on seams/borders prevent it)
+ */
+Mesh Mesh::simplify(float ratio) const {
+  std::vector<glm::vec3> positions_vertexes = get_positions_vertexes();
+  unsigned int n_indices_target = 3 * static_cast<unsigned int>(ratio * indices.size() / 3);
+
+  Mesh mesh;
+  mesh.vertexes = vertexes;
+  mesh.positions = positions;
+  mesh.is_quantized = is_quantized;
+  mesh.position_min = position_min;
+  mesh.position_extent = position_extent;
+
+  mesh.material = material;
+  mesh.color = color;
+  mesh.has_texture_diffuse = has_texture_diffuse;
+  mesh.has_texture_normal = has_texture_normal;
+  mesh.filename_texture_diffuse = filename_texture_diffuse;
+  mesh.filename_texture_normal = filename_texture_normal;
+
+  mesh.indices = MeshSimplifier::simplify(indices, positions_vertexes, n_indices_target);
+  MeshOptimizer::optimize(mesh.vertexes, mesh.indices, positions_vertexes);
+
+  return mesh;
+}
+
+/* Copy of mesh without its vertexes & indices (only materials & bbox corners, see `Model::get_materials()`) */
+Mesh Mesh::get_materials() const {
+  Mesh mesh;
+  mesh.positions = positions;
+  mesh.is_quantized = is_quantized;
+  mesh.position_min = position_min;
+  mesh.position_extent = position_extent;
+
+  mesh.material = material;
+  mesh.color = color;
+  mesh.texture_diffuse = texture_diffuse;
+  mesh.texture_normal = texture_normal;
+  mesh.has_texture_diffuse = has_texture_diffuse;
+  mesh.has_texture_normal = has_texture_normal;
+  mesh.filename_texture_diffuse = filename_texture_diffuse;
+  mesh.filename_texture_normal = filename_texture_normal;
+  mesh.stats_optimizer = stats_optimizer;
+
+  return mesh;
+}
+
+/* Position of each vertex (decoded from mesh's bbox if quantized), as only bbox corners are kept in `positions` */
+std::vector<glm::vec3> Mesh::get_positions_vertexes() const {
+  if (indices.empty())
+    return {};
+
+  // vertexes all used by triangles since `optimize()` (stride of floats layout depends on attributes present)
+  unsigned int n_vertexes = *std::max_element(indices.begin(), indices.end()) + 1;
+  size_t stride = vertexes.size() / n_vertexes;
+  std::vector<glm::vec3> positions_vertexes(n_vertexes);
+
+  for (size_t i_vertex = 0; i_vertex < n_vertexes; ++i_vertex) {
+    const float* vertex = &vertexes[i_vertex * stride];
+
+    if (is_quantized) {
+      uint16_t position[3];
+      std::memcpy(position, reinterpret_cast<const char*>(vertex) + offsetof(VertexQuantized, position), sizeof(position));
+      glm::vec3 position_normalized(position[0], position[1], position[2]);
+      positions_vertexes[i_vertex] = position_min + position_extent * position_normalized / 65535.0f;
+    } else {
+      positions_vertexes[i_vertex] = glm::vec3(vertex[0], vertex[1], vertex[2]);
+    }
+  }
+
+  return positions_vertexes;
+}
+
 /**
  * Used in ModelRenderer::draw() to pass uniforms to shaders
  * Class members below set in Model class
  */
-void Mesh::set_uniforms(Uniforms& uniforms) {
+void Mesh::set_uniforms(Uniforms& uniforms) const {
     // retrieve material color from mesh
     uniforms["has_texture_diffuse"] = has_texture_diffuse;
     uniforms["has_texture_normal"] = has_texture_normal;
     uniforms["color"] = color;
 
+    // decode positions from mesh's bbox in vertex shader
+    uniforms["is_quantized"] = is_quantized;
+    uniforms["position_min"] = position_min;
+    uniforms["position_extent"] = position_extent;
+
     // no need to pass empty texture created (in `Mesh`) by default constructor
     if (has_texture_diffuse)
       uniforms["texture_diffuse"] = texture_diffuse;
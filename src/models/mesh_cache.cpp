@@ -0,0 +1,259 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+#include "models/mesh_cache.hpp"
+#include "utils/mapped_file.hpp"
+
+using namespace assimp_utils;
+
+static_assert(sizeof(unsigned int) == sizeof(uint32_t), "indices copied as 32-bit integers");
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "positions copied as packed xyz floats");
+
+namespace {
+  /**
+   * Model file & its material libraries it was cooked from (cache is stale once they differ)
+   * Followed by libraries paths referenced by model (one per line), then meshes
+   */
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    int64_t mtime_model;
+    int64_t mtime_material;
+    uint64_t size_model;
+    uint32_t n_meshes;
+    uint32_t is_quantized;
+    uint32_t length_libraries;
+    uint32_t padding;
+  };
+
+  /* Followed by vertexes, indices, positions, then diffuse & normal textures filenames */
+  struct MeshHeader {
+    uint32_t n_vertexes;
+    uint32_t n_indices;
+    uint32_t n_positions;
+    uint32_t material;
+    float color[3];
+    float position_min[3];
+    float position_extent[3];
+    uint32_t length_filename_diffuse;
+    uint32_t length_filename_normal;
+    uint8_t has_texture_diffuse;
+    uint8_t has_texture_normal;
+    uint8_t padding[2];
+  };
+
+  /* Modification time in ns (0 if file doesn't exist) */
+  int64_t get_mtime(const std::string& path, uint64_t* size = nullptr) {
+    struct stat status;
+    if (stat(path.c_str(), &status) != 0)
+      return 0;
+
+    if (size != nullptr)
+      *size = status.st_size;
+
+    return (int64_t) status.st_mtim.tv_sec * 1000000000 + status.st_mtim.tv_nsec;
+  }
+
+  /**
+   * Material libraries holding meshes colors & textures filenames, as referenced by `mtllib` lines in .obj
+   * (rest of line is the filename, like Assimp's parser), only scanned when cache is written
+   * @return Paths relative to model's directory, one per line
+   */
+  std::string get_libraries(const std::string& path_model) {
+    std::ifstream file(path_model);
+    std::string line, libraries;
+
+    while (std::getline(file, line)) {
+      size_t start = line.find_first_not_of(" \t");
+      if (start == std::string::npos || line.compare(start, 6, "mtllib") != 0)
+        continue;
+
+      size_t start_filename = line.find_first_not_of(" \t", start + 6);
+      size_t end_filename = line.find_last_not_of(" \t\r");
+      if (start_filename == std::string::npos || start_filename == start + 6)
+        continue;
+
+      libraries += line.substr(start_filename, end_filename + 1 - start_filename) + '\n';
+    }
+
+    return libraries;
+  }
+
+  /* Latest modification time among material libraries (missing ones count as 0) */
+  int64_t get_mtime_libraries(const std::string& path_model, const std::string& libraries) {
+    std::string directory = path_model.substr(0, path_model.find_last_of('/') + 1);
+    std::istringstream stream(libraries);
+    std::string library;
+    int64_t mtime = 0;
+
+    while (std::getline(stream, library))
+      mtime = std::max(mtime, get_mtime(directory + library));
+
+    return mtime;
+  }
+
+  /* Material libraries' time filled separately (their paths are read from cache or model) */
+  Header get_header(const std::string& path_model) {
+    Header header = {};
+    header.magic = MeshCache::MAGIC;
+    header.version = MeshCache::VERSION;
+    header.mtime_model = get_mtime(path_model, &header.size_model);
+
+    return header;
+  }
+
+  /* Copies bytes at cursor, fails instead of reading past the end (truncated file) */
+  struct Reader {
+    const char* cursor;
+    const char* end;
+
+    /* Checked before allocating arrays sized from file (corrupted counts can't trigger huge allocations) */
+    bool has(uint64_t size) const {
+      return size <= (uint64_t) (end - cursor);
+    }
+
+    bool read(void* destination, size_t size) {
+      if (!has(size))
+        return false;
+
+      if (size > 0)
+        std::memcpy(destination, cursor, size);
+      cursor += size;
+      return true;
+    }
+  };
+
+  template <typename T>
+  void write(std::ofstream& file, const T* data, size_t count) {
+    file.write(reinterpret_cast<const char*>(data), count * sizeof(T));
+  }
+}
+
+/* Cooked file written beside model (assets are copied to build dir, so source tree is left untouched) */
+std::string MeshCache::get_path(const std::string& path_model) {
+  return path_model + ".mesh";
+}
+
+/**
+ * Fill meshes from cache (textures filenames only, images loaded by `Model`)
+ * @param is_quantized Vertexes layout expected by caller
+ * @return false if cache is missing, stale, truncated or corrupted (meshes left empty)
+ */
+bool MeshCache::load(const std::string& path_model, std::vector<Mesh>& meshes, bool is_quantized) {
+  MappedFile file(get_path(path_model));
+  if (file.data == nullptr)
+    return false;
+
+  Reader reader = { file.data, file.data + file.size };
+  Header header;
+  Header header_expected = get_header(path_model);
+  if (!reader.read(&header, sizeof(Header)) || header.magic != MAGIC || header.version != VERSION ||
+      header.mtime_model != header_expected.mtime_model || header.size_model != header_expected.size_model ||
+      header.is_quantized != is_quantized || !reader.has(header.length_libraries))
+    return false;
+
+  // model unchanged, so it still references the same libraries
+  std::string libraries(reader.cursor, header.length_libraries);
+  reader.cursor += header.length_libraries;
+  if (header.mtime_material != get_mtime_libraries(path_model, libraries) ||
+      !reader.has((uint64_t) header.n_meshes * sizeof(MeshHeader)))
+    return false;
+
+  std::vector<Mesh> meshes_cache(header.n_meshes);
+
+  for (Mesh& mesh : meshes_cache) {
+    MeshHeader header_mesh;
+    if (!reader.read(&header_mesh, sizeof(MeshHeader)))
+      return false;
+
+    uint64_t size_mesh = (uint64_t) header_mesh.n_vertexes * sizeof(float) + (uint64_t) header_mesh.n_indices * sizeof(unsigned int) +
+                         (uint64_t) header_mesh.n_positions * sizeof(glm::vec3) +
+                         (uint64_t) header_mesh.length_filename_diffuse + header_mesh.length_filename_normal;
+    if (!reader.has(size_mesh))
+      return false;
+
+    mesh.vertexes.resize(header_mesh.n_vertexes);
+    mesh.indices.resize(header_mesh.n_indices);
+    mesh.positions.resize(header_mesh.n_positions);
+    mesh.filename_texture_diffuse.resize(header_mesh.length_filename_diffuse);
+    mesh.filename_texture_normal.resize(header_mesh.length_filename_normal);
+
+    if (!reader.read(mesh.vertexes.data(), mesh.vertexes.size() * sizeof(float)) ||
+        !reader.read(mesh.indices.data(), mesh.indices.size() * sizeof(unsigned int)) ||
+        !reader.read(mesh.positions.data(), mesh.positions.size() * sizeof(glm::vec3)) ||
+        !reader.read(&mesh.filename_texture_diffuse[0], mesh.filename_texture_diffuse.size()) ||
+        !reader.read(&mesh.filename_texture_normal[0], mesh.filename_texture_normal.size()))
+      return false;
+
+    mesh.material = header_mesh.material;
+    mesh.color = glm::vec3(header_mesh.color[0], header_mesh.color[1], header_mesh.color[2]);
+    mesh.has_texture_diffuse = header_mesh.has_texture_diffuse;
+    mesh.has_texture_normal = header_mesh.has_texture_normal;
+    mesh.is_quantized = is_quantized;
+    mesh.position_min = glm::vec3(header_mesh.position_min[0], header_mesh.position_min[1], header_mesh.position_min[2]);
+    mesh.position_extent = glm::vec3(header_mesh.position_extent[0], header_mesh.position_extent[1], header_mesh.position_extent[2]);
+  }
+
+  meshes = std::move(meshes_cache);
+  return true;
+}
+
+/**
+ * Write meshes parsed by Assimp to cache
+ * Written to temporary file then renamed, so a crash never leaves a truncated cache behind
+ * @return false if cache couldn't be written (model still usable)
+ */
+bool MeshCache::save(const std::string& path_model, const std::vector<Mesh>& meshes) {
+  std::string path_cache = get_path(path_model);
+  std::string path_tmp = path_cache + ".tmp";
+  std::ofstream file(path_tmp, std::ios::binary);
+  if (!file)
+    return false;
+
+  std::string libraries = get_libraries(path_model);
+  Header header = get_header(path_model);
+  header.mtime_material = get_mtime_libraries(path_model, libraries);
+  header.n_meshes = meshes.size();
+  header.is_quantized = !meshes.empty() && meshes[0].is_quantized;
+  header.length_libraries = libraries.size();
+  write(file, &header, 1);
+  write(file, libraries.data(), libraries.size());
+
+  for (const Mesh& mesh : meshes) {
+    MeshHeader header_mesh = {};
+    header_mesh.n_vertexes = mesh.vertexes.size();
+    header_mesh.n_indices = mesh.indices.size();
+    header_mesh.n_positions = mesh.positions.size();
+    header_mesh.material = mesh.material;
+    header_mesh.color[0] = mesh.color.x;
+    header_mesh.color[1] = mesh.color.y;
+    header_mesh.color[2] = mesh.color.z;
+    for (size_t i_coord = 0; i_coord < 3; ++i_coord) {
+      header_mesh.position_min[i_coord] = mesh.position_min[i_coord];
+      header_mesh.position_extent[i_coord] = mesh.position_extent[i_coord];
+    }
+    header_mesh.length_filename_diffuse = mesh.filename_texture_diffuse.size();
+    header_mesh.length_filename_normal = mesh.filename_texture_normal.size();
+    header_mesh.has_texture_diffuse = mesh.has_texture_diffuse;
+    header_mesh.has_texture_normal = mesh.has_texture_normal;
+
+    write(file, &header_mesh, 1);
+    write(file, mesh.vertexes.data(), mesh.vertexes.size());
+    write(file, mesh.indices.data(), mesh.indices.size());
+    write(file, mesh.positions.data(), mesh.positions.size());
+    write(file, mesh.filename_texture_diffuse.data(), mesh.filename_texture_diffuse.size());
+    write(file, mesh.filename_texture_normal.data(), mesh.filename_texture_normal.size());
+  }
+
+  file.close();
+  if (!file) {
+    std::remove(path_tmp.c_str());
+    return false;
+  }
+
+  return std::rename(path_tmp.c_str(), path_cache.c_str()) == 0;
+}
@@ -0,0 +1,308 @@
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+#include "models/mesh_optimizer.hpp"
+
+using namespace assimp_utils;
+
+/**
+ * Optimize mesh in place (same triangles, fewer vertexes & in a cache-friendly order)
+ * @param vertexes Floats or packed vertexes (same # of floats for each vertex)
+ * @param positions Position of each vertex (needed to sort clusters), reordered with vertexes
+ */
+MeshOptimizer::Stats MeshOptimizer::optimize(std::vector<float>& vertexes, std::vector<unsigned int>& indices, std::vector<glm::vec3>& positions) {
+  Stats stats;
+  stats.n_vertexes_before = positions.size();
+  stats.acmr_before = get_acmr(indices, positions.size());
+
+  if (!indices.empty() && !positions.empty()) {
+    weld(vertexes, indices, positions);
+    std::vector<unsigned int> boundaries = reorder_tipsify(indices, positions.size());
+    reorder_clusters(indices, boundaries, positions);
+    reorder_vertexes(vertexes, indices, positions);
+  }
+
+  stats.n_vertexes_after = positions.size();
+  stats.acmr_after = get_acmr(indices, positions.size());
+  return stats;
+}
+
+/**
+ * Simulate a FIFO post-transform cache (vertex in cache if it missed less than `cache_size` misses ago)
+ * @return # of cache misses per triangle
+ */
+float MeshOptimizer::get_acmr(const std::vector<unsigned int>& indices, unsigned int n_vertexes, unsigned int cache_size) {
+  if (indices.empty())
+    return 0.0f;
+
+  std::vector<unsigned int> timestamps(n_vertexes, 0);
+  unsigned int time = cache_size + 1;
+  unsigned int n_misses = 0;
+
+  for (unsigned int index : indices) {
+    if (time - timestamps[index] > cache_size) {
+      timestamps[index] = time++;
+      n_misses++;
+    }
+  }
+
+  return (float) n_misses / (indices.size() / 3);
+}
+
+/* Merge vertexes with identical bytes (all attributes equal), kept in order of their first occurrence */
+void MeshOptimizer::weld(std::vector<float>& vertexes, std::vector<unsigned int>& indices, std::vector<glm::vec3>& positions) {
+  const size_t n_vertexes = positions.size();
+  const size_t stride = vertexes.size() / n_vertexes;
+  const char* bytes = reinterpret_cast<const char*>(vertexes.data());
+
+  // keys point into `vertexes` (not modified until all vertexes are remapped)
+  std::unordered_map<std::string_view, unsigned int> vertexes_unique;
+  vertexes_unique.reserve(n_vertexes);
+  std::vector<unsigned int> remap(n_vertexes);
+
+  for (size_t i_vertex = 0; i_vertex < n_vertexes; ++i_vertex) {
+    std::string_view key(bytes + i_vertex * stride * sizeof(float), stride * sizeof(float));
+    auto it_vertex = vertexes_unique.emplace(key, vertexes_unique.size()).first;
+    remap[i_vertex] = it_vertex->second;
+  }
+
+  // first occurrences are numbered in increasing order, so they can be compacted forward in place
+  unsigned int n_vertexes_unique = 0;
+  for (size_t i_vertex = 0; i_vertex < n_vertexes; ++i_vertex) {
+    if (remap[i_vertex] != n_vertexes_unique)
+      continue;
+
+    std::memmove(&vertexes[n_vertexes_unique * stride], &vertexes[i_vertex * stride], stride * sizeof(float));
+    positions[n_vertexes_unique] = positions[i_vertex];
+    n_vertexes_unique++;
+  }
+
+  vertexes.resize(n_vertexes_unique * stride);
+  positions.resize(n_vertexes_unique);
+  for (unsigned int& index : indices)
+    index = remap[index];
+}
+
+/**
+ * Tipsify: emit all triangles around a fanning vertex, then fan around the vertex (among these triangles')
+ * most likely to still be in cache once its remaining triangles are emitted
+ * @return Hard boundaries (1st triangle of each cluster), where no neighbouring vertex was left to fan around
+ */
+std::vector<unsigned int> MeshOptimizer::reorder_tipsify(std::vector<unsigned int>& indices, unsigned int n_vertexes) {
+  const unsigned int n_triangles = indices.size() / 3;
+
+  // triangles adjacent to each vertex (i.e. using it) & how many of them aren't emitted yet
+  std::vector<unsigned int> n_triangles_live(n_vertexes, 0);
+  for (unsigned int index : indices)
+    n_triangles_live[index]++;
+
+  std::vector<unsigned int> offsets(n_vertexes + 1, 0);
+  for (size_t i_vertex = 0; i_vertex < n_vertexes; ++i_vertex)
+    offsets[i_vertex + 1] = offsets[i_vertex] + n_triangles_live[i_vertex];
+
+  std::vector<unsigned int> adjacency(indices.size());
+  std::vector<unsigned int> n_triangles_adjacent(n_vertexes, 0);
+  for (size_t i_index = 0; i_index < indices.size(); ++i_index) {
+    unsigned int index = indices[i_index];
+    adjacency[offsets[index] + n_triangles_adjacent[index]++] = i_index / 3;
+  }
+
+  std::vector<unsigned int> timestamps(n_vertexes, 0);
+  std::vector<bool> is_emitted(n_triangles, false);
+  std::vector<unsigned int> dead_ends, candidates, indices_out, boundaries;
+  indices_out.reserve(indices.size());
+  unsigned int time = CACHE_SIZE + 1;
+  unsigned int cursor = 0;
+  int vertex_fanning = 0;
+
+  while (vertex_fanning >= 0) {
+    candidates.clear();
+
+    for (size_t i_adjacent = offsets[vertex_fanning]; i_adjacent < offsets[vertex_fanning + 1]; ++i_adjacent) {
+      unsigned int i_triangle = adjacency[i_adjacent];
+      if (is_emitted[i_triangle])
+        continue;
+
+      for (size_t i_corner = 0; i_corner < 3; ++i_corner) {
+        unsigned int index = indices[3*i_triangle + i_corner];
+        indices_out.push_back(index);
+        dead_ends.push_back(index);
+        candidates.push_back(index);
+        n_triangles_live[index]--;
+
+        if (time - timestamps[index] > CACHE_SIZE)
+          timestamps[index] = time++;
+      }
+
+      is_emitted[i_triangle] = true;
+    }
+
+    // prefer oldest candidate that stays in cache while its remaining triangles are emitted
+    int vertex_next = -1;
+    int priority_best = -1;
+    for (unsigned int candidate : candidates) {
+      if (n_triangles_live[candidate] == 0)
+        continue;
+
+      int priority = 0;
+      if (time - timestamps[candidate] + 2 * n_triangles_live[candidate] <= CACHE_SIZE)
+        priority = time - timestamps[candidate];
+
+      if (priority > priority_best) {
+        priority_best = priority;
+        vertex_next = candidate;
+      }
+    }
+
+    if (vertex_next == -1) {
+      // dead-end: most recent vertex with triangles left, otherwise next one in input order
+      while (!dead_ends.empty() && vertex_next == -1) {
+        unsigned int vertex = dead_ends.back();
+        dead_ends.pop_back();
+        if (n_triangles_live[vertex] > 0)
+          vertex_next = vertex;
+      }
+
+      while (vertex_next == -1 && cursor < n_vertexes) {
+        if (n_triangles_live[cursor] > 0)
+          vertex_next = cursor;
+        cursor++;
+      }
+
+      unsigned int n_triangles_out = indices_out.size() / 3;
+      if (vertex_next != -1 && n_triangles_out > 0 && (boundaries.empty() || boundaries.back() != n_triangles_out))
+        boundaries.push_back(n_triangles_out);
+    }
+
+    vertex_fanning = vertex_next;
+  }
+
+  boundaries.insert(boundaries.begin(), 0);
+  indices = std::move(indices_out);
+  return boundaries;
+}
+
+/**
+ * Split clusters further as soon as their own ACMR (starting from an empty cache) drops below the mesh's one,
+ * so they can be drawn in any order without degrading vertex cache much.
+ * Then sort them to draw first those facing away from mesh's center (likely to occlude the others)
+ * @param boundaries Hard boundaries from Tipsify
+ */
+void MeshOptimizer::reorder_clusters(std::vector<unsigned int>& indices, const std::vector<unsigned int>& boundaries, const std::vector<glm::vec3>& positions) {
+  const unsigned int n_triangles = indices.size() / 3;
+  const float acmr_threshold = get_acmr(indices, positions.size());
+
+  // soft boundaries (cache flushed at the start of each cluster)
+  std::vector<unsigned int> timestamps(positions.size(), 0);
+  std::vector<unsigned int> starts;
+  unsigned int time = CACHE_SIZE + 1;
+
+  for (size_t i_boundary = 0; i_boundary < boundaries.size(); ++i_boundary) {
+    unsigned int end = (i_boundary + 1 < boundaries.size()) ? boundaries[i_boundary + 1] : n_triangles;
+    unsigned int start = boundaries[i_boundary];
+    unsigned int n_misses = 0;
+    starts.push_back(start);
+    time += CACHE_SIZE + 1;
+
+    for (unsigned int i_triangle = start; i_triangle < end; ++i_triangle) {
+      for (size_t i_corner = 0; i_corner < 3; ++i_corner) {
+        unsigned int index = indices[3*i_triangle + i_corner];
+        if (time - timestamps[index] > CACHE_SIZE) {
+          timestamps[index] = time++;
+          n_misses++;
+        }
+      }
+
+      if (i_triangle + 1 < end && n_misses <= acmr_threshold * (i_triangle + 1 - start)) {
+        start = i_triangle + 1;
+        n_misses = 0;
+        starts.push_back(start);
+        time += CACHE_SIZE + 1;
+      }
+    }
+  }
+
+  // area-weighted centroid & normal of each cluster & of whole mesh
+  struct Cluster {
+    unsigned int start;
+    unsigned int end;
+    glm::vec3 centroid;
+    glm::vec3 normal;
+    float area;
+    float sort_key;
+  };
+
+  std::vector<Cluster> clusters(starts.size());
+  glm::vec3 centroid_mesh(0.0f);
+  float area_mesh = 0.0f;
+
+  for (size_t i_cluster = 0; i_cluster < clusters.size(); ++i_cluster) {
+    Cluster& cluster = clusters[i_cluster];
+    cluster = { starts[i_cluster], (i_cluster + 1 < starts.size()) ? starts[i_cluster + 1] : n_triangles, glm::vec3(0.0f), glm::vec3(0.0f), 0.0f, 0.0f };
+
+    for (unsigned int i_triangle = cluster.start; i_triangle < cluster.end; ++i_triangle) {
+      glm::vec3 p0 = positions[indices[3*i_triangle]];
+      glm::vec3 p1 = positions[indices[3*i_triangle + 1]];
+      glm::vec3 p2 = positions[indices[3*i_triangle + 2]];
+      glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+      float area = 0.5f * glm::length(normal);
+
+      cluster.normal += normal;
+      cluster.centroid += area * (p0 + p1 + p2) / 3.0f;
+      cluster.area += area;
+    }
+
+    centroid_mesh += cluster.centroid;
+    area_mesh += cluster.area;
+  }
+
+  if (area_mesh > 0.0f)
+    centroid_mesh /= area_mesh;
+
+  for (Cluster& cluster : clusters) {
+    float length_normal = glm::length(cluster.normal);
+    if (cluster.area > 0.0f && length_normal > 0.0f)
+      cluster.sort_key = glm::dot(cluster.centroid / cluster.area - centroid_mesh, cluster.normal / length_normal);
+  }
+
+  std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& cluster1, const Cluster& cluster2) {
+    return cluster1.sort_key > cluster2.sort_key;
+  });
+
+  std::vector<unsigned int> indices_out;
+  indices_out.reserve(indices.size());
+  for (const Cluster& cluster : clusters)
+    indices_out.insert(indices_out.end(), indices.begin() + 3*cluster.start, indices.begin() + 3*cluster.end);
+
+  indices = std::move(indices_out);
+}
+
+/* Renumber vertexes in order of their first use by triangles (unused ones dropped) */
+void MeshOptimizer::reorder_vertexes(std::vector<float>& vertexes, std::vector<unsigned int>& indices, std::vector<glm::vec3>& positions) {
+  const size_t n_vertexes = positions.size();
+  const size_t stride = vertexes.size() / n_vertexes;
+  const unsigned int NO_VERTEX = static_cast<unsigned int>(-1);
+
+  std::vector<unsigned int> remap(n_vertexes, NO_VERTEX);
+  unsigned int n_vertexes_used = 0;
+  for (unsigned int& index : indices) {
+    if (remap[index] == NO_VERTEX)
+      remap[index] = n_vertexes_used++;
+    index = remap[index];
+  }
+
+  std::vector<float> vertexes_out(n_vertexes_used * stride);
+  std::vector<glm::vec3> positions_out(n_vertexes_used);
+  for (size_t i_vertex = 0; i_vertex < n_vertexes; ++i_vertex) {
+    if (remap[i_vertex] == NO_VERTEX)
+      continue;
+
+    std::memcpy(&vertexes_out[remap[i_vertex] * stride], &vertexes[i_vertex * stride], stride * sizeof(float));
+    positions_out[remap[i_vertex]] = positions[i_vertex];
+  }
+
+  vertexes = std::move(vertexes_out);
+  positions = std::move(positions_out);
+}
@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+
+#include "models/mesh_simplifier.hpp"
+
+using namespace assimp_utils;
+
+namespace {
+  /* Symmetric 4x4 matrix summing squared distances to planes: xx xy xz xw yy yz yw zz zw ww */
+  struct Quadric {
+    std::array<double, 10> a = {};
+
+    void add_plane(const glm::dvec3& normal, double d, double weight) {
+      double x = normal.x, y = normal.y, z = normal.z;
+      std::array<double, 10> plane = { x*x, x*y, x*z, x*d, y*y, y*z, y*d, z*z, z*d, d*d };
+      for (size_t i = 0; i < a.size(); ++i)
+        a[i] += weight * plane[i];
+    }
+
+    void add(const Quadric& quadric) {
+      for (size_t i = 0; i < a.size(); ++i)
+        a[i] += quadric.a[i];
+    }
+
+    /* Weighted sum of squared distances from point to planes */
+    double evaluate(const glm::dvec3& p) const {
+      return a[0]*p.x*p.x + 2.0*a[1]*p.x*p.y + 2.0*a[2]*p.x*p.z + 2.0*a[3]*p.x
+           + a[4]*p.y*p.y + 2.0*a[5]*p.y*p.z + 2.0*a[6]*p.y
+           + a[7]*p.z*p.z + 2.0*a[8]*p.z
+           + a[9];
+    }
+  };
+
+  /* Collapse of vertex `from` onto vertex `to` (indices in vertexes buffer) */
+  struct Collapse {
+    unsigned int from;
+    unsigned int to;
+    double cost;
+  };
+}
+
+/**
+ * Greedy edge collapses by increasing quadric error, in passes where each vertex is touched at most once
+ * (so costs & adjacency computed at the start of a pass stay valid), until target # of indices is reached
+ * or no edge can be collapsed without removing a locked vertex or flipping a triangle
+ * @param positions Position of each vertex (vertexes with same position but other attributes form a seam)
+ * @return Indices of simplified mesh (same vertexes referenced)
+ */
+std::vector<unsigned int> MeshSimplifier::simplify(const std::vector<unsigned int>& indices, const std::vector<glm::vec3>& positions, unsigned int n_indices_target) {
+  const size_t n_vertexes = positions.size();
+  std::vector<unsigned int> indices_out = indices;
+  if (indices.size() <= n_indices_target || n_vertexes == 0)
+    return indices_out;
+
+  // vertexes sharing the same position (split by attributes seams) get the same position id
+  std::unordered_map<std::string_view, unsigned int> positions_unique;
+  std::vector<unsigned int> ids_position(n_vertexes);
+  std::vector<unsigned int> n_vertexes_position;
+  const char* bytes = reinterpret_cast<const char*>(positions.data());
+
+  for (size_t i_vertex = 0; i_vertex < n_vertexes; ++i_vertex) {
+    std::string_view key(bytes + i_vertex * sizeof(glm::vec3), sizeof(glm::vec3));
+    auto it_position = positions_unique.emplace(key, n_vertexes_position.size()).first;
+    if (it_position->second == n_vertexes_position.size())
+      n_vertexes_position.push_back(0);
+
+    ids_position[i_vertex] = it_position->second;
+    n_vertexes_position[it_position->second]++;
+  }
+
+  // seams, borders (edges with one triangle) & non-manifold edges are locked
+  const size_t n_positions = n_vertexes_position.size();
+  std::vector<bool> is_locked(n_positions, false);
+  for (size_t i_position = 0; i_position < n_positions; ++i_position)
+    is_locked[i_position] = n_vertexes_position[i_position] > 1;
+
+  std::unordered_map<uint64_t, unsigned int> n_triangles_edges;
+  for (size_t i_index = 0; i_index < indices_out.size(); ++i_index) {
+    unsigned int id0 = ids_position[indices_out[i_index]];
+    unsigned int id1 = ids_position[indices_out[i_index - i_index % 3 + (i_index + 1) % 3]];
+    n_triangles_edges[(uint64_t) std::min(id0, id1) << 32 | std::max(id0, id1)]++;
+  }
+
+  for (const auto& [edge, n_triangles_edge] : n_triangles_edges) {
+    if (n_triangles_edge != 2) {
+      is_locked[edge >> 32] = true;
+      is_locked[edge & 0xffffffff] = true;
+    }
+  }
+
+  // planes of adjacent triangles weighted by their area
+  std::vector<Quadric> quadrics(n_positions);
+  for (size_t i_index = 0; i_index < indices_out.size(); i_index += 3) {
+    glm::dvec3 p0 = positions[indices_out[i_index]];
+    glm::dvec3 p1 = positions[indices_out[i_index + 1]];
+    glm::dvec3 p2 = positions[indices_out[i_index + 2]];
+    glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+    double length = glm::length(normal);
+    if (length == 0.0)
+      continue;
+
+    normal /= length;
+    for (unsigned int index : { indices_out[i_index], indices_out[i_index + 1], indices_out[i_index + 2] })
+      quadrics[ids_position[index]].add_plane(normal, -glm::dot(normal, p0), 0.5 * length);
+  }
+
+  std::vector<unsigned int> offsets(n_vertexes + 1), adjacency, remap(n_vertexes);
+  std::vector<bool> is_touched(n_vertexes);
+  std::vector<Collapse> collapses;
+
+  while (indices_out.size() > n_indices_target) {
+    // triangles adjacent to each vertex
+    std::fill(offsets.begin(), offsets.end(), 0);
+    for (unsigned int index : indices_out)
+      offsets[index + 1]++;
+    for (size_t i_vertex = 0; i_vertex < n_vertexes; ++i_vertex)
+      offsets[i_vertex + 1] += offsets[i_vertex];
+
+    adjacency.resize(indices_out.size());
+    std::vector<unsigned int> n_triangles_adjacent(n_vertexes, 0);
+    for (size_t i_index = 0; i_index < indices_out.size(); ++i_index) {
+      unsigned int index = indices_out[i_index];
+      adjacency[offsets[index] + n_triangles_adjacent[index]++] = i_index / 3;
+    }
+
+    // candidate collapses along triangles edges, from a removable vertex onto its neighbour
+    collapses.clear();
+    for (size_t i_index = 0; i_index < indices_out.size(); ++i_index) {
+      unsigned int from = indices_out[i_index];
+      unsigned int to = indices_out[i_index - i_index % 3 + (i_index + 1) % 3];
+      unsigned int id_from = ids_position[from], id_to = ids_position[to];
+
+      for (int i_direction = 0; i_direction < 2; ++i_direction) {
+        if (!is_locked[id_from] && id_from != id_to) {
+          Quadric quadric = quadrics[id_from];
+          quadric.add(quadrics[id_to]);
+          collapses.push_back({ from, to, quadric.evaluate(positions[to]) });
+        }
+
+        std::swap(from, to);
+        std::swap(id_from, id_to);
+      }
+    }
+
+    std::sort(collapses.begin(), collapses.end(), [](const Collapse& collapse1, const Collapse& collapse2) {
+      return collapse1.cost < collapse2.cost;
+    });
+
+    std::fill(is_touched.begin(), is_touched.end(), false);
+    for (size_t i_vertex = 0; i_vertex < n_vertexes; ++i_vertex)
+      remap[i_vertex] = i_vertex;
+
+    size_t n_triangles = indices_out.size() / 3;
+    size_t n_triangles_target = n_indices_target / 3;
+    size_t n_collapses = 0;
+
+    for (const Collapse& collapse : collapses) {
+      if (n_triangles <= n_triangles_target)
+        break;
+      if (is_touched[collapse.from] || is_touched[collapse.to])
+        continue;
+
+      // reject collapse if a remaining triangle around `from` would flip (or become degenerate)
+      glm::vec3 position_to = positions[collapse.to];
+      bool is_flipping = false;
+      size_t n_triangles_removed = 0;
+
+      for (size_t i_adjacent = offsets[collapse.from]; i_adjacent < offsets[collapse.from + 1] && !is_flipping; ++i_adjacent) {
+        const unsigned int* triangle = &indices_out[3 * adjacency[i_adjacent]];
+        unsigned int id_to = ids_position[collapse.to];
+        if (ids_position[triangle[0]] == id_to || ids_position[triangle[1]] == id_to || ids_position[triangle[2]] == id_to) {
+          n_triangles_removed++;
+          continue;
+        }
+
+        glm::vec3 p[3], q[3];
+        for (size_t i_corner = 0; i_corner < 3; ++i_corner) {
+          p[i_corner] = positions[triangle[i_corner]];
+          q[i_corner] = (triangle[i_corner] == collapse.from) ? position_to : p[i_corner];
+        }
+
+        glm::vec3 normal_before = glm::cross(p[1] - p[0], p[2] - p[0]);
+        glm::vec3 normal_after = glm::cross(q[1] - q[0], q[2] - q[0]);
+        is_flipping = glm::dot(normal_before, normal_after) <= 0.0f;
+      }
+
+      if (is_flipping)
+        continue;
+
+      // vertexes of triangles around `from` change, so their costs are outdated until next pass
+      for (size_t i_adjacent = offsets[collapse.from]; i_adjacent < offsets[collapse.from + 1]; ++i_adjacent) {
+        for (size_t i_corner = 0; i_corner < 3; ++i_corner)
+          is_touched[indices_out[3 * adjacency[i_adjacent] + i_corner]] = true;
+      }
+
+      remap[collapse.from] = collapse.to;
+      quadrics[ids_position[collapse.to]].add(quadrics[ids_position[collapse.from]]);
+      n_triangles -= n_triangles_removed;
+      n_collapses++;
+    }
+
+    if (n_collapses == 0)
+      break;
+
+    // drop triangles whose corners were merged (by position, as seam vertexes are distinct indices)
+    size_t n_indices = 0;
+    for (size_t i_index = 0; i_index < indices_out.size(); i_index += 3) {
+      unsigned int i0 = remap[indices_out[i_index]], i1 = remap[indices_out[i_index + 1]], i2 = remap[indices_out[i_index + 2]];
+      unsigned int id0 = ids_position[i0], id1 = ids_position[i1], id2 = ids_position[i2];
+      if (id0 == id1 || id1 == id2 || id2 == id0)
+        continue;
+
+      indices_out[n_indices++] = i0;
+      indices_out[n_indices++] = i1;
+      indices_out[n_indices++] = i2;
+    }
+
+    indices_out.resize(n_indices);
+  }
+
+  return indices_out;
+}
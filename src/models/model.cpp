@@ -4,18 +4,103 @@
 
 #include "models/model.hpp"
 #include "models/model_exception.hpp"
+#include "models/mesh_cache.hpp"
+#include "profiling/profiler.hpp"
 
 using namespace assimp_utils;
 
 /**
- * Load 3d model in .obj ascii format with Assimp
+ * Load 3d model from its mesh cache, or in .obj ascii format with Assimp (then cached for next launch)
+ * No gl calls (safe on worker thread), textures images are only decoded until `upload_textures()`
  * @param path
  * @param importer Scene will be destroyed upon destruction of importer
+ * @param quantize Whether to pack vertexes in compact format (less than half the size of floats)
  */
-Model::Model(const std::string& path, Assimp::Importer& importer):
+Model::Model(const std::string& path, Assimp::Importer& importer, bool quantize):
   m_path(path),
-  m_directory(m_path.substr(0, m_path.find_last_of('/')))
+  m_directory(m_path.substr(0, m_path.find_last_of('/'))),
+  m_is_quantized(quantize)
 {
+  PROFILE_ZONE("Model::Model");
+
+  // parse model with Assimp only if cooked meshes are missing or older than model
+  if (MeshCache::load(m_path, meshes, m_is_quantized)) {
+    std::cout << "Loaded " << meshes.size() << " meshes from cache..." << '\n';
+  } else {
+    parse_scene(importer);
+
+    if (!MeshCache::save(m_path, meshes))
+      std::cout << "Failed to write mesh cache for " << m_path << '\n';
+  }
+
+  // textures images aren't cached (uploaded to gpu in any case)
+  for (const Mesh& mesh : meshes) {
+    if (mesh.has_texture_diffuse)
+      load_image(mesh.filename_texture_diffuse);
+    if (mesh.has_texture_normal)
+      load_image(mesh.filename_texture_normal);
+  }
+}
+
+/* Decode image in model's directory (meshes can share same image) */
+void Model::load_image(const std::string& filename) {
+  std::string path_image = m_directory + "/" + filename;
+  if (m_images.find(path_image) == m_images.end())
+    m_images[path_image] = Image(path_image);
+}
+
+/* Create textures from decoded images (on gl thread) */
+void Model::upload_textures() {
+  for (size_t i_mesh = 0; i_mesh < meshes.size(); ++i_mesh)
+    load_textures(i_mesh);
+}
+
+/* Reuse textures uploaded by model this one was simplified from (on gl thread, images not decoded again) */
+void Model::share_textures(const Model& model) {
+  m_textures_loaded = model.m_textures_loaded;
+  upload_textures();
+}
+
+/**
+ * Copy of model with simplified meshes, built field by field so images & textures aren't copied (no gl calls, safe on worker thread)
+ * Textures shared with this model by `share_textures()`
+ * @param ratio Fraction of triangles to keep in each mesh
+ */
+Model Model::get_lod(float ratio) const {
+  Model model;
+  model.m_scene = NULL;
+  model.m_path = m_path;
+  model.m_directory = m_directory;
+  model.m_is_quantized = m_is_quantized;
+
+  model.meshes.reserve(meshes.size());
+  for (const Mesh& mesh : meshes)
+    model.meshes.push_back(mesh.simplify(ratio));
+
+  return model;
+}
+
+/**
+ * Model without meshes vertexes & indices (once uploaded to gpu), built field by field so geometry & images are never copied
+ * Materials & textures kept to draw meshes, as well as bbox corners
+ */
+Model Model::get_materials() const {
+  Model model;
+  model.m_scene = NULL;
+  model.m_path = m_path;
+  model.m_directory = m_directory;
+  model.m_is_quantized = m_is_quantized;
+  model.m_textures_loaded = m_textures_loaded;
+
+  model.meshes.reserve(meshes.size());
+  for (const Mesh& mesh : meshes)
+    model.meshes.push_back(mesh.get_materials());
+
+  return model;
+}
+
+/* Extract meshes from scene loaded with Assimp */
+void Model::parse_scene(Assimp::Importer& importer) {
   if (!load_scene(importer)) {
     throw ModelException();
   }
@@ -29,33 +114,40 @@ Model::Model(const std::string& path, Assimp::Importer& importer):
     // extract vertexes & indices from each mesh
     // Move/copy ctor/assignment op. implicitely declared in Mesh: https://stackoverflow.com/q/18290523
     // explicitly declaring move assignment op. deletes implicit ctors (needed by resize): https://stackoverflow.com/q/75089715
-    Mesh mesh(m_scene->mMeshes[i_mesh]);
+    Mesh mesh(m_scene->mMeshes[i_mesh], m_is_quantized);
     aiMaterial* material = m_scene->mMaterials[mesh.material];
     meshes[i_mesh] = std::move(mesh);
 
-    // assign material's diffuse color & textures to mesh (if any)
+    // assign material's diffuse color & textures filenames to mesh (if any)
     set_mesh_color(material, i_mesh);
-    load_textures(material, i_mesh);
+    set_mesh_textures(material, i_mesh);
   }
 }
 
 /**
- * Load 1st diffuse & normal texture for given mesh
+ * Set filenames of 1st diffuse & normal texture for given mesh
  * @param index Array position of mesh
  */
-void Model::load_textures(aiMaterial* material, unsigned int index) {
+void Model::set_mesh_textures(aiMaterial* material, unsigned int index) {
   // set mesh fields needed in shader (to differentiate meshes with/without textures)
   unsigned int n_textures_diffuse = material->GetTextureCount(aiTextureType_DIFFUSE);
   unsigned int n_textures_normal = material->GetTextureCount(aiTextureType_HEIGHT);
   meshes[index].has_texture_diffuse = n_textures_diffuse > 0;
   meshes[index].has_texture_normal = n_textures_normal > 0;
 
-  // assign first material's diffuse normal texture to mesh (if any)
-  if(meshes[index].has_texture_diffuse)
-    set_mesh_texture(material, index, aiTextureType_DIFFUSE);
+  // get image path to first material's diffuse & normal texture (if any)
+  aiString filename_image;
+  unsigned int index_texture = 0;
 
-  if(meshes[index].has_texture_normal)
-    set_mesh_texture(material, index, aiTextureType_HEIGHT);
+  if (meshes[index].has_texture_diffuse) {
+    material->GetTexture(aiTextureType_DIFFUSE, index_texture, &filename_image);
+    meshes[index].filename_texture_diffuse = filename_image.C_Str();
+  }
+
+  if (meshes[index].has_texture_normal) {
+    material->GetTexture(aiTextureType_HEIGHT, index_texture, &filename_image);
+    meshes[index].filename_texture_normal = filename_image.C_Str();
+  }
 }
 
 /**
@@ -71,39 +163,38 @@ void Model::set_mesh_color(aiMaterial* material, unsigned int index) {
 }
 
 /**
- * Set mesh texture from material's diffuse texture image (textures freed in `ModelRenderer`)
- *
- * @param material Material to extract texture from
+ * Load diffuse & normal textures of given mesh from their images (textures freed in `ModelRenderer`)
  * @param index Array position of mesh
- * @param type Texture type (diffuse, normal...)
  */
-void Model::set_mesh_texture(aiMaterial* material, unsigned int index, aiTextureType type) {
-  // get image path to first texture used
-  aiString filename_image;
-  unsigned int index_texture = 0;
-  material->GetTexture(type, index_texture, &filename_image);
-  std::cout << "- Texture filename: " << filename_image.C_Str() << '\n';
+void Model::load_textures(unsigned int index) {
+  Mesh& mesh = meshes[index];
+
+  if (mesh.has_texture_diffuse)
+    mesh.texture_diffuse = load_texture(mesh.filename_texture_diffuse, GL_TEXTURE0);
+
+  if (mesh.has_texture_normal)
+    mesh.texture_normal = load_texture(mesh.filename_texture_normal, GL_TEXTURE1);
+}
+
+/**
+ * Load texture from image decoded in constructor
+ * @param filename Image path relative to model's directory
+ * @param texture_unit Texture unit for diffuse (0) or normal (1) texture
+ */
+Texture2D Model::load_texture(const std::string& filename, GLenum texture_unit) {
+  std::cout << "- Texture filename: " << filename << '\n';
 
   // texture image already loaded before (meshes can share same texture)
-  std::string path_image = m_directory + "/" + filename_image.C_Str();
+  std::string path_image = m_directory + "/" + filename;
   auto it_texture = m_textures_loaded.find(path_image);
-  if (it_texture != m_textures_loaded.end()) {
-    if (type == aiTextureType_DIFFUSE)
-      meshes[index].texture_diffuse = it_texture->second;
-    else if (type == aiTextureType_HEIGHT)
-      meshes[index].texture_normal = it_texture->second;
-    return;
-  }
+  if (it_texture != m_textures_loaded.end())
+    return it_texture->second;
 
   // load texture from image
-  GLenum texture_unit = (type == aiTextureType_DIFFUSE) ? GL_TEXTURE0 : GL_TEXTURE1;
-  Texture2D texture(Image{path_image}, texture_unit);
+  Texture2D texture(m_images.at(path_image), texture_unit);
   m_textures_loaded[path_image] = texture;
 
-  if (type == aiTextureType_DIFFUSE)
-    meshes[index].texture_diffuse = texture;
-  else if (type == aiTextureType_HEIGHT)
-    meshes[index].texture_normal = texture;
+  return texture;
 }
 
 /**
@@ -122,9 +213,10 @@ bool Model::load_scene(Assimp::Importer& importer) {
   return true;
 }
 
-/* Free meshes textures (diffuse & normal) */
-void Model::free() {
-  for (auto& pair : m_textures_loaded) {
-    pair.second.free();
+/* Free meshes textures (diffuse & normal), const as only gl objects are deleted (not called on LODs sharing them) */
+void Model::free() const {
+  for (const auto& pair : m_textures_loaded) {
+    Texture2D texture = pair.second;
+    texture.free();
   }
 }
@@ -0,0 +1,49 @@
+#include <cmath>
+#include <glm/gtc/packing.hpp>
+
+#include "models/vertex_quantized.hpp"
+
+using namespace assimp_utils;
+
+/**
+ * Quantize vertex attributes (see header for format)
+ * @param position_min Lower corner of mesh's bbox
+ * @param position_extent Size of mesh's bbox (zero along flat axes)
+ */
+VertexQuantized::VertexQuantized(const glm::vec3& p, const glm::vec3& n, const glm::vec2& uv, const glm::vec3& t,
+                                 const glm::vec3& position_min, const glm::vec3& position_extent):
+  padding(0)
+{
+  for (size_t i_coord = 0; i_coord < 3; ++i_coord) {
+    float extent = position_extent[i_coord];
+    float position_normalized = (extent > 0.0f) ? (p[i_coord] - position_min[i_coord]) / extent : 0.0f;
+    position[i_coord] = glm::packUnorm1x16(position_normalized);
+  }
+
+  glm::vec2 normal_octahedral = encode_octahedral(n);
+  glm::vec2 tangent_octahedral = encode_octahedral(t);
+  for (size_t i_coord = 0; i_coord < 2; ++i_coord) {
+    normal[i_coord] = glm::packSnorm1x16(normal_octahedral[i_coord]);
+    tangent[i_coord] = glm::packSnorm1x16(tangent_octahedral[i_coord]);
+    texture_coord[i_coord] = glm::packHalf1x16(uv[i_coord]);
+  }
+}
+
+/**
+ * Project unit vector on octahedron then unfold its lower half on [-1, 1]^2
+ * Same mapping as `decode_octahedral()` in `texture_mesh.vert`
+ * https://knarkowicz.wordpress.com/2014/04/16/octahedron-normal-vector-encoding/
+ */
+glm::vec2 VertexQuantized::encode_octahedral(const glm::vec3& direction) {
+  float norm_l1 = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+  if (norm_l1 == 0.0f)
+    return glm::vec2(0.0f);
+
+  glm::vec2 encoded = glm::vec2(direction.x, direction.y) / norm_l1;
+  if (direction.z < 0.0f) {
+    glm::vec2 sign_not_zero(encoded.x >= 0.0f ? 1.0f : -1.0f, encoded.y >= 0.0f ? 1.0f : -1.0f);
+    encoded = (1.0f - glm::abs(glm::vec2(encoded.y, encoded.x))) * sign_not_zero;
+  }
+
+  return encoded;
+}
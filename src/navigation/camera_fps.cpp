@@ -22,21 +22,22 @@ void CameraFPS::zoom(Zoom z) {
   }
 }
 
+/**
+ * Bucket walls centers in a grid (called once after level is parsed)
+ * Cells as large as min distance to walls so only neighbouring cells are checked for collision
+ */
+void CameraFPS::set_boundaries(const std::vector<glm::vec3>& positions_walls) {
+  boundaries = math::SpatialGrid(positions_walls, DISTANCE_BOUNDARIES);
+}
+
 /**
  * Check if future camera position is too close from its distance to closest wall tile
  * Used to prevent camera from going through walls
  * @param position_future Next position of camera
- * Update: Turns out brute force collision detection wasn't responsible for low FPS (maybe frustum culling was)
+ * Only walls in the 3x3 grid cells around camera are checked (cost independent of level size)
  */
 bool CameraFPS::is_close_to_boundaries(const glm::vec3& position_future) {
-  // return false;
-
-  std::vector<float> distances;
-  std::transform(boundaries.begin(), boundaries.end(), std::back_inserter(distances),
-      [position_future](const glm::vec3& position_wall) { return glm::length(position_future - position_wall); });
-  float min_distance = *std::min_element(distances.begin(), distances.end());
-
-  return min_distance < 1.2f;
+  return boundaries.is_close_to(position_future, DISTANCE_BOUNDARIES);
 }
 
 void CameraFPS::move(Direction d) {
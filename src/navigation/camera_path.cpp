@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+#include "navigation/camera_path.hpp"
+
+/**
+ * One keyframe by line: `x y z dx dy dz` (empty lines & lines starting with '#' ignored)
+ * @param path Path to text file with keyframes
+ */
+CameraPath::CameraPath(const std::string& path) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    std::cout << "Failed to open camera path: " << path << '\n';
+    return;
+  }
+
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#')
+      continue;
+
+    std::istringstream stream(line);
+    glm::vec3 position, direction;
+    if (stream >> position.x >> position.y >> position.z >> direction.x >> direction.y >> direction.z) {
+      positions.push_back(position);
+      directions.push_back(glm::normalize(direction));
+    }
+  }
+}
+
+/**
+ * Place camera on path by linear interpolation between two consecutive keyframes
+ * @param t Progress along path in [0, 1] (keyframes evenly spaced)
+ */
+void CameraPath::set_camera(Camera& camera, float t) const {
+  if (positions.empty())
+    return;
+
+  if (positions.size() == 1) {
+    camera.position = positions[0];
+    camera.direction = directions[0];
+    return;
+  }
+
+  float position_keyframes = std::clamp(t, 0.0f, 1.0f) * (positions.size() - 1);
+  size_t i_keyframe = std::min(static_cast<size_t>(position_keyframes), positions.size() - 2);
+  float alpha = position_keyframes - i_keyframe;
+
+  camera.position = glm::mix(positions[i_keyframe], positions[i_keyframe + 1], alpha);
+  camera.direction = glm::normalize(glm::mix(directions[i_keyframe], directions[i_keyframe + 1], alpha));
+}
@@ -4,9 +4,19 @@
 #include "math/bounding_box.hpp"
 #include "navigation/frustum.hpp"
 #include "entries/target_entry.hpp"
+#include "profiling/profiler.hpp"
+#include "globals/draw_stats.hpp"
 
 using namespace math;
 
+namespace {
+  /* one bit per plane in `Frustum::get_planes()` order, set if bbox must still be tested against it */
+  const unsigned char MASK_PLANES = 0x3f;
+
+  /* distance planes are pushed outward by when culling with a cache (a turn of ~1 deg or a step of 1 tile reuses visible items) */
+  const float MARGIN = 1.0f;
+}
+
 /* Same parameters as projection matrix calculated with glm::perspective() */
 Frustum::Frustum(float n, float f, float aspect):
   near(n),
@@ -60,6 +70,35 @@ void Frustum::calculate_planes(const Camera& camera) {
   left_plane = Plane(normal_left, camera.position);
 }
 
+/**
+ * Sub-frustum seen through a screen rectangle (e.g. a portal), with same near & far planes
+ * Side planes extracted from rows of view-projection matrix (Gribb & Hartmann), e.g. x_ndc >= x_min <=> (row0 - x_min * row3).p >= 0
+ * @param rect Rectangle in NDC (x_min, y_min, x_max, y_max), `{ -1, -1, 1, 1 }` gives same side planes as `calculate_planes()`
+ */
+Frustum Frustum::narrow(const glm::mat4& view_projection, const glm::vec4& rect) const {
+  glm::mat4 rows = glm::transpose(view_projection);
+  auto get_plane = [](const glm::vec4& coefficients) {
+    Plane plane;
+    float length = glm::length(glm::vec3(coefficients));
+    plane.normal = glm::vec3(coefficients) / length;
+    plane.d = -coefficients.w / length;
+    return plane;
+  };
+
+  Frustum frustum = *this;
+  frustum.left_plane = get_plane(rows[0] - rect.x * rows[3]);
+  frustum.bottom_plane = get_plane(rows[1] - rect.y * rows[3]);
+  frustum.right_plane = get_plane(rect.z * rows[3] - rows[0]);
+  frustum.top_plane = get_plane(rect.w * rows[3] - rows[1]);
+
+  return frustum;
+}
+
+/* Six planes in the order they're tested by `is_inside()` */
+std::array<const Plane*, 6> Frustum::get_planes() const {
+  return { &left_plane, &right_plane, &top_plane, &bottom_plane, &near_plane, &far_plane };
+}
+
 /**
  * If element is a:
  * point: True if given point is inside frustum (i.e. in front of all frustum planes)
@@ -84,6 +123,7 @@ bool Frustum::is_inside(const T& element) const {
  */
 template <typename T>
 std::vector<T> Frustum::cull(const std::vector<T>& vec, const std::vector<BoundingBox>& bboxes) const {
+  PROFILE_ZONE("Frustum::cull");
   std::vector<T> vec_out;
 
   for (size_t i_element = 0; i_element < bboxes.size(); ++i_element) {
@@ -98,6 +138,221 @@ std::vector<T> Frustum::cull(const std::vector<T>& vec, const std::vector<Boundi
   return vec_out;
 }
 
+/**
+ * Classify bbox rel. to frustum (used to accept/reject BVH nodes with all the items below them)
+ * Outside as soon as bbox is behind one plane (same test as `is_inside()`)
+ */
+Intersection Frustum::intersect(const BoundingBox& bbox) const {
+  bool is_fully_inside = true;
+
+  for (const Plane* plane : get_planes()) {
+    if (!plane->is_in_front_of_plane(bbox))
+      return Intersection::OUTSIDE;
+
+    if (is_fully_inside && !plane->is_fully_in_front_of_plane(bbox))
+      is_fully_inside = false;
+  }
+
+  return is_fully_inside ? Intersection::INSIDE : Intersection::INTERSECTING;
+}
+
+/**
+ * Classify bbox against planes left in `mask` only (planes its parent is fully in front of are skipped),
+ * starting with `plane_first` & clearing from `mask` the planes bbox is fully in front of (skipped for its children)
+ * @param plane_first Plane which rejected bbox on last cull, replaced if another plane rejects it
+ */
+Intersection Frustum::intersect(const BoundingBox& bbox, unsigned char& mask, unsigned char& plane_first, FrustumCache::Stats& stats) const {
+  std::array<const Plane*, 6> planes = get_planes();
+
+  for (unsigned int i_test = 0; i_test < planes.size(); ++i_test) {
+    unsigned int i_plane = plane_first + i_test;
+    i_plane -= (i_plane >= planes.size()) ? planes.size() : 0;
+    if (!(mask & (1 << i_plane)))
+      continue;
+
+    stats.n_tests++;
+    if (!planes[i_plane]->is_in_front_of_plane(bbox)) {
+      stats.n_early_outs += (i_test == 0);
+      plane_first = i_plane;
+      return Intersection::OUTSIDE;
+    }
+
+    if (planes[i_plane]->is_fully_in_front_of_plane(bbox))
+      mask &= ~(1 << i_plane);
+  }
+
+  return (mask == 0) ? Intersection::INSIDE : Intersection::INTERSECTING;
+}
+
+/* Same as above for leaf items (no need to know if they're fully inside) */
+bool Frustum::is_inside(const BoundingBox& bbox, unsigned char mask, unsigned char& plane_first, FrustumCache::Stats& stats) const {
+  std::array<const Plane*, 6> planes = get_planes();
+
+  for (unsigned int i_test = 0; i_test < planes.size(); ++i_test) {
+    unsigned int i_plane = plane_first + i_test;
+    i_plane -= (i_plane >= planes.size()) ? planes.size() : 0;
+    if (!(mask & (1 << i_plane)))
+      continue;
+
+    stats.n_tests++;
+    if (!planes[i_plane]->is_in_front_of_plane(bbox)) {
+      stats.n_early_outs += (i_test == 0);
+      plane_first = i_plane;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Indices of items (in vector the BVH was built from) whose bbox is inside frustum appended to `indices`
+ * Subtrees fully inside/outside frustum are accepted/rejected without testing their leaves,
+ * & children only tested against planes their parent straddles, which gives the same items as `cull()` with a flat vector of bboxes
+ * @param planes_nodes Last rejecting plane of each node (tested first), ignored if null
+ * @param planes_items Last rejecting plane of each item in tree order, ignored if null
+ */
+void Frustum::cull(const BVH& bvh, unsigned char* planes_nodes, unsigned char* planes_items, FrustumCache::Stats& stats, std::vector<unsigned int>& indices) const {
+  if (bvh.nodes.empty())
+    return;
+
+  // depth-first traversal (stack holds at most one sibling per level) with planes left to test for each node
+  struct Entry {
+    unsigned int i_node;
+    unsigned char mask;
+  };
+  std::array<Entry, BVH::MAX_DEPTH + 1> stack;
+  size_t size_stack = 0;
+  stack[size_stack++] = { 0, MASK_PLANES };
+
+  while (size_stack > 0) {
+    Entry entry = stack[--size_stack];
+    const BVHNode& node = bvh.nodes[entry.i_node];
+    unsigned char plane_first = planes_nodes ? planes_nodes[entry.i_node] : 0;
+    Intersection intersection = intersect(node.bbox, entry.mask, plane_first, stats);
+    if (planes_nodes)
+      planes_nodes[entry.i_node] = plane_first;
+
+    if (intersection == Intersection::OUTSIDE)
+      continue;
+
+    if (intersection == Intersection::INSIDE) {
+      auto it_first = bvh.indices.begin() + node.first;
+      indices.insert(indices.end(), it_first, it_first + node.count);
+      continue;
+    }
+
+    // partially inside: test leaf items individually or go down the tree
+    if (node.is_leaf()) {
+      for (size_t i_item = node.first; i_item < node.first + node.count; ++i_item) {
+        plane_first = planes_items ? planes_items[i_item] : 0;
+        if (is_inside(bvh.bboxes[i_item], entry.mask, plane_first, stats))
+          indices.push_back(bvh.indices[i_item]);
+        if (planes_items)
+          planes_items[i_item] = plane_first;
+      }
+    } else {
+      stack[size_stack++] = { node.left + 1, entry.mask };
+      stack[size_stack++] = { node.left, entry.mask };
+    }
+  }
+}
+
+/* Same as above without coherence between calls (e.g. frustums narrowed to portals) */
+std::vector<unsigned int> Frustum::cull(const BVH& bvh) const {
+  PROFILE_ZONE("Frustum::cull");
+  std::vector<unsigned int> indices_out;
+  FrustumCache::Stats stats;
+  cull(bvh, nullptr, nullptr, stats, indices_out);
+
+  return indices_out;
+}
+
+/* 8 corners of frustum, each at the intersection of 3 planes (n1.p = d1, n2.p = d2, n3.p = d3) */
+std::array<glm::vec3, 8> Frustum::get_corners() const {
+  auto intersect_planes = [](const Plane& plane1, const Plane& plane2, const Plane& plane3) {
+    glm::vec3 cross23 = glm::cross(plane2.normal, plane3.normal);
+    glm::vec3 cross31 = glm::cross(plane3.normal, plane1.normal);
+    glm::vec3 cross12 = glm::cross(plane1.normal, plane2.normal);
+    return (plane1.d * cross23 + plane2.d * cross31 + plane3.d * cross12) / glm::dot(plane1.normal, cross23);
+  };
+
+  std::array<glm::vec3, 8> corners;
+  size_t i_corner = 0;
+  for (const Plane* plane_depth : { &near_plane, &far_plane }) {
+    for (const Plane* plane_x : { &left_plane, &right_plane }) {
+      for (const Plane* plane_y : { &bottom_plane, &top_plane })
+        corners[i_corner++] = intersect_planes(*plane_depth, *plane_x, *plane_y);
+    }
+  }
+
+  return corners;
+}
+
+/* True if frustum is inside volume bounded by given planes (i.e. all its corners are in front of them) */
+bool Frustum::is_within(const std::array<Plane, 6>& planes) const {
+  for (const glm::vec3& corner : get_corners()) {
+    for (const Plane& plane : planes) {
+      if (plane.get_signed_distance(corner) < 0.0f)
+        return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Same as above but with visibility kept between frames by caller (see `FrustumCache`)
+ * Items culled with planes pushed outward by `MARGIN`, & reused as long as the frustum stays inside these planes
+ * (camera idle, or moved/turned slowly), otherwise culled again with last rejecting planes tested first
+ * @return Visible items (with some outside frustum but within margin), stored in cache & valid until next call
+ */
+const std::vector<unsigned int>& Frustum::cull(const BVH& bvh, FrustumCache& cache) const {
+  PROFILE_ZONE("Frustum::cull");
+  cache.stats = {};
+  bool is_same_bvh = cache.planes_nodes.size() == bvh.nodes.size() && cache.planes_items.size() == bvh.bboxes.size();
+
+  if (cache.is_valid && is_same_bvh && is_within(cache.planes)) {
+    cache.stats.n_skipped = 1;
+  } else {
+    if (!is_same_bvh) {
+      cache.planes_nodes.assign(bvh.nodes.size(), 0);
+      cache.planes_items.assign(bvh.bboxes.size(), 0);
+    }
+
+    Frustum frustum = *this;
+    std::array<Plane*, 6> planes = { &frustum.left_plane, &frustum.right_plane, &frustum.top_plane, &frustum.bottom_plane, &frustum.near_plane, &frustum.far_plane };
+    for (size_t i_plane = 0; i_plane < planes.size(); ++i_plane) {
+      planes[i_plane]->d -= MARGIN;
+      cache.planes[i_plane] = *planes[i_plane];
+    }
+
+    cache.indices.clear();
+    frustum.cull(bvh, cache.planes_nodes.data(), cache.planes_items.data(), cache.stats, cache.indices);
+    cache.is_valid = true;
+  }
+
+  draw_stats.add_culling(cache.stats.n_skipped, cache.stats.n_tests, cache.stats.n_early_outs);
+  return cache.indices;
+}
+
+/* Same as `cull()` above with BVH built from bboxes (items order follows the tree not `vec`) */
+template <typename T>
+std::vector<T> Frustum::cull(const std::vector<T>& vec, const BVH& bvh) const {
+  std::vector<unsigned int> indices = cull(bvh);
+  std::vector<T> vec_out(indices.size());
+
+  for (size_t i_index = 0; i_index < indices.size(); ++i_index)
+    vec_out[i_index] = vec[indices[i_index]];
+
+  return vec_out;
+}
+
 // template instantiation (avoids linking error)
 template std::vector<glm::mat4> Frustum::cull(const std::vector<glm::mat4>&, const std::vector<BoundingBox>&) const;
 template std::vector<TargetEntry> Frustum::cull(const std::vector<TargetEntry>&, const std::vector<BoundingBox>&) const;
+template std::vector<glm::mat4> Frustum::cull(const std::vector<glm::mat4>&, const BVH&) const;
+template std::vector<TargetEntry> Frustum::cull(const std::vector<TargetEntry>&, const BVH&) const;
+template std::vector<unsigned int> Frustum::cull(const std::vector<unsigned int>&, const BVH&) const;
+template bool Frustum::is_inside(const BoundingBox&) const;
+template bool Frustum::is_inside(const glm::vec3&) const;
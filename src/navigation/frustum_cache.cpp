@@ -0,0 +1,9 @@
+#include "navigation/frustum_cache.hpp"
+
+/* Called when BVH is rebuilt (e.g. chunks streamed in/out) as cached indices & planes refer to its nodes */
+void FrustumCache::invalidate() {
+  is_valid = false;
+  indices.clear();
+  planes_nodes.clear();
+  planes_items.clear();
+}
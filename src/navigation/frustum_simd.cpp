@@ -0,0 +1,169 @@
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FRUSTUM_SIMD_X86
+#endif
+
+#include "navigation/frustum.hpp"
+#include "profiling/profiler.hpp"
+
+using namespace math;
+
+/**
+ * SIMD frustum culling of bboxes stored as SoA (tests 8 or 4 bboxes against a plane at once)
+ * Same test as `Plane::is_in_front_of_plane(bbox)`, with sums in the same order as `glm::dot()`
+ * and without fma, so the visible set is exactly the one given by the scalar `is_inside()`
+ * Kernels compiled with function-level target attribute (no need for -mavx2 flag)
+ */
+
+/* Cpu support checked once at runtime */
+bool Frustum::has_avx2() {
+#ifdef FRUSTUM_SIMD_X86
+  static const bool is_supported = __builtin_cpu_supports("avx2");
+  return is_supported;
+#else
+  return false;
+#endif
+}
+
+/* Fill `indices` with indices of bboxes inside frustum (vector reused between frames to avoid allocations) */
+void Frustum::cull(const BoundingBoxesSoA& bboxes, std::vector<unsigned int>& indices) const {
+  PROFILE_ZONE("Frustum::cull");
+
+  if (has_avx2())
+    cull_avx2(bboxes, indices);
+  else
+    cull_sse2(bboxes, indices);
+}
+
+/* Fallback on other architectures (same arithmetic as kernels below) */
+void Frustum::cull_scalar(const BoundingBoxesSoA& bboxes, std::vector<unsigned int>& indices) const {
+  indices.clear();
+  std::array<const Plane*, 6> planes = get_planes();
+
+  for (size_t i_bbox = 0; i_bbox < bboxes.size; ++i_bbox) {
+    bool is_inside = true;
+
+    for (const Plane* plane : planes) {
+      glm::vec3 normal_abs = glm::abs(plane->normal);
+      float distance = plane->normal.x * bboxes.centers_x[i_bbox] + plane->normal.y * bboxes.centers_y[i_bbox] + plane->normal.z * bboxes.centers_z[i_bbox] - plane->d;
+      float radius = bboxes.half_diagonals_x[i_bbox] * normal_abs.x + bboxes.half_diagonals_y[i_bbox] * normal_abs.y + bboxes.half_diagonals_z[i_bbox] * normal_abs.z;
+
+      if (!(distance > -radius)) {
+        is_inside = false;
+        break;
+      }
+    }
+
+    if (is_inside)
+      indices.push_back(i_bbox);
+  }
+}
+
+#ifdef FRUSTUM_SIMD_X86
+/* 4 bboxes per iteration (SSE2 always available on x86-64) */
+void Frustum::cull_sse2(const BoundingBoxesSoA& bboxes, std::vector<unsigned int>& indices) const {
+  indices.clear();
+  std::array<const Plane*, 6> planes = get_planes();
+  const unsigned int N_LANES = 4;
+
+  // broadcast planes coeffs once (abs. of normal for bbox radius)
+  __m128 normals_x[6], normals_y[6], normals_z[6], normals_abs_x[6], normals_abs_y[6], normals_abs_z[6], ds[6];
+  for (size_t i_plane = 0; i_plane < planes.size(); ++i_plane) {
+    const Plane* plane = planes[i_plane];
+    glm::vec3 normal_abs = glm::abs(plane->normal);
+    normals_x[i_plane] = _mm_set1_ps(plane->normal.x);
+    normals_y[i_plane] = _mm_set1_ps(plane->normal.y);
+    normals_z[i_plane] = _mm_set1_ps(plane->normal.z);
+    normals_abs_x[i_plane] = _mm_set1_ps(normal_abs.x);
+    normals_abs_y[i_plane] = _mm_set1_ps(normal_abs.y);
+    normals_abs_z[i_plane] = _mm_set1_ps(normal_abs.z);
+    ds[i_plane] = _mm_set1_ps(plane->d);
+  }
+  const __m128 sign_mask = _mm_set1_ps(-0.0f);
+
+  for (size_t i_bbox = 0; i_bbox < bboxes.size; i_bbox += N_LANES) {
+    __m128 centers_x = _mm_loadu_ps(&bboxes.centers_x[i_bbox]);
+    __m128 centers_y = _mm_loadu_ps(&bboxes.centers_y[i_bbox]);
+    __m128 centers_z = _mm_loadu_ps(&bboxes.centers_z[i_bbox]);
+    __m128 half_diagonals_x = _mm_loadu_ps(&bboxes.half_diagonals_x[i_bbox]);
+    __m128 half_diagonals_y = _mm_loadu_ps(&bboxes.half_diagonals_y[i_bbox]);
+    __m128 half_diagonals_z = _mm_loadu_ps(&bboxes.half_diagonals_z[i_bbox]);
+    int mask = (1 << N_LANES) - 1;
+
+    for (size_t i_plane = 0; i_plane < planes.size() && mask != 0; ++i_plane) {
+      __m128 distances = _mm_sub_ps(
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(normals_x[i_plane], centers_x), _mm_mul_ps(normals_y[i_plane], centers_y)), _mm_mul_ps(normals_z[i_plane], centers_z)),
+        ds[i_plane]
+      );
+      __m128 radiuses = _mm_add_ps(_mm_add_ps(_mm_mul_ps(half_diagonals_x, normals_abs_x[i_plane]), _mm_mul_ps(half_diagonals_y, normals_abs_y[i_plane])), _mm_mul_ps(half_diagonals_z, normals_abs_z[i_plane]));
+      mask &= _mm_movemask_ps(_mm_cmpgt_ps(distances, _mm_xor_ps(radiuses, sign_mask)));
+    }
+
+    // ignore padding bboxes in last block
+    if (bboxes.size - i_bbox < N_LANES)
+      mask &= (1 << (bboxes.size - i_bbox)) - 1;
+
+    while (mask != 0) {
+      indices.push_back(i_bbox + __builtin_ctz(mask));
+      mask &= mask - 1;
+    }
+  }
+}
+
+/* 8 bboxes per iteration */
+__attribute__((target("avx2")))
+void Frustum::cull_avx2(const BoundingBoxesSoA& bboxes, std::vector<unsigned int>& indices) const {
+  indices.clear();
+  std::array<const Plane*, 6> planes = get_planes();
+  const unsigned int N_LANES = 8;
+
+  __m256 normals_x[6], normals_y[6], normals_z[6], normals_abs_x[6], normals_abs_y[6], normals_abs_z[6], ds[6];
+  for (size_t i_plane = 0; i_plane < planes.size(); ++i_plane) {
+    const Plane* plane = planes[i_plane];
+    glm::vec3 normal_abs = glm::abs(plane->normal);
+    normals_x[i_plane] = _mm256_set1_ps(plane->normal.x);
+    normals_y[i_plane] = _mm256_set1_ps(plane->normal.y);
+    normals_z[i_plane] = _mm256_set1_ps(plane->normal.z);
+    normals_abs_x[i_plane] = _mm256_set1_ps(normal_abs.x);
+    normals_abs_y[i_plane] = _mm256_set1_ps(normal_abs.y);
+    normals_abs_z[i_plane] = _mm256_set1_ps(normal_abs.z);
+    ds[i_plane] = _mm256_set1_ps(plane->d);
+  }
+  const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+
+  for (size_t i_bbox = 0; i_bbox < bboxes.size; i_bbox += N_LANES) {
+    __m256 centers_x = _mm256_loadu_ps(&bboxes.centers_x[i_bbox]);
+    __m256 centers_y = _mm256_loadu_ps(&bboxes.centers_y[i_bbox]);
+    __m256 centers_z = _mm256_loadu_ps(&bboxes.centers_z[i_bbox]);
+    __m256 half_diagonals_x = _mm256_loadu_ps(&bboxes.half_diagonals_x[i_bbox]);
+    __m256 half_diagonals_y = _mm256_loadu_ps(&bboxes.half_diagonals_y[i_bbox]);
+    __m256 half_diagonals_z = _mm256_loadu_ps(&bboxes.half_diagonals_z[i_bbox]);
+    int mask = (1 << N_LANES) - 1;
+
+    for (size_t i_plane = 0; i_plane < planes.size() && mask != 0; ++i_plane) {
+      __m256 distances = _mm256_sub_ps(
+        _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(normals_x[i_plane], centers_x), _mm256_mul_ps(normals_y[i_plane], centers_y)), _mm256_mul_ps(normals_z[i_plane], centers_z)),
+        ds[i_plane]
+      );
+      __m256 radiuses = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(half_diagonals_x, normals_abs_x[i_plane]), _mm256_mul_ps(half_diagonals_y, normals_abs_y[i_plane])), _mm256_mul_ps(half_diagonals_z, normals_abs_z[i_plane]));
+      mask &= _mm256_movemask_ps(_mm256_cmp_ps(distances, _mm256_xor_ps(radiuses, sign_mask), _CMP_GT_OQ));
+    }
+
+    if (bboxes.size - i_bbox < N_LANES)
+      mask &= (1 << (bboxes.size - i_bbox)) - 1;
+
+    while (mask != 0) {
+      indices.push_back(i_bbox + __builtin_ctz(mask));
+      mask &= mask - 1;
+    }
+  }
+}
+#else
+void Frustum::cull_sse2(const BoundingBoxesSoA& bboxes, std::vector<unsigned int>& indices) const {
+  cull_scalar(bboxes, indices);
+}
+
+void Frustum::cull_avx2(const BoundingBoxesSoA& bboxes, std::vector<unsigned int>& indices) const {
+  cull_scalar(bboxes, indices);
+}
+#endif
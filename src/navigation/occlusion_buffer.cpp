@@ -0,0 +1,283 @@
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#define OCCLUSION_SIMD_X86
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <fstream>
+
+#include "navigation/occlusion_buffer.hpp"
+#include "profiling/profiler.hpp"
+
+namespace {
+  // min. view distance of occluders vertexes (polygons clipped against this plane) & of tested bboxes corners
+  const float W_NEAR = 0.1f;
+
+  // occluders shrunk by this fraction of a pixel on top of the conservative half pixel (absorbs rounding errors)
+  const float MARGIN = 1.0f / 16;
+
+  // max. # of vertexes of a box face clipped against near plane
+  const unsigned int N_VERTEXES_MAX = 8;
+}
+
+OcclusionBuffer::OcclusionBuffer():
+  m_depths(WIDTH * HEIGHT, FLT_MAX),
+  m_view_projection(1.0f),
+  m_position_camera(0.0f),
+  m_n_occluders(0),
+  m_n_tests(0),
+  m_n_occluded(0)
+{
+}
+
+/* Empty buffer (nothing occluded until occluders are rasterized), called each frame */
+void OcclusionBuffer::clear(const glm::mat4& view, const glm::mat4& projection) {
+  PROFILE_ZONE("OcclusionBuffer::clear");
+  std::fill(m_depths.begin(), m_depths.end(), FLT_MAX);
+  m_view_projection = projection * view;
+  m_position_camera = glm::inverse(view)[3];
+  m_n_occluders = 0;
+  m_n_tests = 0;
+  m_n_occluded = 0;
+}
+
+/* Pixel coords (origin at bottom-left corner of buffer) & inverse of view distance of clip-space point */
+glm::vec3 OcclusionBuffer::project(const glm::vec4& clip) const {
+  float w_inverse = 1.0f / clip.w;
+  return glm::vec3((clip.x * w_inverse + 1.0f) * 0.5f * WIDTH, (clip.y * w_inverse + 1.0f) * 0.5f * HEIGHT, w_inverse);
+}
+
+/**
+ * Rasterize faces of box facing camera (only three at most, back faces are always farther)
+ * @param bbox Occluder in world space (e.g. merged walls)
+ */
+void OcclusionBuffer::rasterize(const BoundingBox& bbox) {
+  m_n_occluders++;
+
+  // corners in clip space (bit i of corner index selects max. along axis i)
+  std::array<glm::vec4, 8> corners;
+  for (size_t i_corner = 0; i_corner < 8; ++i_corner) {
+    glm::vec3 corner((i_corner & 1) ? bbox.max.x : bbox.min.x, (i_corner & 2) ? bbox.max.y : bbox.min.y, (i_corner & 4) ? bbox.max.z : bbox.min.z);
+    corners[i_corner] = m_view_projection * glm::vec4(corner, 1.0f);
+  }
+
+  // face facing camera if camera is beyond its plane
+  const unsigned int FACES[6][4] = {
+    { 0, 2, 6, 4 }, { 1, 3, 7, 5 }, // -x, +x
+    { 0, 1, 5, 4 }, { 2, 3, 7, 6 }, // -y, +y
+    { 0, 1, 3, 2 }, { 4, 5, 7, 6 }, // -z, +z
+  };
+
+  for (unsigned int axis = 0; axis < 3; ++axis) {
+    unsigned int i_face;
+    if (m_position_camera[axis] < bbox.min[axis])
+      i_face = 2 * axis;
+    else if (m_position_camera[axis] > bbox.max[axis])
+      i_face = 2 * axis + 1;
+    else
+      continue;
+
+    glm::vec4 face[4] = { corners[FACES[i_face][0]], corners[FACES[i_face][1]], corners[FACES[i_face][2]], corners[FACES[i_face][3]] };
+    rasterize_polygon(face, 4);
+  }
+}
+
+/**
+ * Clip convex polygon against near plane (w >= `W_NEAR`) & write its farthest depth to pixels it fully covers
+ * Depth interpolated as inverse of view distance (linear in screen space), its min. over pixel found at one of its corners
+ * @param vertexes In clip space
+ */
+void OcclusionBuffer::rasterize_polygon(const glm::vec4* vertexes, unsigned int n_vertexes) {
+  // Sutherland-Hodgman clipping against near plane
+  glm::vec3 points[N_VERTEXES_MAX];
+  unsigned int n_points = 0;
+
+  for (size_t i_vertex = 0; i_vertex < n_vertexes; ++i_vertex) {
+    const glm::vec4& vertex = vertexes[i_vertex], & vertex_next = vertexes[(i_vertex + 1) % n_vertexes];
+    bool is_inside = vertex.w >= W_NEAR, is_inside_next = vertex_next.w >= W_NEAR;
+
+    if (is_inside)
+      points[n_points++] = project(vertex);
+    if (is_inside != is_inside_next) {
+      float t = (W_NEAR - vertex.w) / (vertex_next.w - vertex.w);
+      points[n_points++] = project(vertex + t * (vertex_next - vertex));
+    }
+  }
+
+  if (n_points < 3)
+    return;
+
+  // counter-clockwise order on screen (faces seen from either side)
+  float area = 0.0f;
+  for (size_t i_point = 0; i_point < n_points; ++i_point) {
+    const glm::vec3& point = points[i_point], & point_next = points[(i_point + 1) % n_points];
+    area += point.x * point_next.y - point_next.x * point.y;
+  }
+  if (std::abs(area) < 1e-6f)
+    return;
+  if (area < 0.0f)
+    std::reverse(points, points + n_points);
+
+  // edges functions (>= 0 inside), shifted so they're >= 0 only if whole pixel is inside (tested at pixels centers)
+  float as[N_VERTEXES_MAX], bs[N_VERTEXES_MAX], cs[N_VERTEXES_MAX];
+  glm::vec2 point_min(FLT_MAX), point_max(-FLT_MAX);
+
+  for (size_t i_point = 0; i_point < n_points; ++i_point) {
+    const glm::vec3& point = points[i_point], & point_next = points[(i_point + 1) % n_points];
+    as[i_point] = point.y - point_next.y;
+    bs[i_point] = point_next.x - point.x;
+    cs[i_point] = -(as[i_point] * point.x + bs[i_point] * point.y) - (0.5f + MARGIN) * (std::abs(as[i_point]) + std::abs(bs[i_point]));
+    point_min = glm::vec2(std::min(point_min.x, point.x), std::min(point_min.y, point.y));
+    point_max = glm::vec2(std::max(point_max.x, point.x), std::max(point_max.y, point.y));
+  }
+
+  // plane of inverse depth through three first points (Cramer's rule), shifted to its min. over each pixel
+  const glm::vec3 &p0 = points[0], &p1 = points[1], &p2 = points[2];
+  float determinant = (p1.x - p0.x) * (p2.y - p0.y) - (p2.x - p0.x) * (p1.y - p0.y);
+  if (std::abs(determinant) < 1e-6f)
+    return;
+
+  float a_depth = ((p1.z - p0.z) * (p2.y - p0.y) - (p2.z - p0.z) * (p1.y - p0.y)) / determinant;
+  float b_depth = ((p2.z - p0.z) * (p1.x - p0.x) - (p1.z - p0.z) * (p2.x - p0.x)) / determinant;
+  float c_depth = p0.z - a_depth * p0.x - b_depth * p0.y - 0.5f * (std::abs(a_depth) + std::abs(b_depth));
+
+  // pixels fully inside polygon's bounding rectangle (x range aligned on groups of 4 pixels)
+  int x_min = std::max((int) std::ceil(point_min.x), 0) & ~3, x_max = std::min((int) std::floor(point_max.x), (int) WIDTH);
+  int y_min = std::max((int) std::ceil(point_min.y), 0), y_max = std::min((int) std::floor(point_max.y), (int) HEIGHT);
+
+  for (int y = y_min; y < y_max; ++y) {
+    float* depths_row = &m_depths[y * WIDTH];
+    float y_center = y + 0.5f;
+
+#ifdef OCCLUSION_SIMD_X86
+    const __m128 offsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+
+    for (int x = x_min; x < x_max; x += 4) {
+      __m128 xs_center = _mm_add_ps(_mm_set1_ps((float) x), offsets);
+      __m128 is_covered = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+      for (size_t i_point = 0; i_point < n_points; ++i_point) {
+        __m128 edges = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(as[i_point]), xs_center), _mm_set1_ps(bs[i_point] * y_center + cs[i_point]));
+        is_covered = _mm_and_ps(is_covered, _mm_cmpge_ps(edges, zero));
+      }
+
+      if (_mm_movemask_ps(is_covered) == 0)
+        continue;
+
+      __m128 depths_inverse = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a_depth), xs_center), _mm_set1_ps(b_depth * y_center + c_depth));
+      __m128 depths_polygon = _mm_div_ps(one, depths_inverse);
+      __m128 depths = _mm_loadu_ps(depths_row + x);
+      __m128 depths_min = _mm_min_ps(depths, depths_polygon);
+      _mm_storeu_ps(depths_row + x, _mm_or_ps(_mm_and_ps(is_covered, depths_min), _mm_andnot_ps(is_covered, depths)));
+    }
+#else
+    for (int x = x_min; x < x_max; ++x) {
+      float x_center = x + 0.5f;
+      bool is_covered = true;
+      for (size_t i_point = 0; i_point < n_points && is_covered; ++i_point)
+        is_covered = as[i_point] * x_center + (bs[i_point] * y_center + cs[i_point]) >= 0.0f;
+
+      if (is_covered)
+        depths_row[x] = std::min(depths_row[x], 1.0f / (a_depth * x_center + (b_depth * y_center + c_depth)));
+    }
+#endif
+  }
+}
+
+/**
+ * Whether any pixel under bbox's screen rectangle has an occluder farther than bbox's nearest corner
+ * Bboxes crossing near plane are visible (nothing can be in front of them)
+ */
+bool OcclusionBuffer::is_visible(const BoundingBox& bbox) {
+  if (m_n_occluders == 0)
+    return true;
+
+  m_n_tests.fetch_add(1, std::memory_order_relaxed);
+  glm::vec2 point_min(FLT_MAX), point_max(-FLT_MAX);
+  float w_min = FLT_MAX;
+
+  for (size_t i_corner = 0; i_corner < 8; ++i_corner) {
+    glm::vec3 corner((i_corner & 1) ? bbox.max.x : bbox.min.x, (i_corner & 2) ? bbox.max.y : bbox.min.y, (i_corner & 4) ? bbox.max.z : bbox.min.z);
+    glm::vec4 clip = m_view_projection * glm::vec4(corner, 1.0f);
+    if (clip.w < W_NEAR)
+      return true;
+
+    glm::vec3 point = project(clip);
+    point_min = glm::vec2(std::min(point_min.x, point.x), std::min(point_min.y, point.y));
+    point_max = glm::vec2(std::max(point_max.x, point.x), std::max(point_max.y, point.y));
+    w_min = std::min(w_min, clip.w);
+  }
+
+  // pixels overlapped by screen rectangle (outside of screen: left to frustum culling)
+  int x_min = std::max((int) std::floor(point_min.x), 0), x_max = std::min((int) std::floor(point_max.x) + 1, (int) WIDTH);
+  int y_min = std::max((int) std::floor(point_min.y), 0), y_max = std::min((int) std::floor(point_max.y) + 1, (int) HEIGHT);
+  if (x_min >= x_max || y_min >= y_max)
+    return true;
+
+  for (int y = y_min; y < y_max; ++y) {
+    const float* depths_row = &m_depths[y * WIDTH];
+    int x = x_min;
+
+#ifdef OCCLUSION_SIMD_X86
+    __m128 ws_min = _mm_set1_ps(w_min);
+    for (; x + 4 <= x_max; x += 4) {
+      if (_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(depths_row + x), ws_min)) != 0)
+        return true;
+    }
+#endif
+
+    for (; x < x_max; ++x) {
+      if (depths_row[x] >= w_min)
+        return true;
+    }
+  }
+
+  m_n_occluded.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+/**
+ * Filter out occluded instances (e.g. occluders hidden behind other ones)
+ * @param indices Instances to filter (in-place)
+ * @param bboxes Bboxes of all instances
+ */
+void OcclusionBuffer::cull(std::vector<unsigned int>& indices, const std::vector<BoundingBox>& bboxes) {
+  indices.erase(std::remove_if(indices.begin(), indices.end(), [&](unsigned int index) {
+    return !is_visible(bboxes[index]);
+  }), indices.end());
+}
+
+OcclusionBuffer::Stats OcclusionBuffer::get_stats() const {
+  return { m_n_occluders, m_n_tests.load(), m_n_occluded.load() };
+}
+
+/**
+ * Debug dump of depth buffer as a grayscale image (nearer is brighter, no occluder is black)
+ * @param path Binary PGM image (e.g. `occlusion.pgm`)
+ */
+bool OcclusionBuffer::save(const std::string& path) const {
+  std::ofstream file(path, std::ios::binary);
+  if (!file)
+    return false;
+
+  float depth_max = 0.0f;
+  for (float depth : m_depths) {
+    if (depth != FLT_MAX)
+      depth_max = std::max(depth_max, depth);
+  }
+
+  file << "P5\n" << WIDTH << ' ' << HEIGHT << "\n255\n";
+  for (int y = HEIGHT - 1; y >= 0; --y) {
+    for (size_t x = 0; x < WIDTH; ++x) {
+      float depth = m_depths[y * WIDTH + x];
+      unsigned char value = (depth == FLT_MAX) ? 0 : 255 - (unsigned char) (200.0f * depth / std::max(depth_max, 1e-6f));
+      file.put(value);
+    }
+  }
+
+  return (bool) file;
+}
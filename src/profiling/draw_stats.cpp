@@ -0,0 +1,41 @@
+#include "profiling/draw_stats.hpp"
+
+/* Called by renderers for each draw call */
+void DrawStats::add(unsigned int n_instances_draw) {
+  n_draw_calls++;
+  n_instances += n_instances_draw;
+}
+
+/* Called by level renderer after culling its instances */
+void DrawStats::add_occlusion(unsigned int n_tests, unsigned int n_occluded_tests) {
+  n_occlusion_tests += n_tests;
+  n_occluded += n_occluded_tests;
+}
+
+/* Called by frustum after each coherent culling (see `FrustumCache`) */
+void DrawStats::add_culling(unsigned int n_skipped, unsigned int n_tests, unsigned int n_early_outs_tests) {
+  n_culls_skipped += n_skipped;
+  n_plane_tests += n_tests;
+  n_early_outs += n_early_outs_tests;
+}
+
+/* Called by render queue once its packets are drawn */
+void DrawStats::add_state_changes(unsigned int n_programs, unsigned int n_textures, unsigned int n_vaos) {
+  n_changes_programs += n_programs;
+  n_changes_textures += n_textures;
+  n_changes_vaos += n_vaos;
+}
+
+/* Called at beginning of each frame */
+void DrawStats::reset() {
+  n_draw_calls = 0;
+  n_instances = 0;
+  n_occlusion_tests = 0;
+  n_occluded = 0;
+  n_changes_programs = 0;
+  n_changes_textures = 0;
+  n_changes_vaos = 0;
+  n_culls_skipped = 0;
+  n_plane_tests = 0;
+  n_early_outs = 0;
+}
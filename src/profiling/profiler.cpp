@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include "profiling/profiler.hpp"
+
+using namespace std::chrono;
+
+std::vector<std::unique_ptr<ProfilerThread>> Profiler::m_threads;
+std::mutex Profiler::m_mutex;
+
+namespace {
+  /* timestamps relative to program start (smaller numbers in trace) */
+  const steady_clock::time_point EPOCH = steady_clock::now();
+}
+
+ProfilerThread::ProfilerThread(unsigned int id_thread):
+  id(id_thread),
+  events(new std::array<ProfilerSlot, CAPACITY>),
+  n_events(0)
+{
+}
+
+/* Only called by owning thread */
+void ProfilerThread::push(const ProfilerEvent& event) {
+  uint64_t n = n_events.load(std::memory_order_relaxed);
+  ProfilerSlot& slot = (*events)[n % CAPACITY];
+  slot.name.store(event.name, std::memory_order_release);
+  slot.start.store(event.start, std::memory_order_release);
+  slot.end.store(event.end, std::memory_order_release);
+  n_events.store(n + 1, std::memory_order_release);
+}
+
+/**
+ * Copy of last `CAPACITY` events (older ones overwritten) made without blocking owning thread
+ * Events the owner may have overwritten during the copy are dropped (index re-read after copy)
+ */
+std::vector<ProfilerEvent> ProfilerThread::get_events() {
+  uint64_t n_before = n_events.load(std::memory_order_acquire);
+  uint64_t first = (n_before > CAPACITY) ? n_before - CAPACITY : 0;
+  std::vector<ProfilerEvent> events_copied;
+  events_copied.reserve(n_before - first);
+
+  for (uint64_t i_event = first; i_event < n_before; ++i_event) {
+    const ProfilerSlot& slot = (*events)[i_event % CAPACITY];
+    events_copied.push_back({
+      slot.name.load(std::memory_order_acquire),
+      slot.start.load(std::memory_order_acquire),
+      slot.end.load(std::memory_order_acquire),
+    });
+  }
+
+  // slot read after being overwritten => index published by owner before overwriting it visible here
+  uint64_t n_after = n_events.load(std::memory_order_relaxed);
+
+  // owner may be writing event `n_after`, overwriting event `n_after - CAPACITY`
+  uint64_t first_valid = (n_after + 1 > CAPACITY) ? n_after + 1 - CAPACITY : 0;
+  if (first_valid > first)
+    events_copied.erase(events_copied.begin(), events_copied.begin() + std::min(first_valid, n_before) - first);
+
+  return events_copied;
+}
+
+uint64_t Profiler::now() {
+  return duration_cast<nanoseconds>(steady_clock::now() - EPOCH).count();
+}
+
+/* Buffer of calling thread (registered on its 1st zone, thread ids in order of registration) */
+ProfilerThread& Profiler::get_thread() {
+  thread_local ProfilerThread* thread = nullptr;
+
+  if (thread == nullptr) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_threads.push_back(std::make_unique<ProfilerThread>(m_threads.size()));
+    thread = m_threads.back().get();
+  }
+
+  return *thread;
+}
+
+/**
+ * Write events of all threads as complete events ("ph": "X"), nesting deduced from timestamps by viewer
+ * Can be called while other threads are recording (each thread's events up to now)
+ * @param path Path to json file (open it in chrome://tracing or https://ui.perfetto.dev)
+ */
+bool Profiler::export_chrome_trace(const std::string& path) {
+  std::ofstream file(path);
+  if (!file.is_open()) {
+    std::cout << "Failed to open trace file: " << path << '\n';
+    return false;
+  }
+
+  // timestamps in us (with ns precision)
+  std::lock_guard<std::mutex> lock(m_mutex);
+  file << std::fixed << std::setprecision(3);
+  file << "{\"traceEvents\":[";
+  bool is_first = true;
+
+  for (const std::unique_ptr<ProfilerThread>& thread : m_threads) {
+    // copied without blocking thread (which keeps recording)
+    for (const ProfilerEvent& event : thread->get_events()) {
+      file << (is_first ? "" : ",") << '\n'
+           << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread->id
+           << ",\"ts\":" << event.start / 1e3 << ",\"dur\":" << (event.end - event.start) / 1e3 << "}";
+      is_first = false;
+    }
+  }
+
+  file << "\n]}" << '\n';
+  std::cout << "Profiler trace exported to " << path << '\n';
+  return true;
+}
+
+ProfilerZone::ProfilerZone(const char* name):
+  m_thread(Profiler::get_thread()),
+  m_name(name),
+  m_start(Profiler::now())
+{
+}
+
+ProfilerZone::~ProfilerZone() {
+  m_thread.push({ m_name, m_start, Profiler::now() });
+}
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <cstddef>
+
+#include "render/instance_buffer.hpp"
+
+namespace {
+  /* Element as laid out in buffer with std430 layout (vec3 arrays have a stride of 16 bytes => padded to vec4) */
+  const glm::mat4& to_std430(const glm::mat4& m) { return m; }
+  glm::vec4 to_std430(const glm::vec3& v) { return glm::vec4(v, 0.0f); }
+  unsigned int to_std430(unsigned int u) { return u; }
+}
+
+/* Data store allocated on first upload */
+InstanceBuffer::InstanceBuffer(GLuint binding):
+  m_binding(binding),
+  m_capacity(0),
+  m_size(0)
+{
+  glGenBuffers(1, &m_id);
+}
+
+/**
+ * Upload whole array at once (one contiguous buffer per draw instead of a uniform per instance)
+ * Store is orphaned before writing so driver doesn't wait for previous draw still reading from it
+ */
+void InstanceBuffer::upload(const void* data, size_t size) {
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_id);
+  m_capacity = std::max(size, m_capacity);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, m_capacity, NULL, GL_DYNAMIC_DRAW);
+
+  if (size > 0)
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, data);
+
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+  m_size = size;
+}
+
+void InstanceBuffer::upload(const std::vector<glm::mat4>& data) {
+  upload(data.data(), data.size() * sizeof(glm::mat4));
+}
+
+/* vec3 arrays have a stride of 16 bytes with std430 layout => padded to vec4 while written into mapped store (no temporary array) */
+void InstanceBuffer::upload(const std::vector<glm::vec3>& data) {
+  gather<glm::vec3, glm::vec4>(data, NULL);
+}
+
+void InstanceBuffer::upload(const std::vector<unsigned int>& data) {
+  upload(data.data(), data.size() * sizeof(unsigned int));
+}
+
+/**
+ * Write elements of `data` at given indices (e.g. visible instances) straight into mapped store,
+ * instead of gathering them into a temporary array first
+ * Store orphaned as above (invalidated on mapping) & elements converted to their layout in buffer (see `to_std430()`)
+ * @param indices Elements to write (all of them if NULL)
+ */
+template <typename TData, typename TBuffer>
+void InstanceBuffer::gather(const std::vector<TData>& data, const std::vector<unsigned int>* indices) {
+  size_t n_elements = (indices != NULL) ? indices->size() : data.size();
+  size_t size = n_elements * sizeof(TBuffer);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_id);
+  m_capacity = std::max(size, m_capacity);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, m_capacity, NULL, GL_DYNAMIC_DRAW);
+
+  // mapping an empty range is an error
+  TBuffer* data_buffer = (size > 0) ? static_cast<TBuffer*>(glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT)) : NULL;
+  if (data_buffer != NULL) {
+    for (size_t i_element = 0; i_element < n_elements; ++i_element)
+      data_buffer[i_element] = to_std430(data[(indices != NULL) ? (*indices)[i_element] : i_element]);
+    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+  }
+
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+  m_size = (data_buffer != NULL) ? size : 0;
+}
+
+void InstanceBuffer::upload(const std::vector<glm::mat4>& data, const std::vector<unsigned int>& indices) {
+  gather<glm::mat4, glm::mat4>(data, &indices);
+}
+
+void InstanceBuffer::upload(const std::vector<glm::vec3>& data, const std::vector<unsigned int>& indices) {
+  gather<glm::vec3, glm::vec4>(data, &indices);
+}
+
+void InstanceBuffer::upload(const std::vector<unsigned int>& data, const std::vector<unsigned int>& indices) {
+  gather<unsigned int, unsigned int>(data, &indices);
+}
+
+/* Called before each draw as binding points are shared by all programs */
+void InstanceBuffer::bind() const {
+  if (m_size > 0)
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, m_binding, m_id);
+}
+
+void InstanceBuffer::free() {
+  glDeleteBuffers(1, &m_id);
+}
+
+InstanceBuffers::InstanceBuffers():
+  m_buffers {
+    { "models", InstanceBuffer(0) },
+    { "normals_mats", InstanceBuffer(1) },
+    { "colors", InstanceBuffer(2) },
+    { "textures_indices", InstanceBuffer(3) },
+  }
+{
+}
+
+/* Throws if `name` isn't one of the buffers above (i.e. typo in name) */
+template <typename T>
+void InstanceBuffers::upload(const std::string& name, const std::vector<T>& data) {
+  m_buffers.at(name).upload(data);
+}
+
+/* Only elements at `indices` uploaded (see `InstanceBuffer::gather()`) */
+template <typename T>
+void InstanceBuffers::upload(const std::string& name, const std::vector<T>& data, const std::vector<unsigned int>& indices) {
+  m_buffers.at(name).upload(data, indices);
+}
+
+void InstanceBuffers::bind() const {
+  for (const auto& pair : m_buffers)
+    pair.second.bind();
+}
+
+void InstanceBuffers::free() {
+  for (auto& pair : m_buffers)
+    pair.second.free();
+}
+
+// explicit template instantiation to avoid linking error
+template void InstanceBuffers::upload(const std::string& name, const std::vector<glm::mat4>& data);
+template void InstanceBuffers::upload(const std::string& name, const std::vector<glm::vec3>& data);
+template void InstanceBuffers::upload(const std::string& name, const std::vector<unsigned int>& data);
+template void InstanceBuffers::upload(const std::string& name, const std::vector<glm::mat4>& data, const std::vector<unsigned int>& indices);
+template void InstanceBuffers::upload(const std::string& name, const std::vector<glm::vec3>& data, const std::vector<unsigned int>& indices);
+template void InstanceBuffers::upload(const std::string& name, const std::vector<unsigned int>& data, const std::vector<unsigned int>& indices);
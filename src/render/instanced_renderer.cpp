@@ -0,0 +1,33 @@
+#include "render/instanced_renderer.hpp"
+
+InstancedRenderer::InstancedRenderer(const Program& program, const Geometry& geometry, const std::vector<Attribute>& attributes, bool is_text):
+  StorageRenderer(program, geometry, attributes, is_text),
+  m_id_program(program.id)
+{
+}
+
+/* Models matrices uploaded as one buffer (no uniform per instance) */
+void InstancedRenderer::set_transform(const Transformation& t) {
+  m_buffers.upload("models", t.models);
+  StorageRenderer::set_transform(t.view, t.projection, t.models.size());
+}
+
+/**
+ * Models of instances at `indices` (e.g. visible ones) gathered straight into instances buffer (no copy on cpu)
+ * Only view/projection of transformation used (its models are ignored)
+ * @param models Models matrices of all instances
+ */
+void InstancedRenderer::set_transform(const Transformation& t, const std::vector<glm::mat4>& models, const std::vector<unsigned int>& indices) {
+  m_buffers.upload("models", models, indices);
+  StorageRenderer::set_transform(t.view, t.projection, indices.size());
+}
+
+GLuint InstancedRenderer::get_program() const {
+  return m_id_program;
+}
+
+/* Free instances buffers & vao/vbo */
+void InstancedRenderer::free() {
+  m_buffers.free();
+  StorageRenderer::free();
+}
@@ -0,0 +1,119 @@
+#include <array>
+
+#include "render/lod_renderer.hpp"
+#include "math/bounding_box.hpp"
+#include "profiling/profiler.hpp"
+
+// fraction of triangles kept in each LOD & min. size on screen to use it (bounding sphere's diameter over screen height)
+const std::array<float, 4> LODS_RATIOS = { 1.0f, 0.5f, 0.25f, 0.1f };
+const std::array<float, 4> LODS_SIZES = { 0.3f, 0.15f, 0.06f, 0.0f };
+
+// relative margin around sizes thresholds (instance keeps its LOD until size is clearly past threshold)
+const float HYSTERESIS = 0.15f;
+
+/**
+ * LODs simplified on workers of `assets_loader` (queued now if `load()` wasn't called before) & registered there,
+ * so renderers of the same model share its LODs (textures uploaded once & shared by all LODs)
+ */
+LodRenderer::LodRenderer(const Program& program, AssetsLoader& assets_loader, const std::string& path, const std::vector<Attribute>& attributes):
+  m_indices_lods(LODS_RATIOS.size())
+{
+  load(assets_loader, path);
+  for (size_t lod = 0; lod < LODS_RATIOS.size(); ++lod)
+    m_renderers.push_back(ModelRenderer(program, assets_loader, AssetsLoader::get_key_lod(path, lod), attributes));
+
+  BoundingBox bounding_box(get_positions());
+  m_center = bounding_box.center;
+  m_radius = glm::length(bounding_box.half_diagonal);
+}
+
+/* Queue import of model & simplification of its LODs (in parallel with other assets queued before renderers are constructed) */
+void LodRenderer::load(AssetsLoader& assets_loader, const std::string& path) {
+  assets_loader.load_lods(path, std::vector<float>(LODS_RATIOS.begin() + 1, LODS_RATIOS.end()));
+}
+
+/* Bbox corners of full model (same for all LODs) */
+std::vector<glm::vec3> LodRenderer::get_positions() {
+  return m_renderers[0].get_positions();
+}
+
+/**
+ * Finest LOD whose size threshold is reached, with thresholds moved away from previous LOD
+ * @param size Bounding sphere's diameter over screen height
+ */
+unsigned int LodRenderer::select_lod(unsigned int lod_previous, float size) const {
+  for (unsigned int lod = 0; lod + 1 < LODS_SIZES.size(); ++lod) {
+    float threshold = LODS_SIZES[lod] * ((lod < lod_previous) ? 1.0f + HYSTERESIS : 1.0f - HYSTERESIS);
+    if (size >= threshold)
+      return lod;
+  }
+
+  return LODS_SIZES.size() - 1;
+}
+
+/**
+ * Select LOD of visible instances from their projected size & bucket them by LOD (no gl calls, so it can run in a culling job)
+ * @param transformation View & projection matrices
+ * @param models Models matrices of all instances (visible or not)
+ * @param indices Visible instances (e.g. after frustum culling)
+ */
+void LodRenderer::select_lods(const Transformation& transformation, const std::vector<glm::mat4>& models, const std::vector<unsigned int>& indices) {
+  PROFILE_ZONE("LodRenderer::select_lods");
+  if (m_lods.size() != models.size())
+    m_lods.assign(models.size(), 0);
+
+  // camera position in world space & projection's scale along y-axis (i.e. 1 / tan(fovy / 2))
+  glm::vec3 position_camera = glm::inverse(transformation.view)[3];
+  float scale_projection = transformation.projection[1][1];
+
+  for (std::vector<unsigned int>& indices_lod : m_indices_lods)
+    indices_lod.clear();
+
+  for (unsigned int index : indices) {
+    const glm::mat4& model = models[index];
+    float scale = glm::max(glm::length(glm::vec3(model[0])), glm::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+    float radius = scale * m_radius;
+    float distance = glm::max(glm::length(glm::vec3(model * glm::vec4(m_center, 1.0f)) - position_camera), radius);
+
+    unsigned int lod = select_lod(m_lods[index], radius * scale_projection / distance);
+    m_lods[index] = lod;
+    m_indices_lods[lod].push_back(index);
+  }
+}
+
+/**
+ * Gather matrices of instances of each LOD selected above into instances buffers of this LOD's renderer (on gl thread)
+ * @param models Models matrices of all instances (visible or not)
+ * @param normals_mats Normal matrices of all instances
+ */
+void LodRenderer::set_transform(const Transformation& transformation, const std::vector<glm::mat4>& models, const std::vector<glm::mat4>& normals_mats) {
+  for (size_t lod = 0; lod < m_renderers.size(); ++lod) {
+    if (m_indices_lods[lod].empty())
+      continue;
+
+    m_renderers[lod].set_transform(transformation, models, m_indices_lods[lod]);
+    m_renderers[lod].set_instance_arr("normals_mats", normals_mats, m_indices_lods[lod]);
+  }
+}
+
+/* One instanced draw per mesh for each LOD used by at least one instance */
+void LodRenderer::draw(const Uniforms& u) {
+  for (size_t lod = 0; lod < m_renderers.size(); ++lod) {
+    if (!m_indices_lods[lod].empty())
+      m_renderers[lod].draw(u);
+  }
+}
+
+/* Same as `draw()` with packets of each LOD's meshes submitted to render queue */
+void LodRenderer::submit(RenderQueue& queue, const DrawState& state, const Uniforms& u) {
+  for (size_t lod = 0; lod < m_renderers.size(); ++lod) {
+    if (!m_indices_lods[lod].empty())
+      m_renderers[lod].submit(queue, state, u);
+  }
+}
+
+/* Free instances buffers of each LOD, their vbo/vao freed by registry & shared textures only with LOD 0 */
+void LodRenderer::free() {
+  for (ModelRenderer& renderer : m_renderers)
+    renderer.free();
+}
@@ -1,19 +1,63 @@
+#include <cstddef>
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "render/model_renderer.hpp"
+#include "models/vertex_quantized.hpp"
+#include "globals/draw_stats.hpp"
 
 // not declared as private members as constants cause class's implicit copy-constructor to be deleted (prevents re-assignment)
 // movement constants
 const float SPEED = 0.1f;
 
-ModelRenderer::ModelRenderer(const Program& program, const assimp_utils::Model& model, const std::vector<Attribute>& attributes):
-  m_model(model)
+/**
+ * Meshes uploaded once per model by the registry & shared with other renderers of same model (not copied on gpu)
+ * @param path Path to model, or key of model registered in `assets_loader` (e.g. LOD)
+ */
+ModelRenderer::ModelRenderer(const Program& program, AssetsLoader& assets_loader, const std::string& path, const std::vector<Attribute>& attributes):
+  m_assets_loader(&assets_loader),
+  m_path(path),
+  m_n_instances(0),
+  m_id_program(program.id)
 {
-  // one renderer by mesh (to avoid mixing up meshes indices)
-  for (const assimp_utils::Mesh& mesh : m_model.meshes) {
-    Renderer renderer(program, Geometry(mesh.vertexes, mesh.indices, mesh.positions), attributes);
+  auto upload_meshes = [&program, &attributes](const assimp_utils::Model& model) { return upload(program, model, attributes); };
+  const AssetsLoader::ModelMeshes& meshes = assets_loader.acquire_meshes(path, upload_meshes);
+  m_model = meshes.model;
+
+  for (const StorageRenderer& renderer : meshes.renderers)
+    renderers.push_back(StorageRenderer(renderer, program));
+}
+
+/* One renderer by mesh (to avoid mixing up meshes indices) */
+std::vector<StorageRenderer> ModelRenderer::upload(const Program& program, const assimp_utils::Model& model, const std::vector<Attribute>& attributes) {
+  std::vector<StorageRenderer> renderers;
+
+  for (const assimp_utils::Mesh& mesh : model.meshes) {
+    StorageRenderer renderer(program, Geometry(mesh.vertexes, mesh.indices, mesh.positions), attributes);
+    if (mesh.is_quantized)
+      set_attributes_quantized(renderer);
+
     renderers.push_back(renderer);
   }
+
+  return renderers;
+}
+
+/**
+ * Replace float attributes set by `Renderer` with formats of packed vertexes (see `VertexQuantized`)
+ * Normalized integers & half floats converted to floats by gpu before reaching vertex shader
+ * Locations same as in `texture_mesh.vert`
+ */
+void ModelRenderer::set_attributes_quantized(Renderer& renderer) {
+  const GLsizei stride = sizeof(assimp_utils::VertexQuantized);
+  renderer.vao.bind();
+  renderer.vbo.bind();
+
+  glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, stride, (GLvoid*) offsetof(assimp_utils::VertexQuantized, position));
+  glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, stride, (GLvoid*) offsetof(assimp_utils::VertexQuantized, normal));
+  glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (GLvoid*) offsetof(assimp_utils::VertexQuantized, texture_coord));
+  glVertexAttribPointer(3, 2, GL_SHORT, GL_TRUE, stride, (GLvoid*) offsetof(assimp_utils::VertexQuantized, tangent));
+
+  renderer.vao.unbind();
 }
 
 /**
@@ -35,42 +79,93 @@ std::vector<glm::vec3> ModelRenderer::get_positions() {
 /**
  * Initial transformation (position) of 3D Object accord. to model matrix
  * as well view & projection matrixes
+ * Models matrices uploaded once to instances buffer shared by meshes
  */
 void ModelRenderer::set_transform(const Transformation& transformation) {
-  for (Renderer& renderer : renderers) {
-    renderer.set_transform(transformation);
+  m_buffers.upload("models", transformation.models);
+  m_n_instances = transformation.models.size();
+
+  for (StorageRenderer& renderer : renderers) {
+    renderer.set_transform(transformation.view, transformation.projection, m_n_instances);
+  }
+}
+
+/**
+ * Same as above with models of instances at `indices` gathered straight into instances buffer
+ * (same as `InstancedRenderer::set_transform()`, meshes renderers only get view/projection & # of instances)
+ * @param models Models matrices of all instances
+ */
+void ModelRenderer::set_transform(const Transformation& transformation, const std::vector<glm::mat4>& models, const std::vector<unsigned int>& indices) {
+  m_buffers.upload("models", models, indices);
+  m_n_instances = indices.size();
+
+  for (StorageRenderer& renderer : renderers) {
+    renderer.set_transform(transformation.view, transformation.projection, m_n_instances);
   }
 }
 
 /* Needed to pass normal_mat to tree's shaders in LevelRenderer */
-void ModelRenderer::set_uniform_arr(const std::string& name, const std::vector<glm::mat4>& u) {
-  for (Renderer& renderer : renderers)
-    renderer.set_uniform_arr(name, u);
+void ModelRenderer::set_instance_arr(const std::string& name, const std::vector<glm::mat4>& u) {
+  m_buffers.upload(name, u);
+}
+
+/* Same as above with only elements at `indices` uploaded */
+void ModelRenderer::set_instance_arr(const std::string& name, const std::vector<glm::mat4>& u, const std::vector<unsigned int>& indices) {
+  m_buffers.upload(name, u, indices);
 }
 
 /* Rendering of model relies on `Renderer::draw() applied to each mesh */
 void ModelRenderer::draw(const Uniforms& u, bool with_outlines) {
   Uniforms uniforms = u;
+  m_buffers.bind();
 
   for (size_t i_renderer = 0; i_renderer < renderers.size(); ++i_renderer) {
     // retrieve materials/textures from mesh (get a ref. to avoid copying vec. members)
-    assimp_utils::Mesh& mesh = m_model.meshes[i_renderer];
+    const assimp_utils::Mesh& mesh = m_model->meshes[i_renderer];
     mesh.set_uniforms(uniforms);
-    Renderer renderer = renderers[i_renderer];
+    Renderer& renderer = renderers[i_renderer];
 
     if (with_outlines) {
       renderer.draw_with_outlines(uniforms);
+      draw_stats.add(m_n_instances);
     } else {
       renderer.draw(uniforms);
     }
+
+    draw_stats.add(m_n_instances);
   }
 }
 
-/* Free loaded textures & vbo/vao buffers */
-void ModelRenderer::free() {
-  m_model.free();
+/**
+ * One packet per mesh (meshes have their own vao & textures), drawn after sorting by render queue
+ * @param state Pass, translucency & depth of model's instances (program, texture & vao set here)
+ * @param u Uniforms referenced until queue is flushed
+ */
+void ModelRenderer::submit(RenderQueue& queue, DrawState state, const Uniforms& u) {
+  state.program = m_id_program;
+  auto draw = [](void* context, const void* data, size_t i_mesh) {
+    static_cast<ModelRenderer*>(context)->draw_mesh(i_mesh, *static_cast<const Uniforms*>(data));
+  };
 
-  for (Renderer& renderer : renderers) {
-    renderer.free();
+  for (size_t i_mesh = 0; i_mesh < renderers.size(); ++i_mesh) {
+    const assimp_utils::Mesh& mesh = m_model->meshes[i_mesh];
+    state.texture = mesh.has_texture_diffuse ? mesh.texture_diffuse.id : 0;
+    state.vao = queue.get_vao(&renderers[i_mesh]);
+    queue.submit(state, { draw, this, &u, i_mesh });
   }
 }
+
+/* Same as `draw()` for a single mesh (instances buffer bound again as packets of other renderers may be drawn in between) */
+void ModelRenderer::draw_mesh(size_t i_mesh, const Uniforms& u) {
+  Uniforms uniforms = u;
+  m_buffers.bind();
+  m_model->meshes[i_mesh].set_uniforms(uniforms);
+  renderers[i_mesh].draw(uniforms);
+  draw_stats.add(m_n_instances);
+}
+
+/* Free instances buffers, textures & vbo/vao buffers freed by registry with last renderer of model */
+void ModelRenderer::free() {
+  m_buffers.free();
+  m_assets_loader->release_meshes(m_path);
+}
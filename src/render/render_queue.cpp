@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+
+#include "render/render_queue.hpp"
+#include "globals/draw_stats.hpp"
+#include "profiling/profiler.hpp"
+
+namespace {
+  /* bits of each field in keys (from most significant), depth moved after translucency for back-to-front order */
+  const unsigned int BITS_PASS = 2, BITS_PROGRAM = 13, BITS_TEXTURE = 16, BITS_VAO = 16, BITS_DEPTH = 16;
+
+  /* keys sorted by 8 bits digits */
+  const unsigned int BITS_DIGIT = 8, N_BUCKETS = 1 << BITS_DIGIT;
+
+  uint64_t get_bits(uint64_t value, unsigned int n_bits) {
+    return value & ((uint64_t(1) << n_bits) - 1);
+  }
+
+  /* Upper bits of positive float (same order as floats, whatever their range) */
+  uint64_t quantize(float depth) {
+    uint32_t bits;
+    depth = std::max(depth, 0.0f);
+    std::memcpy(&bits, &depth, sizeof(bits));
+    return bits >> (32 - BITS_DEPTH);
+  }
+}
+
+/**
+ * Key built from packet's state (see `get_key()`)
+ * @param callback Called back by `flush()` (its context & data must outlive it)
+ */
+void RenderQueue::submit(const DrawState& state, const DrawCallback& callback) {
+  m_packets.push_back({ get_key(state), state, callback });
+}
+
+/**
+ * Opaque: pass | 0 | program | texture | vao | depth (front to back inside a state)
+ * Translucent: pass | 1 | depth (back to front) | program | texture | vao
+ */
+uint64_t RenderQueue::get_key(const DrawState& state) {
+  uint64_t key = get_bits(state.pass, BITS_PASS);
+  key = (key << 1) | state.is_translucent;
+
+  uint64_t depth = quantize(state.depth);
+  if (state.is_translucent)
+    key = (key << BITS_DEPTH) | get_bits(~depth, BITS_DEPTH);
+
+  key = (key << BITS_PROGRAM) | get_bits(state.program, BITS_PROGRAM);
+  key = (key << BITS_TEXTURE) | get_bits(state.texture, BITS_TEXTURE);
+  key = (key << BITS_VAO) | get_bits(state.vao, BITS_VAO);
+
+  if (!state.is_translucent)
+    key = (key << BITS_DEPTH) | depth;
+
+  return key;
+}
+
+/* Index of vao drawn by given renderer (assigned on first call, renderers live as long as the queue) */
+unsigned int RenderQueue::get_vao(const void* owner) {
+  return m_vaos.emplace(owner, m_vaos.size()).first->second;
+}
+
+/**
+ * Distance to camera of nearest instance drawn (packet's depth)
+ * @param indices Instances drawn (e.g. visible ones after culling)
+ */
+float RenderQueue::get_depth(const glm::vec3& position_camera, const std::vector<BoundingBox>& bboxes, const std::vector<unsigned int>& indices) {
+  float depth = std::numeric_limits<float>::max();
+  for (unsigned int index : indices)
+    depth = std::min(depth, glm::length(bboxes[index].center - position_camera));
+
+  return depth;
+}
+
+/**
+ * LSD radix sort of keys by 8-bit digits (stable), digits shared by all keys skipped (e.g. pass)
+ * Only keys & indices are moved, packets (& their callbacks) stay in submission order
+ */
+void RenderQueue::sort() {
+  PROFILE_ZONE("RenderQueue::sort");
+  const size_t N_PACKETS = m_packets.size();
+  m_order.resize(N_PACKETS);
+  m_order_sorted.resize(N_PACKETS);
+
+  for (size_t i_packet = 0; i_packet < N_PACKETS; ++i_packet)
+    m_order[i_packet] = { m_packets[i_packet].key, i_packet };
+
+  for (unsigned int shift = 0; shift < 64; shift += BITS_DIGIT) {
+    std::array<size_t, N_BUCKETS> counts = {};
+    for (const auto& pair : m_order)
+      counts[(pair.first >> shift) & (N_BUCKETS - 1)]++;
+
+    if (N_PACKETS == 0 || counts[(m_order[0].first >> shift) & (N_BUCKETS - 1)] == N_PACKETS)
+      continue;
+
+    // offset of each bucket in sorted array
+    size_t offset = 0;
+    for (size_t& count : counts) {
+      size_t count_bucket = count;
+      count = offset;
+      offset += count_bucket;
+    }
+
+    for (const auto& pair : m_order)
+      m_order_sorted[counts[(pair.first >> shift) & (N_BUCKETS - 1)]++] = pair;
+
+    std::swap(m_order, m_order_sorted);
+  }
+}
+
+/* Program, texture & vao changes between consecutive packets (in sorted order if `sort()` was called, submission order otherwise) */
+RenderQueue::StateChanges RenderQueue::get_state_changes() const {
+  StateChanges changes;
+  const DrawState* state_previous = nullptr;
+
+  for (size_t i_packet = 0; i_packet < m_packets.size(); ++i_packet) {
+    unsigned int index = (m_order.size() == m_packets.size()) ? m_order[i_packet].second : i_packet;
+    const DrawState& state = m_packets[index].state;
+    changes.n_programs += !state_previous || state.program != state_previous->program;
+    changes.n_textures += !state_previous || state.texture != state_previous->texture;
+    changes.n_vaos += !state_previous || state.vao != state_previous->vao;
+    state_previous = &state;
+  }
+
+  return changes;
+}
+
+size_t RenderQueue::size() const {
+  return m_packets.size();
+}
+
+/**
+ * Sort packets then draw them, face culling only toggled between one-sided & two-sided packets
+ * Face culling expected to be enabled before (& restored after), queue emptied for next frame
+ */
+void RenderQueue::flush() {
+  PROFILE_ZONE("RenderQueue::flush");
+  sort();
+
+  bool is_two_sided = false;
+  for (const auto& pair : m_order) {
+    const DrawPacket& packet = m_packets[pair.second];
+    if (packet.state.is_two_sided != is_two_sided) {
+      is_two_sided = packet.state.is_two_sided;
+      if (is_two_sided)
+        glDisable(GL_CULL_FACE);
+      else
+        glEnable(GL_CULL_FACE);
+    }
+
+    packet.callback.draw(packet.callback.context, packet.callback.data, packet.callback.index);
+  }
+
+  if (is_two_sided)
+    glEnable(GL_CULL_FACE);
+
+  StateChanges changes = get_state_changes();
+  draw_stats.add_state_changes(changes.n_programs, changes.n_textures, changes.n_vaos);
+
+  m_packets.clear();
+  m_order.clear();
+}
@@ -0,0 +1,33 @@
+#include "render/storage_renderer.hpp"
+
+StorageRenderer::StorageRenderer(const Program& program, const Geometry& geometry, const std::vector<Attribute>& attributes, bool is_text):
+  Renderer(program, geometry, attributes, is_text)
+{
+}
+
+/**
+ * Draws vbo & vao of given renderer (not copied on gpu) with another program
+ * Used to share meshes uploaded once between renderers of a model (see `AssetsLoader::acquire_meshes()`)
+ */
+StorageRenderer::StorageRenderer(const StorageRenderer& renderer, const Program& program):
+  StorageRenderer(renderer)
+{
+  m_program = program;
+}
+
+/**
+ * Same uniforms as `Renderer::set_transform()` without models (one loop iteration & uniform lookup less per instance)
+ * @param n_instances # of instances drawn by next draw call (i.e. elements in instances buffers)
+ */
+void StorageRenderer::set_transform(const glm::mat4& view, const glm::mat4& projection, unsigned int n_instances) {
+  m_n_instances = n_instances;
+
+  m_program.use();
+  m_program.set_mat4("view", view);
+  m_program.set_mat4("projection", projection);
+  m_program.unuse();
+}
+
+unsigned int StorageRenderer::get_n_instances() const {
+  return m_n_instances;
+}
@@ -6,7 +6,7 @@
 using namespace geometry;
 
 TextRenderer::TextRenderer(const Program& program, const std::vector<Attribute>& attributes, const Font& font):
-  Renderer(program, Surface(), attributes, true),
+  InstancedRenderer(program, Surface(), attributes, true),
   m_glyphs(font.extract_glyphs())
 {
 }
@@ -53,7 +53,7 @@ void TextRenderer::draw_text(const std::string& text, const Uniforms& u) {
     vbo.update(Surface(vertexes));
 
     // render character & advance to following one
-    Renderer::draw(uniforms);
+    InstancedRenderer::draw(uniforms);
     x += glyph.advance;
   }
 }
@@ -0,0 +1,18 @@
+#include "shaders/program_binary.hpp"
+
+/* Program created & linked from binary straight away (no shader to compile or to delete later) */
+ProgramBinary::ProgramBinary(const ProgramCache::Binary& binary):
+  Program()
+{
+  id = glCreateProgram();
+  m_is_linked = ProgramCache::upload(id, binary);
+
+  if (!m_is_linked) {
+    glDeleteProgram(id);
+    id = 0;
+  }
+}
+
+bool ProgramBinary::is_linked() const {
+  return m_is_linked;
+}
@@ -0,0 +1,127 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include "shaders/program_cache.hpp"
+
+namespace {
+  const std::string DIRECTORY_CACHE = "assets/shaders/cache";
+
+  /* Shaders sources & driver the binary was linked with (cache is stale once they differ) */
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t hash;
+    uint32_t format;
+    uint32_t size;
+  };
+
+  /* FNV-1a (stable across runs & platforms unlike `std::hash`) */
+  uint64_t hash_bytes(const std::string& bytes, uint64_t hash = 0xcbf29ce484222325) {
+    for (unsigned char byte : bytes) {
+      hash ^= byte;
+      hash *= 0x100000001b3;
+    }
+
+    return hash;
+  }
+
+  std::string read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+
+  /* Empty string if queried before gl context is made current */
+  std::string get_string(GLenum name) {
+    const GLubyte* string = glGetString(name);
+    return (string != NULL) ? reinterpret_cast<const char*>(string) : "";
+  }
+}
+
+std::string ProgramCache::get_path(const std::string& name) {
+  return DIRECTORY_CACHE + "/" + name + ".program";
+}
+
+/**
+ * Hash of shaders sources & driver's strings (binaries aren't portable between drivers or their versions)
+ * Must be called with gl context current
+ */
+uint64_t ProgramCache::get_hash(const std::string& path_vertex, const std::string& path_fragment) {
+  uint64_t hash = hash_bytes(read_file(path_vertex));
+  hash = hash_bytes(read_file(path_fragment), hash);
+
+  for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+    hash = hash_bytes(get_string(name), hash);
+
+  return hash;
+}
+
+/**
+ * Read binary saved for given program
+ * @param hash From `get_hash()`, compared with the one it was saved with
+ * @return false if cache is missing or stale
+ */
+bool ProgramCache::load(const std::string& name, uint64_t hash, Binary& binary) {
+  std::ifstream file(get_path(name), std::ios::binary);
+  Header header = {};
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(Header)))
+    return false;
+
+  if (header.magic != MAGIC || header.version != VERSION || header.hash != hash || header.size == 0)
+    return false;
+
+  binary.format = header.format;
+  binary.data.resize(header.size);
+  return static_cast<bool>(file.read(binary.data.data(), header.size));
+}
+
+/**
+ * Save linked program's binary (written to temporary file then renamed, so a crash never leaves a truncated cache)
+ * @return false if driver doesn't support any binary format or file couldn't be written
+ */
+bool ProgramCache::save(const std::string& name, uint64_t hash, GLuint program) {
+  GLint n_formats = 0, size = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &n_formats);
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size);
+  if (n_formats == 0 || size <= 0)
+    return false;
+
+  Header header = { MAGIC, VERSION, hash, 0, 0 };
+  std::vector<char> data(size);
+  GLsizei length = 0;
+  GLenum format = 0;
+  glGetProgramBinary(program, size, &length, &format, data.data());
+  header.format = format;
+  header.size = length;
+  if (length <= 0)
+    return false;
+
+  std::error_code error;
+  std::filesystem::create_directories(DIRECTORY_CACHE, error);
+  std::string path_cache = get_path(name);
+  std::string path_tmp = path_cache + ".tmp";
+  std::ofstream file(path_tmp, std::ios::binary);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+  file.write(data.data(), length);
+  file.close();
+
+  if (!file) {
+    std::remove(path_tmp.c_str());
+    return false;
+  }
+
+  return std::rename(path_tmp.c_str(), path_cache.c_str()) == 0;
+}
+
+/**
+ * Link program from binary instead of compiling its shaders
+ * @return false if binary is rejected by driver (e.g. updated without changing its version string)
+ */
+bool ProgramCache::upload(GLuint program, const Binary& binary) {
+  glProgramBinary(program, binary.format, binary.data.data(), binary.data.size());
+
+  GLint status = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &status);
+  return status == GL_TRUE;
+}
@@ -0,0 +1,138 @@
+#include "utils/job_system.hpp"
+#include "profiling/profiler.hpp"
+
+namespace {
+  /* pool the current thread works for & index of its queue in it (threads outside any pool use queue 0 of every pool) */
+  thread_local const JobSystem* system_thread = nullptr;
+  thread_local unsigned int i_queue_thread = 0;
+}
+
+/**
+ * @param n_threads # of worker threads (by default, one per core besides the main thread which also runs jobs while waiting)
+ */
+JobSystem::JobSystem(unsigned int n_threads):
+  m_n_jobs(0),
+  m_is_stopped(false)
+{
+  for (unsigned int i_queue = 0; i_queue <= n_threads; ++i_queue)
+    m_queues.push_back(std::make_unique<Queue>());
+
+  for (unsigned int i_thread = 0; i_thread < n_threads; ++i_thread)
+    m_threads.push_back(std::thread(&JobSystem::run_worker, this, i_thread + 1));
+}
+
+/* Jobs still queued are dropped (callers wait on their jobs before) */
+JobSystem::~JobSystem() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_is_stopped = true;
+  }
+
+  m_condition.notify_all();
+  for (std::thread& thread : m_threads)
+    thread.join();
+}
+
+unsigned int JobSystem::get_n_threads() const {
+  return m_threads.size();
+}
+
+/* Queue of current thread in this pool (shared queue for workers of another pool, e.g. jobs pushed across pools) */
+unsigned int JobSystem::get_queue_thread() const {
+  return (system_thread == this) ? i_queue_thread : 0;
+}
+
+/* Push job at the back of current thread's queue & wake up a sleeping worker to steal it */
+void JobSystem::push(const Job& job) {
+  Queue& queue = *m_queues[get_queue_thread()];
+  bool is_full;
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    is_full = queue.size == SIZE_QUEUE;
+    if (!is_full) {
+      queue.jobs[(queue.front + queue.size) % SIZE_QUEUE] = job;
+      queue.size++;
+      m_n_jobs++;
+    }
+  }
+
+  // queue full: run job right away
+  if (is_full) {
+    execute(job);
+    return;
+  }
+
+  // workers check # of jobs with mutex locked before sleeping (so notification can't be missed)
+  { std::lock_guard<std::mutex> lock(m_mutex); }
+  m_condition.notify_one();
+}
+
+/* Last job pushed by current thread (most likely to have its data in cache) */
+bool JobSystem::pop(Job& job) {
+  Queue& queue = *m_queues[get_queue_thread()];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.size == 0)
+    return false;
+
+  queue.size--;
+  job = queue.jobs[(queue.front + queue.size) % SIZE_QUEUE];
+  m_n_jobs--;
+  return true;
+}
+
+/* Oldest job in other threads queues (usually the largest one left, e.g. first chunks of a `parallel_for()`) */
+bool JobSystem::steal(Job& job) {
+  unsigned int i_queue_current = get_queue_thread();
+  for (size_t i_offset = 1; i_offset < m_queues.size(); ++i_offset) {
+    Queue& queue = *m_queues[(i_queue_current + i_offset) % m_queues.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.size == 0)
+      continue;
+
+    job = queue.jobs[queue.front];
+    queue.front = (queue.front + 1) % SIZE_QUEUE;
+    queue.size--;
+    m_n_jobs--;
+    return true;
+  }
+
+  return false;
+}
+
+/* Counter decremented after job's writes (seen by thread waiting on it) */
+void JobSystem::execute(const Job& job) {
+  job.execute(job.function, job.first, job.last);
+  job.counter->fetch_sub(1, std::memory_order_release);
+}
+
+/* Run jobs (own ones first, then stolen) until all those counted by `counter` are done */
+void JobSystem::wait(Counter& counter) {
+  PROFILE_ZONE("JobSystem::wait");
+
+  while (counter.load(std::memory_order_acquire) > 0) {
+    Job job;
+    if (pop(job) || steal(job))
+      execute(job);
+    else
+      std::this_thread::yield();
+  }
+}
+
+/* Worker loop: run jobs while there are some in any queue, sleep otherwise */
+void JobSystem::run_worker(unsigned int i_queue) {
+  system_thread = this;
+  i_queue_thread = i_queue;
+
+  while (true) {
+    Job job;
+    if (pop(job) || steal(job)) {
+      execute(job);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this]() { return m_is_stopped || m_n_jobs > 0; });
+    if (m_is_stopped)
+      return;
+  }
+}
@@ -0,0 +1,30 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils/mapped_file.hpp"
+
+/* `data` left null if file is missing or empty */
+MappedFile::MappedFile(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1)
+    return;
+
+  struct stat status;
+  if (fstat(fd, &status) == 0 && status.st_size > 0) {
+    void* address = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address != MAP_FAILED) {
+      data = static_cast<const char*>(address);
+      size = status.st_size;
+    }
+  }
+
+  // mapping stays valid after closing file descriptor
+  close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data != nullptr)
+    munmap(const_cast<char*>(data), size);
+}